@@ -9,6 +9,10 @@
 #include <rbase/inc/platform.h>
 #include <rbase/inc/stringfn.h>
 #include <rbase/inc/libhandler.h>
+#include <rbase/inc/spinlock.h>
+#include <rbase/inc/tls.h>
+#include <rbase/inc/virtualmem.h>
+#include <atomic>
 
 namespace rtm {
 
@@ -35,6 +39,9 @@ namespace rtm {
 	/// Fast dynamic stack allocator, the idea is to keep allocated items in
 	/// continuous memory blocks for better cache performance. Items can only
 	/// be allocated, not freed.
+	/// When constructed with a maximum number of items, address space for all
+	/// of them is reserved up front and chunks are committed on demand, items
+	/// are then found at a fixed base plus offset.
 	//--------------------------------------------------------------------------
 	template <typename T, int CHUNK_ITEMS = 1 << 16>
 	class ChunkAllocator
@@ -54,21 +61,52 @@ namespace rtm {
 		};
 
 		Chunk**		m_chunks;
+		Chunk*		m_base;			// start of reserved range, null when chunks are on heap
 		uint32_t	m_numItems;
 		uint32_t	m_numChunks;
 		uint32_t	m_maxChunks;
+		bool		m_hugePages;
 
 	public:
 		inline ChunkAllocator()
 			: m_chunks(nullptr)
+			, m_base(nullptr)
 			, m_numItems(0)
 			, m_numChunks(0)
 			, m_maxChunks(0)
+			, m_hugePages(false)
 		{
 			static_assert((CHUNK_ITEMS & CHUNK_MASK) == 0);
 			reset(true); // create initial chunk array and add 1 chunk
 		}
 
+		/// Reserves address space for a maximum number of items, falls back to
+		/// heap chunks if virtual memory is not available.
+		///
+		/// @param[in] _maxItems   : Maximum number of items
+		/// @param[in] _hugePages  : If true, asks the system to back items with huge pages
+		inline ChunkAllocator(uint32_t _maxItems, bool _hugePages = false)
+			: m_chunks(nullptr)
+			, m_base(nullptr)
+			, m_numItems(0)
+			, m_numChunks(0)
+			, m_maxChunks(0)
+			, m_hugePages(_hugePages)
+		{
+			static_assert((CHUNK_ITEMS & CHUNK_MASK) == 0);
+			RTM_ASSERT(_maxItems > 0, "Invalid maximum number of items!");
+
+			const uint32_t maxChunks = uint32_t((uint64_t(_maxItems) + CHUNK_MASK) >> CHUNK_SHIFT);
+			m_base = (Chunk*)virtualMemReserve(size_t(maxChunks) * sizeof(Chunk));
+			if (m_base)
+			{
+				m_maxChunks = maxChunks;
+				if (m_hugePages)
+					virtualMemAdviseHugePages(m_base, reservedSize());
+			}
+			reset(true);
+		}
+
 		ChunkAllocator(const ChunkAllocator&) = delete;
 		ChunkAllocator& operator=(const ChunkAllocator&) = delete;
 
@@ -91,6 +129,7 @@ namespace rtm {
 		inline uint32_t allocHandle()
 		{
 			const uint32_t handle = m_numItems++;
+			RTM_ASSERT(!m_base || ((handle >> CHUNK_SHIFT) < m_maxChunks), "Allocator is full!");
 			while ((handle >> CHUNK_SHIFT) >= m_numChunks)
 			{
 				addNewChunk();
@@ -131,6 +170,12 @@ namespace rtm {
 		/// @param[in] _allocOneChunk  : If true, allocates one initial chunk after reset
 		inline void reset(bool _allocOneChunk = true)
 		{
+			if (m_base)
+			{
+				resetVirtual(_allocOneChunk);
+				return;
+			}
+
 			const uint32_t numChunks = m_numChunks;
 			if (m_chunks)
 			{
@@ -171,12 +216,59 @@ namespace rtm {
 		{
 			uint32_t chunkIdx = _index >> CHUNK_SHIFT;
 			uint32_t  itemIdx = _index  & CHUNK_MASK;
+			if (m_base)
+				return &m_base[chunkIdx].m_data[itemIdx];
 			return &m_chunks[chunkIdx]->m_data[itemIdx];
 		}
 
 	private:
+		inline size_t reservedSize() const
+		{
+			return size_t(m_maxChunks) * sizeof(Chunk);
+		}
+
+		inline void resetVirtual(bool _allocOneChunk)
+		{
+			for (uint32_t i=0; i<m_numChunks; ++i)
+			{
+				m_base[i].~Chunk();
+			}
+
+			m_numItems	= 0;
+			m_numChunks	= 0;
+
+			if (_allocOneChunk)
+			{
+				// keep the first chunk committed, it is constructed again right away
+				if (m_maxChunks > 1)
+				{
+					virtualMemDecommit(&m_base[1], reservedSize() - sizeof(Chunk));
+					if (m_hugePages)
+						virtualMemAdviseHugePages(m_base, reservedSize());
+				}
+				addNewChunk();
+			}
+			else
+			{
+				virtualMemRelease(m_base, reservedSize());
+				m_base		= nullptr;
+				m_maxChunks	= 0;
+			}
+		}
+
 		inline void addNewChunk()
 		{
+			if (m_base)
+			{
+				Chunk* chunk = &m_base[m_numChunks];
+				const bool committed = virtualMemCommit(chunk, sizeof(Chunk));
+				RTM_ASSERT(committed, "Failed to commit memory!");
+				RTM_UNUSED(committed);
+				new (chunk, rtmAllocTag::Tag) Chunk();
+				++m_numChunks;
+				return;
+			}
+
 			Chunk* newChunk = rtm_new<Chunk>();
 			if (m_numChunks == m_maxChunks) // check if chunk array is full
 			{
@@ -191,8 +283,296 @@ namespace rtm {
 		}
 	};
 
+	//--------------------------------------------------------------------------
+	/// Thread safe variant of ChunkAllocator that can also free handles.
+	/// Threads claim handles in batches with a single atomic add and chunks are
+	/// published into a fixed size chunk table with a CAS, so allocation never
+	/// takes a lock. Freed handles go to a per thread magazine, full magazines
+	/// are exchanged with other threads through a shared depot.
+	//--------------------------------------------------------------------------
+	template <typename T, int CHUNK_ITEMS = 1 << 16>
+	class ChunkAllocatorConcurrent
+	{
+	private:
+		struct RTM_ALIGN(16) Chunk
+		{
+			T	m_data[CHUNK_ITEMS];
+		};
+
+		enum
+		{
+			CHUNK_SHIFT			= chunkCTZ(CHUNK_ITEMS),
+			CHUNK_MASK			= CHUNK_ITEMS - 1,
+			CLAIM_BATCH			= 64,	// handles claimed from shared counter at once
+			MAGAZINE_SIZE		= 64	// freed handles cached per thread
+		};
+
+		struct Magazine
+		{
+			Magazine*	m_next;
+			uint32_t	m_count;
+			uint32_t	m_handles[MAGAZINE_SIZE];
+		};
+
+		struct ThreadCache
+		{
+			ChunkAllocatorConcurrent*	m_owner;
+			ThreadCache*				m_next;
+			Magazine*					m_magazine;
+			uint32_t					m_claimNext;
+			uint32_t					m_claimEnd;
+		};
+
+		std::atomic<Chunk*>*		m_chunks;
+		uint32_t					m_maxChunks;
+		uint32_t					m_tlsIndex;
+		std::atomic<uint32_t>		m_numItems;
+		std::atomic<uint32_t>		m_numChunks;
+		std::atomic<ThreadCache*>	m_threadCaches;
+		SpinLock					m_depotLock;
+		Magazine*					m_fullMagazines;
+		Magazine*					m_emptyMagazines;
+
+	public:
+		/// @param[in] _maxItems  : Maximum number of items, determines chunk table size
+		inline ChunkAllocatorConcurrent(uint32_t _maxItems = 1 << 24)
+			: m_numItems(0)
+			, m_numChunks(0)
+			, m_threadCaches(0)
+			, m_fullMagazines(0)
+			, m_emptyMagazines(0)
+		{
+			static_assert((CHUNK_ITEMS & CHUNK_MASK) == 0);
+			RTM_ASSERT(_maxItems > 0, "Invalid maximum number of items!");
+
+			m_maxChunks	= uint32_t((uint64_t(_maxItems) + CHUNK_MASK) >> CHUNK_SHIFT);
+			m_chunks	= rtm_new_array<std::atomic<Chunk*> >(m_maxChunks);
+			for (uint32_t i=0; i<m_maxChunks; ++i)
+				m_chunks[i].store(0, std::memory_order_relaxed);
+
+			m_tlsIndex	= tlsAllocate();
+		}
+
+		ChunkAllocatorConcurrent(const ChunkAllocatorConcurrent&) = delete;
+		ChunkAllocatorConcurrent& operator=(const ChunkAllocatorConcurrent&) = delete;
+
+		/// Destroys the allocator, no thread may use it at this point.
+		inline ~ChunkAllocatorConcurrent()
+		{
+			for (uint32_t i=0; i<m_maxChunks; ++i)
+			{
+				Chunk* chunk = m_chunks[i].load(std::memory_order_relaxed);
+				if (chunk)
+					rtm_delete<Chunk>(chunk);
+			}
+			rtm_delete_array<std::atomic<Chunk*> >(m_maxChunks, m_chunks);
+
+			ThreadCache* cache = m_threadCaches.load(std::memory_order_relaxed);
+			while (cache)
+			{
+				ThreadCache* next = cache->m_next;
+				if (cache->m_magazine)
+					rtm_delete<Magazine>(cache->m_magazine);
+				rtm_delete<ThreadCache>(cache);
+				cache = next;
+			}
+
+			deleteMagazines(m_fullMagazines);
+			deleteMagazines(m_emptyMagazines);
+
+			tlsSetValue(m_tlsIndex, 0);
+			tlsFree(m_tlsIndex);
+		}
+
+		/// Returns the total memory size used by the allocator.
+		///
+		/// @returns total memory size in bytes.
+		inline uint64_t totalMemorySize() const
+		{
+			return	uint64_t(m_numChunks.load(std::memory_order_relaxed)) * uint64_t(sizeof(Chunk)) +
+					uint64_t(m_maxChunks) * uint64_t(sizeof(std::atomic<Chunk*>)) +
+					uint64_t(sizeof(ChunkAllocatorConcurrent));
+		}
+
+		/// Allocates a handle for a new item, reusing freed handles first. Thread safe.
+		///
+		/// @returns handle to the newly allocated item.
+		inline uint32_t allocHandle()
+		{
+			ThreadCache* cache = getThreadCache();
+
+			Magazine* magazine = cache->m_magazine;
+			if (magazine->m_count)
+				return magazine->m_handles[--magazine->m_count];
+
+			// swap empty magazine for a full one freed by any thread
+			{
+				SpinLockScope lock(m_depotLock);
+				if (m_fullMagazines)
+				{
+					Magazine* full		= m_fullMagazines;
+					m_fullMagazines		= full->m_next;
+					magazine->m_next	= m_emptyMagazines;
+					m_emptyMagazines	= magazine;
+					cache->m_magazine	= full;
+					return full->m_handles[--full->m_count];
+				}
+			}
+
+			if (cache->m_claimNext == cache->m_claimEnd)
+				claimBatch(cache);
+
+			return cache->m_claimNext++;
+		}
+
+		/// Allocates a handle for a new item and optionally returns a pointer to it. Thread safe.
+		///
+		/// @param[out] _optionalPtr  : Optional pointer to receive the item pointer
+		///
+		/// @returns handle to the newly allocated item.
+		inline uint32_t allocHandle(T** _optionalPtr)
+		{
+			const uint32_t itemHandle = allocHandle();
+
+			if (_optionalPtr)
+			{
+				*_optionalPtr = getItem(itemHandle);
+			}
+
+			return itemHandle;
+		}
+
+		/// Allocates a new item. Thread safe.
+		///
+		/// @returns pointer to the newly allocated item.
+		inline T* alloc()
+		{
+			return getItem(allocHandle());
+		}
+
+		/// Frees a handle so it can be returned by a later allocHandle call. Thread safe.
+		///
+		/// @param[in] _handle  : Handle to free
+		inline void freeHandle(uint32_t _handle)
+		{
+			RTM_ASSERT(_handle < m_numItems.load(std::memory_order_relaxed), "Invalid handle!");
+
+			ThreadCache* cache = getThreadCache();
+
+			Magazine* magazine = cache->m_magazine;
+			if (magazine->m_count == MAGAZINE_SIZE)
+			{
+				SpinLockScope lock(m_depotLock);
+				magazine->m_next	= m_fullMagazines;
+				m_fullMagazines		= magazine;
+
+				if (m_emptyMagazines)
+				{
+					magazine			= m_emptyMagazines;
+					m_emptyMagazines	= magazine->m_next;
+				}
+				else
+					magazine = 0;
+			}
+
+			if (!magazine)
+			{
+				magazine			= rtm_new<Magazine>();
+				magazine->m_count	= 0;
+			}
+
+			cache->m_magazine = magazine;
+			magazine->m_handles[magazine->m_count++] = _handle;
+		}
+
+		/// Returns the number of handles claimed from the allocator, including cached and freed ones.
+		///
+		/// @returns number of items.
+		inline uint32_t size() const
+		{
+			return m_numItems.load(std::memory_order_relaxed);
+		}
+
+		/// Gets a pointer to an item by its handle/index.
+		///
+		/// @param[in] _index  : Handle/index of the item
+		///
+		/// @returns pointer to the item.
+		inline T* getItem(uint32_t _index)
+		{
+			uint32_t chunkIdx = _index >> CHUNK_SHIFT;
+			uint32_t  itemIdx = _index  & CHUNK_MASK;
+			return &m_chunks[chunkIdx].load(std::memory_order_acquire)->m_data[itemIdx];
+		}
+
+	private:
+		inline ThreadCache* getThreadCache()
+		{
+			ThreadCache* cache = (ThreadCache*)tlsGetValue(m_tlsIndex);
+			if (cache && (cache->m_owner == this))
+				return cache;
+
+			cache = rtm_new<ThreadCache>();
+			cache->m_owner				= this;
+			cache->m_magazine			= rtm_new<Magazine>();
+			cache->m_magazine->m_count	= 0;
+			cache->m_claimNext			= 0;
+			cache->m_claimEnd			= 0;
+
+			// caches are only freed with the allocator
+			cache->m_next = m_threadCaches.load(std::memory_order_relaxed);
+			while (!m_threadCaches.compare_exchange_weak(cache->m_next, cache, std::memory_order_release, std::memory_order_relaxed)) {}
+
+			tlsSetValue(m_tlsIndex, cache);
+			return cache;
+		}
+
+		/// Claims a range of handles and makes sure chunks backing it exist.
+		inline void claimBatch(ThreadCache* _cache)
+		{
+			const uint32_t first = m_numItems.fetch_add(CLAIM_BATCH, std::memory_order_relaxed);
+			RTM_ASSERT(uint64_t(first) + CLAIM_BATCH <= (uint64_t(m_maxChunks) << CHUNK_SHIFT), "Allocator is full!");
+
+			const uint32_t lastChunk = (first + CLAIM_BATCH - 1) >> CHUNK_SHIFT;
+			for (uint32_t i=first >> CHUNK_SHIFT; i<=lastChunk; ++i)
+				ensureChunk(i);
+
+			_cache->m_claimNext	= first;
+			_cache->m_claimEnd	= first + CLAIM_BATCH;
+		}
+
+		inline void ensureChunk(uint32_t _index)
+		{
+			if (m_chunks[_index].load(std::memory_order_acquire))
+				return;
+
+			Chunk* newChunk = rtm_new<Chunk>();
+			Chunk* expected = 0;
+			if (m_chunks[_index].compare_exchange_strong(expected, newChunk, std::memory_order_acq_rel))
+				m_numChunks.fetch_add(1, std::memory_order_relaxed);
+			else
+				rtm_delete<Chunk>(newChunk);	// another thread was faster
+		}
+
+		static inline void deleteMagazines(Magazine* _magazine)
+		{
+			while (_magazine)
+			{
+				Magazine* next = _magazine->m_next;
+				rtm_delete<Magazine>(_magazine);
+				_magazine = next;
+			}
+		}
+	};
+
 	//--------------------------------------------------------------------------
 	/// Stack allocator template for variable sized items
+	/// When constructed with a reserve size, allocations are bumped through a
+	/// single reserved range that is committed in chunk sized steps, so they
+	/// can also be larger than a chunk. Otherwise allocations larger than a
+	/// chunk get a dedicated oversized block.
+	/// Allocations can be freed in stack order by rewinding to a marker, chunks
+	/// are kept for reuse.
 	//--------------------------------------------------------------------------
 	class StackAllocator
 	{
@@ -210,23 +590,87 @@ namespace rtm {
 			uint8_t	m_data[CHUNK_SIZE];
 		};
 
-		Chunk**		m_chunks;
-		uint64_t	m_curChunkSize;
-		uint32_t	m_numChunks;
-		uint32_t	m_maxChunks;
+		struct OversizedBlock
+		{
+			OversizedBlock*	m_prev;
+			uint64_t		m_size;
+		};
+
+	public:
+		/// Allocator state that can be rewound to
+		struct Marker
+		{
+			OversizedBlock*	m_oversized;
+			uint64_t		m_offset;
+			uint32_t		m_chunk;
+		};
+
+	private:
+		Chunk**			m_chunks;
+		uint8_t*		m_base;			// start of reserved range, null when chunks are on heap
+		OversizedBlock*	m_oversized;	// most recent oversized block
+		uint64_t		m_oversizedSize;
+		uint64_t		m_reserveSize;
+		uint64_t		m_commitSize;
+		uint64_t		m_curChunkSize;	// offset from m_base when range is reserved
+		uint32_t		m_curChunk;
+		uint32_t		m_numChunks;
+		uint32_t		m_maxChunks;
+		uint32_t		m_highWater;	// most chunks in use since last reset
+		bool			m_hugePages;
 
 	public:
 		static const int DEFAULT_ALIGNMENT = 8;
 
 		inline StackAllocator()
 			: m_chunks(nullptr)
+			, m_base(nullptr)
+			, m_oversized(nullptr)
+			, m_oversizedSize(0)
+			, m_reserveSize(0)
+			, m_commitSize(0)
 			, m_curChunkSize(0)
+			, m_curChunk(0)
 			, m_numChunks(0)
 			, m_maxChunks(0)
+			, m_highWater(0)
+			, m_hugePages(false)
 		{
 			reset(true);
 		}
 
+		/// Reserves address space for all allocations, falls back to heap chunks
+		/// if virtual memory is not available.
+		///
+		/// @param[in] _reserveSize  : Size of address space to reserve in bytes
+		/// @param[in] _hugePages    : If true, asks the system to back allocations with huge pages
+		inline StackAllocator(uint64_t _reserveSize, bool _hugePages = false)
+			: m_chunks(nullptr)
+			, m_base(nullptr)
+			, m_oversized(nullptr)
+			, m_oversizedSize(0)
+			, m_reserveSize(0)
+			, m_commitSize(0)
+			, m_curChunkSize(0)
+			, m_curChunk(0)
+			, m_numChunks(0)
+			, m_maxChunks(0)
+			, m_highWater(0)
+			, m_hugePages(_hugePages)
+		{
+			RTM_ASSERT(_reserveSize > 0, "Invalid reserve size!");
+
+			const uint64_t reserveSize = (_reserveSize + CHUNK_SIZE - 1) & ~uint64_t(CHUNK_SIZE - 1);
+			m_base = (uint8_t*)virtualMemReserve(size_t(reserveSize));
+			if (m_base)
+			{
+				m_reserveSize = reserveSize;
+				if (m_hugePages)
+					virtualMemAdviseHugePages(m_base, size_t(m_reserveSize));
+			}
+			reset(true);
+		}
+
 		StackAllocator(const StackAllocator&) = delete;
 		StackAllocator& operator=(const StackAllocator&) = delete;
 
@@ -240,7 +684,9 @@ namespace rtm {
 		/// @returns total memory size in bytes.
 		inline uint64_t totalMemorySize() const
 		{
-			return uint64_t(m_numChunks) * uint64_t(sizeof(Chunk)) + uint64_t(sizeof(StackAllocator));
+			if (m_base)
+				return m_commitSize + uint64_t(sizeof(StackAllocator));
+			return uint64_t(m_numChunks) * uint64_t(sizeof(Chunk)) + m_oversizedSize + uint64_t(sizeof(StackAllocator));
 		}
 
 		/// Calculates padding required for given alignment.
@@ -250,7 +696,8 @@ namespace rtm {
 		/// @returns padding size in bytes.
 		inline uint32_t getPadding(uint32_t _alignment)
 		{
-			uintptr_t paddingBase = (uintptr_t)m_curChunkSize + (uintptr_t)m_chunks[m_numChunks - 1]->m_data;
+			uint8_t* chunkBase = m_base ? m_base : m_chunks[m_curChunk]->m_data;
+			uintptr_t paddingBase = (uintptr_t)m_curChunkSize + (uintptr_t)chunkBase;
 			return (_alignment - (paddingBase & (_alignment - 1))) & (_alignment - 1); // assumes power of 2 alignment
 		}
 
@@ -262,54 +709,177 @@ namespace rtm {
 		/// @returns pointer to allocated memory.
 		inline void* alloc(uint32_t _size, uint32_t _alignment = DEFAULT_ALIGNMENT)
 		{
-			RTM_ASSERT(_size <= CHUNK_SIZE, "Size cannot exceed chunk size");
 			RTM_ASSERT(_alignment > 0 && (_alignment & (_alignment - 1)) == 0, "Alignment must be a power of 2");
 
+			if (m_base)
+				return allocVirtual(_size, _alignment);
+
+			// padding could keep it from fitting even a fresh chunk
+			if (uint64_t(_size) + _alignment - 1 > CHUNK_SIZE)
+				return allocOversized(_size, _alignment);
+
 			uint32_t paddingExtra = getPadding(_alignment);
 
 			// check if current chunk is full:
 			// current item index is last one in chunk
 			while ((m_curChunkSize + _size + paddingExtra) > CHUNK_SIZE)
 			{
-				addNewChunk();
+				nextChunk();
 				paddingExtra = getPadding(_alignment);
 			}
 
-			Chunk* lastChunk = m_chunks[m_numChunks - 1];
+			Chunk* lastChunk = m_chunks[m_curChunk];
 			void* retPtr     = &lastChunk->m_data[m_curChunkSize + paddingExtra];
 			m_curChunkSize  += _size + paddingExtra;
 			return retPtr;
 		}
 
-		/// Resets the allocator, freeing all allocated memory.
+		/// Returns current state of the allocator, allocations made after it
+		/// can be freed with freeToMarker.
 		///
-		/// @param[in] _allocOneChunk  : If true, allocates one initial chunk after reset
-		void reset(bool _allocOneChunk = true)
+		/// @returns marker for the current state.
+		inline Marker getMarker() const
 		{
-			const uint32_t numChunks = m_numChunks;
+			Marker marker;
+			marker.m_oversized	= m_oversized;
+			marker.m_offset		= m_curChunkSize;
+			marker.m_chunk		= m_curChunk;
+			return marker;
+		}
+
+		/// Frees all allocations made after the marker was taken, chunks are kept.
+		///
+		/// @param[in] _marker  : Marker returned by getMarker
+		inline void freeToMarker(const Marker& _marker)
+		{
+			RTM_ASSERT((_marker.m_chunk < m_curChunk) || ((_marker.m_chunk == m_curChunk) && (_marker.m_offset <= m_curChunkSize)), "Marker is ahead of allocator!");
+
+			freeOversized(_marker.m_oversized);
+			m_curChunk		= _marker.m_chunk;
+			m_curChunkSize	= _marker.m_offset;
+		}
+
+		/// Resets the allocator, freeing all allocations.
+		///
+		/// @param[in] _allocOneChunk    : If true, chunks are kept for reuse, otherwise all memory is returned
+		/// @param[in] _trimToHighWater  : If true, chunks not used since the previous reset are returned
+		void reset(bool _allocOneChunk = true, bool _trimToHighWater = false)
+		{
+			freeOversized(nullptr);
+
+			if (m_base)
+			{
+				resetVirtual(_allocOneChunk, _trimToHighWater);
+				return;
+			}
+
+			m_curChunk		= 0;
+			m_curChunkSize	= 0;
+
+			if (_allocOneChunk && m_chunks)
+			{
+				if (_trimToHighWater)
+					freeChunks(m_highWater ? m_highWater : 1);
+				m_highWater = 1;
+				return;
+			}
+
 			if (m_chunks)
 			{
-				for (size_t i = 0; i < numChunks; ++i)
-				{
-					rtm_delete<Chunk>(m_chunks[i]);
-				}
+				freeChunks(0);
 				rtm_delete_array<Chunk*>(m_maxChunks, m_chunks);
 			}
 
 			m_chunks		= nullptr;
-			m_curChunkSize	= 0;
 			m_numChunks		= 0;
 			m_maxChunks		= 0;
+			m_highWater		= 0;
 
 			if (_allocOneChunk)
 			{
 				m_chunks = rtm_new_array<Chunk*>(CHUNK_ARRAY_INITIAL);
 				m_maxChunks = CHUNK_ARRAY_INITIAL;
 				addNewChunk(); // add initial chunk so there is always a valid last chunk (for alloc call)
+				m_highWater = 1;
 			}
 		}
 
 	private:
+		inline void* allocVirtual(uint32_t _size, uint32_t _alignment)
+		{
+			const uint64_t start	= m_curChunkSize + getPadding(_alignment);
+			const uint64_t end		= start + _size;
+			if (end > m_reserveSize)
+			{
+				RTM_ASSERT(false, "Reserved range exhausted!");
+				return nullptr;
+			}
+
+			const uint64_t commitSize = (end + CHUNK_SIZE - 1) & ~uint64_t(CHUNK_SIZE - 1);
+			if (commitSize > m_commitSize)
+			{
+				if (!virtualMemCommit(m_base + m_commitSize, size_t(commitSize - m_commitSize)))
+				{
+					RTM_ASSERT(false, "Failed to commit memory!");
+					return nullptr;
+				}
+				m_commitSize = commitSize;
+			}
+
+			const uint32_t chunksUsed = uint32_t(commitSize / CHUNK_SIZE);
+			if (chunksUsed > m_highWater)
+				m_highWater = chunksUsed;
+
+			m_curChunkSize = end;
+			return m_base + start;
+		}
+
+		void resetVirtual(bool _allocOneChunk, bool _trimToHighWater)
+		{
+			m_curChunkSize = 0;
+
+			if (_allocOneChunk)
+			{
+				const uint64_t keepSize = uint64_t(m_highWater ? m_highWater : 1) * CHUNK_SIZE;
+				if (m_commitSize == 0)
+				{
+					const bool committed = virtualMemCommit(m_base, CHUNK_SIZE);
+					RTM_ASSERT(committed, "Failed to commit memory!");
+					RTM_UNUSED(committed);
+					m_commitSize = CHUNK_SIZE;
+				}
+				else if (_trimToHighWater && (m_commitSize > keepSize))
+				{
+					virtualMemDecommit(m_base + keepSize, size_t(m_commitSize - keepSize));
+					if (m_hugePages)
+						virtualMemAdviseHugePages(m_base, size_t(m_reserveSize));
+					m_commitSize = keepSize;
+				}
+				m_highWater = 1;
+			}
+			else
+			{
+				virtualMemRelease(m_base, size_t(m_reserveSize));
+				m_base			= nullptr;
+				m_reserveSize	= 0;
+				m_commitSize	= 0;
+				m_highWater		= 0;
+			}
+		}
+
+		/// Moves to the next chunk, reusing a kept one if there is any.
+		void nextChunk()
+		{
+			if (m_curChunk + 1 == m_numChunks)
+				addNewChunk();
+
+			++m_curChunk;
+			m_curChunkSize = 0;
+
+			if (m_curChunk + 1 > m_highWater)
+				m_highWater = m_curChunk + 1;
+		}
+
 		void addNewChunk()
 		{
 			Chunk* newChunk = rtm_new<Chunk>();
@@ -323,7 +893,355 @@ namespace rtm {
 				m_chunks = newArray;
 			}
 			m_chunks[m_numChunks++]	= newChunk;
-			m_curChunkSize			= 0;
+		}
+
+		/// Deletes kept chunks past the given count.
+		void freeChunks(uint32_t _keepChunks)
+		{
+			for (uint32_t i=_keepChunks; i<m_numChunks; ++i)
+			{
+				rtm_delete<Chunk>(m_chunks[i]);
+			}
+			if (_keepChunks < m_numChunks)
+				m_numChunks = _keepChunks;
+		}
+
+		void* allocOversized(uint32_t _size, uint32_t _alignment)
+		{
+			// block header is followed by padding for alignment
+			const uint64_t size = uint64_t(sizeof(OversizedBlock)) + _alignment - 1 + _size;
+
+			OversizedBlock* block = (OversizedBlock*)RBASE_NAMESPACE::rtm_alloc(size_t(size));
+			block->m_prev	= m_oversized;
+			block->m_size	= size;
+
+			m_oversized		= block;
+			m_oversizedSize	+= size;
+
+			const uintptr_t data = (uintptr_t)(block + 1);
+			return (void*)((data + _alignment - 1) & ~uintptr_t(_alignment - 1));
+		}
+
+		/// Frees oversized blocks allocated after the given one.
+		void freeOversized(OversizedBlock* _last)
+		{
+			while (m_oversized != _last)
+			{
+				OversizedBlock* block = m_oversized;
+				m_oversized		= block->m_prev;
+				m_oversizedSize	-= block->m_size;
+				RBASE_NAMESPACE::rtm_free(block);
+			}
+		}
+	};
+
+	//--------------------------------------------------------------------------
+	/// Frees stack allocations made during its lifetime when going out of scope
+	//--------------------------------------------------------------------------
+	class StackAllocatorScope
+	{
+		StackAllocator&			m_allocator;
+		StackAllocator::Marker	m_marker;
+
+	public:
+		inline StackAllocatorScope(StackAllocator& _allocator)
+			: m_allocator(_allocator)
+			, m_marker(_allocator.getMarker())
+		{
+		}
+
+		inline ~StackAllocatorScope()
+		{
+			m_allocator.freeToMarker(m_marker);
+		}
+
+		StackAllocatorScope(const StackAllocatorScope&) = delete;
+		StackAllocatorScope& operator=(const StackAllocatorScope&) = delete;
+	};
+
+	//--------------------------------------------------------------------------
+	/// N-buffered frame allocator, memory allocated during a frame stays valid
+	/// until the same frame slot comes around again, N frames later. Threads
+	/// bump allocate from their own chunk, chunks come from a shared pool and
+	/// a frame returns all of its chunks to the pool at once.
+	/// A thread may not allocate for a frame that has already been released.
+	//--------------------------------------------------------------------------
+	class FrameAllocator
+	{
+		enum
+		{
+			CHUNK_SIZE			= 1024 * 1024,	// usable bytes per chunk
+			MAX_FRAMES			= 8
+		};
+
+		struct Chunk
+		{
+			Chunk*		m_next;
+			uint64_t	m_size;		// set for oversized blocks that are not pooled
+		};
+
+		struct Frame
+		{
+			Chunk*		m_chunks;
+			Chunk*		m_lastChunk;
+			Chunk*		m_oversized;
+			uint32_t	m_numChunks;
+		};
+
+		struct ThreadCache
+		{
+			FrameAllocator*	m_owner;
+			ThreadCache*	m_next;
+			uint8_t*		m_pos;
+			uint8_t*		m_end;
+			uint32_t		m_frame;
+		};
+
+		SpinLock					m_lock;
+		Frame						m_frames[MAX_FRAMES];
+		Chunk*						m_freeChunks;
+		std::atomic<ThreadCache*>	m_threadCaches;
+		std::atomic<uint32_t>		m_frame;
+		uint32_t					m_numFrames;
+		uint32_t					m_numChunks;
+		uint32_t					m_numFreeChunks;
+		uint32_t					m_tlsIndex;
+		uint64_t					m_oversizedSize;
+
+	public:
+		static const int DEFAULT_ALIGNMENT = 8;
+
+		/// @param[in] _numFrames  : Number of frames allocations live for, at most 8
+		inline FrameAllocator(uint32_t _numFrames = 2)
+			: m_freeChunks(0)
+			, m_threadCaches(0)
+			, m_frame(0)
+			, m_numFrames(_numFrames)
+			, m_numChunks(0)
+			, m_numFreeChunks(0)
+			, m_oversizedSize(0)
+		{
+			RTM_ASSERT((_numFrames > 0) && (_numFrames <= MAX_FRAMES), "Invalid number of frames!");
+
+			memSet(m_frames, 0, sizeof(m_frames));
+			m_tlsIndex = tlsAllocate();
+		}
+
+		FrameAllocator(const FrameAllocator&) = delete;
+		FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+		/// Destroys the allocator, no thread may use it at this point.
+		inline ~FrameAllocator()
+		{
+			for (uint32_t i=0; i<MAX_FRAMES; ++i)
+			{
+				freeOversized(detachFrame(m_frames[i]));
+			}
+			trim(0);
+
+			ThreadCache* cache = m_threadCaches.load(std::memory_order_relaxed);
+			while (cache)
+			{
+				ThreadCache* next = cache->m_next;
+				rtm_delete<ThreadCache>(cache);
+				cache = next;
+			}
+
+			tlsSetValue(m_tlsIndex, 0);
+			tlsFree(m_tlsIndex);
+		}
+
+		/// Returns the total memory size used by the allocator.
+		///
+		/// @returns total memory size in bytes.
+		inline uint64_t totalMemorySize() const
+		{
+			return	uint64_t(m_numChunks) * uint64_t(sizeof(Chunk) + CHUNK_SIZE) + m_oversizedSize +
+					uint64_t(sizeof(FrameAllocator));
+		}
+
+		/// Returns number of chunks allocated, in use or free.
+		inline uint32_t getNumChunks() const { return m_numChunks; }
+
+		/// Returns number of chunks ready for reuse.
+		inline uint32_t getNumFreeChunks() const { return m_numFreeChunks; }
+
+		/// Returns index of the current frame.
+		inline uint32_t getFrame() const { return m_frame.load(std::memory_order_acquire); }
+
+		/// Allocates memory for the current frame. Thread safe.
+		///
+		/// @param[in] _size       : Size in bytes to allocate
+		/// @param[in] _alignment  : Required alignment (must be power of 2)
+		///
+		/// @returns pointer to allocated memory.
+		inline void* alloc(uint32_t _size, uint32_t _alignment = DEFAULT_ALIGNMENT)
+		{
+			RTM_ASSERT(_alignment > 0 && (_alignment & (_alignment - 1)) == 0, "Alignment must be a power of 2");
+
+			ThreadCache* cache = getThreadCache();
+
+			// chunk of a previous frame belongs to that frame, start a new one
+			const uint32_t frame = m_frame.load(std::memory_order_acquire);
+			if (cache->m_frame != frame)
+			{
+				cache->m_frame	= frame;
+				cache->m_pos	= 0;
+				cache->m_end	= 0;
+			}
+
+			uintptr_t ptr = ((uintptr_t)cache->m_pos + _alignment - 1) & ~uintptr_t(_alignment - 1);
+			if (!cache->m_pos || (ptr + _size > (uintptr_t)cache->m_end))
+			{
+				if (uint64_t(_size) + _alignment - 1 > CHUNK_SIZE)
+					return allocOversized(frame, _size, _alignment);
+
+				Chunk* chunk	= takeChunk(frame);
+				cache->m_pos	= (uint8_t*)(chunk + 1);
+				cache->m_end	= cache->m_pos + CHUNK_SIZE;
+				ptr = ((uintptr_t)cache->m_pos + _alignment - 1) & ~uintptr_t(_alignment - 1);
+			}
+
+			cache->m_pos = (uint8_t*)(ptr + _size);
+			return (void*)ptr;
+		}
+
+		/// Moves to the next frame, memory allocated N frames ago is released.
+		/// Must not be called concurrently with itself.
+		inline void nextFrame()
+		{
+			Chunk* oversized;
+			{
+				SpinLockScope lock(m_lock);
+
+				const uint32_t frame = m_frame.load(std::memory_order_relaxed) + 1;
+				oversized = detachFrame(m_frames[frame % m_numFrames]);
+				m_frame.store(frame, std::memory_order_release);
+			}
+
+			freeOversized(oversized);
+		}
+
+		/// Frees pooled chunks that are not in use.
+		///
+		/// @param[in] _keepChunks  : Number of free chunks to keep
+		inline void trim(uint32_t _keepChunks = 0)
+		{
+			SpinLockScope lock(m_lock);
+			while (m_freeChunks && (m_numFreeChunks > _keepChunks))
+			{
+				Chunk* chunk	= m_freeChunks;
+				m_freeChunks	= chunk->m_next;
+				--m_numFreeChunks;
+				--m_numChunks;
+				RBASE_NAMESPACE::rtm_free(chunk);
+			}
+		}
+
+	private:
+		inline ThreadCache* getThreadCache()
+		{
+			ThreadCache* cache = (ThreadCache*)tlsGetValue(m_tlsIndex);
+			if (cache && (cache->m_owner == this))
+				return cache;
+
+			cache = rtm_new<ThreadCache>();
+			cache->m_owner	= this;
+			cache->m_pos	= 0;
+			cache->m_end	= 0;
+			cache->m_frame	= m_frame.load(std::memory_order_relaxed);
+
+			// caches are only freed with the allocator
+			cache->m_next = m_threadCaches.load(std::memory_order_relaxed);
+			while (!m_threadCaches.compare_exchange_weak(cache->m_next, cache, std::memory_order_release, std::memory_order_relaxed)) {}
+
+			tlsSetValue(m_tlsIndex, cache);
+			return cache;
+		}
+
+		/// Gets a chunk from the pool, or a new one, and adds it to the frame.
+		inline Chunk* takeChunk(uint32_t _frame)
+		{
+			Chunk* chunk = 0;
+			{
+				SpinLockScope lock(m_lock);
+				if (m_freeChunks)
+				{
+					chunk			= m_freeChunks;
+					m_freeChunks	= chunk->m_next;
+					--m_numFreeChunks;
+				}
+				else
+					++m_numChunks;
+			}
+
+			if (!chunk)
+			{
+				chunk = (Chunk*)RBASE_NAMESPACE::rtm_alloc(sizeof(Chunk) + CHUNK_SIZE);
+				chunk->m_size = 0;
+			}
+
+			SpinLockScope lock(m_lock);
+			Frame& slot = m_frames[_frame % m_numFrames];
+			chunk->m_next = slot.m_chunks;
+			if (!slot.m_chunks)
+				slot.m_lastChunk = chunk;
+			slot.m_chunks = chunk;
+			++slot.m_numChunks;
+			return chunk;
+		}
+
+		inline void* allocOversized(uint32_t _frame, uint32_t _size, uint32_t _alignment)
+		{
+			const uint64_t size = uint64_t(sizeof(Chunk)) + _alignment - 1 + _size;
+
+			Chunk* block = (Chunk*)RBASE_NAMESPACE::rtm_alloc(size_t(size));
+			block->m_size = size;
+			{
+				SpinLockScope lock(m_lock);
+				Frame& slot = m_frames[_frame % m_numFrames];
+				block->m_next		= slot.m_oversized;
+				slot.m_oversized	= block;
+				m_oversizedSize		+= size;
+			}
+
+			const uintptr_t data = (uintptr_t)(block + 1);
+			return (void*)((data + _alignment - 1) & ~uintptr_t(_alignment - 1));
+		}
+
+		inline void freeOversized(Chunk* _block)
+		{
+			uint64_t freed = 0;
+			while (_block)
+			{
+				Chunk* next = _block->m_next;
+				freed += _block->m_size;
+				RBASE_NAMESPACE::rtm_free(_block);
+				_block = next;
+			}
+
+			if (freed)
+			{
+				SpinLockScope lock(m_lock);
+				m_oversizedSize -= freed;
+			}
+		}
+
+		/// Returns chunks of a frame to the pool in one go and empties the frame.
+		///
+		/// @returns oversized blocks of the frame, to be freed without holding the lock.
+		inline Chunk* detachFrame(Frame& _frame)
+		{
+			if (_frame.m_chunks)
+			{
+				_frame.m_lastChunk->m_next	= m_freeChunks;
+				m_freeChunks				= _frame.m_chunks;
+				m_numFreeChunks				+= _frame.m_numChunks;
+			}
+
+			Chunk* oversized = _frame.m_oversized;
+			memSet(&_frame, 0, sizeof(Frame));
+			return oversized;
 		}
 	};
 
@@ -7,6 +7,7 @@
 #define RTM_RBASE_FILE_H
 
 #include <rbase/inc/platform.h>
+#include <rbase/inc/hash.h>
 
 namespace rtm {
 
@@ -215,6 +216,16 @@ namespace rtm {
 	/// @returns number of bytes written.
 	int64_t	fileWriteIfDifferent(FileStorage _type, const char* _path, const void* _data, int64_t _size, bool* _written = 0);
 
+	/// Calculates hash of file contents, streaming the file through a fixed size buffer.
+	///
+	/// @param[in] _type        : File storage type
+	/// @param[in] _path        : File path
+	/// @param[in] _algorithm   : Hash algorithm to use
+	/// @param[out] _hash       : Buffer to store hash to, 4 bytes for Murmur3, 8 bytes for City64 and 16 bytes for MD5
+	///
+	/// @returns number of bytes hashed or -1 on failure.
+	int64_t	fileHash(FileStorage _type, const char* _path, HashAlgorithm::Enum _algorithm, void* _hash);
+
 } // namespace rtm
 
 /// ---------------------------------------------------------------------- ///
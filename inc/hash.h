@@ -44,6 +44,25 @@ namespace rtm {
 	/// @returns the calculated hash value.
 	uint64_t hashCity64(const void* _key, uint32_t _len, uint64_t _seed);
 
+	/// Calculates 64bit hash value using an XXH3 style algorithm. Long inputs are
+	/// processed with SIMD instructions when available, results do not depend on
+	/// the instruction set used. Output is not compatible with XXH3.
+	///
+	/// @param[in] _key      : Key buffer to hash
+	/// @param[in] _len      : Length of the key buffer
+	/// @param[in] _seed     : Seed value
+	///
+	/// @returns the calculated hash value.
+	uint64_t hashFast64(const void* _key, uint32_t _len, uint64_t _seed = 0);
+
+	/// Calculates 128bit hash value using an XXH3 style algorithm.
+	///
+	/// @param[in] _key      : Key buffer to hash
+	/// @param[in] _len      : Length of the key buffer
+	/// @param[out] _hash    : Buffer to store calculated hash value, low 64 bits first
+	/// @param[in] _seed     : Seed value
+	void hashFast128(const void* _key, uint32_t _len, uint64_t _hash[2], uint64_t _seed = 0);
+
 	/// Calculates a string hash using a simple hashing algorithm.
 	///
 	/// @param[in] _string   : String to hash
@@ -52,6 +71,55 @@ namespace rtm {
 	/// @returns the calculated hash value.
 	static inline uint32_t hashStr(const char* _string, uint32_t _maxChars = UINT32_MAX);
 
+	/// Calculates 32bit FNV-1 string hash, same value as RTM_COMPILE_TIME_STRING_HASH.
+	///
+	/// @param[in] _string   : String to hash
+	///
+	/// @returns the calculated hash value.
+	static inline uint32_t hashFNV1(const char* _string);
+
+	/// Calculates 64bit FNV-1 string hash, same value as RTM_COMPILE_TIME_STRING_HASH64.
+	///
+	/// @param[in] _string   : String to hash
+	///
+	/// @returns the calculated hash value.
+	static inline uint64_t hashFNV1_64(const char* _string);
+
+	/// Calculates 64bit FNV-1a string hash.
+	///
+	/// @param[in] _string   : String to hash
+	///
+	/// @returns the calculated hash value.
+	static inline uint64_t hashFNV1a_64(const char* _string);
+
+	/// Calculates 64bit FNV-1a hash of a buffer, same value as the string variant
+	/// for a buffer holding the string characters.
+	///
+	/// @param[in] _data     : Data buffer to hash
+	/// @param[in] _len      : Length of the data buffer
+	///
+	/// @returns the calculated hash value.
+	static inline uint64_t hashFNV1a_64(const void* _data, uint32_t _len);
+
+	/// Calculates 32bit MurMur3 hash values for multiple keys. Several keys are
+	/// hashed in parallel, results are the same as calling hashMurmur3 per key.
+	///
+	/// @param[in] _keys     : Array of key buffers to hash
+	/// @param[in] _lens     : Array of key buffer lengths
+	/// @param[in] _count    : Number of keys to hash
+	/// @param[out] _hashes  : Array to store calculated hash values to
+	/// @param[in] _seed     : Seed value
+	void hashMurmur3Batch(const void* const* _keys, const uint32_t* _lens, uint32_t _count, uint32_t* _hashes, uint32_t _seed = 0);
+
+	/// Calculates string hashes for multiple strings. Several strings are hashed
+	/// in parallel, results are the same as calling hashStr per string.
+	///
+	/// @param[in] _strings  : Array of strings to hash
+	/// @param[in] _count    : Number of strings to hash
+	/// @param[out] _hashes  : Array to store calculated hash values to
+	/// @param[in] _maxChars : Maximum number of characters to use for hashing
+	void hashStrBatch(const char* const* _strings, uint32_t _count, uint32_t* _hashes, uint32_t _maxChars = UINT32_MAX);
+
 	/// Calculates an MD5 hash.
 	///
 	/// @param[in] _data     : Data to hash
@@ -59,12 +127,120 @@ namespace rtm {
 	/// @param[out] _digest  : Buffer to store calculated MD5 hash
 	void hashMD5(const void* _data, uint32_t _dataSize, uint8_t _digest[16]);
 
+	/// Calculates MD5 hashes of multiple buffers. Several buffers are hashed in
+	/// parallel, one per SIMD lane, results are the same as calling hashMD5 per buffer.
+	///
+	/// @param[in] _data      : Array of data buffers to hash
+	/// @param[in] _dataSizes : Array of data buffer sizes
+	/// @param[in] _count     : Number of buffers to hash
+	/// @param[out] _digests  : Array of buffers to store calculated MD5 hashes
+	void hashMD5Batch(const void* const* _data, const uint32_t* _dataSizes, uint32_t _count, uint8_t _digests[][16]);
+
 	/// Converts an MD5 hash to string representation.
 	///
 	/// @param[in] _digest   : Hash digest to convert
 	/// @param[out] _hash    : Buffer to store string representation of the MD5 hash
 	void hashMD5toString(uint8_t _digest[16], char _hash[33]);
 
+	/// Hash algorithms selectable at run time.
+	struct HashAlgorithm
+	{
+		enum Enum
+		{
+			Murmur3,	///< 32bit hash, same as hashMurmur3 with zero seed
+			City64,		///< 64bit hash, same as hashCity64
+			MD5,		///< 128bit digest, same as hashMD5
+
+			Count
+		};
+	};
+
+	/// Incremental MurMur3 hasher. Data can be fed in arbitrary sized pieces
+	/// and the result is the same as hashMurmur3 on the concatenated input.
+	class HasherMurmur3
+	{
+		uint32_t	m_hash;
+		uint32_t	m_tail;
+		uint32_t	m_tailSize;
+		uint32_t	m_length;
+
+	public:
+		/// Resets hasher state.
+		///
+		/// @param[in] _seed     : Seed value
+		inline void init(uint32_t _seed = 0);
+
+		/// Adds data to hash.
+		///
+		/// @param[in] _data     : Data buffer to hash
+		/// @param[in] _size     : Size of the data buffer
+		inline void update(const void* _data, uint32_t _size);
+
+		/// Finishes hashing, hasher must be initialized again before reuse.
+		///
+		/// @returns the calculated hash value.
+		inline uint32_t finalize();
+	};
+
+	/// Incremental City hasher. City hash mixes the last 64 bytes of the input
+	/// into the initial state, so total length and tail must be known up front.
+	/// The result is the same as hashCity64 on the concatenated input.
+	class HasherCity64
+	{
+		uint64_t	m_state[7];
+		uint64_t	m_length;
+		uint64_t	m_fed;
+		uint8_t		m_buffer[64];
+		uint32_t	m_bufferSize;
+
+	public:
+		/// Resets hasher state.
+		///
+		/// @param[in] _length   : Total length of data to be hashed
+		/// @param[in] _tail     : Last min(_length, 64) bytes of data to be hashed
+		void init(uint64_t _length, const void* _tail);
+
+		/// Adds data to hash, all of the _length bytes must be fed in order.
+		///
+		/// @param[in] _data     : Data buffer to hash
+		/// @param[in] _size     : Size of the data buffer
+		void update(const void* _data, uint32_t _size);
+
+		/// Finishes hashing, hasher must be initialized again before reuse.
+		///
+		/// @returns the calculated hash value.
+		uint64_t finalize();
+
+		/// Finishes hashing, hasher must be initialized again before reuse.
+		///
+		/// @param[in] _seed     : Seed value
+		///
+		/// @returns the calculated hash value, same as seeded hashCity64.
+		uint64_t finalize(uint64_t _seed);
+	};
+
+	/// Incremental MD5 hasher. The result is the same as hashMD5 on the
+	/// concatenated input.
+	class HasherMD5
+	{
+		RTM_ALIGN(8) uint8_t	m_data[128];
+
+	public:
+		/// Resets hasher state.
+		void init();
+
+		/// Adds data to hash.
+		///
+		/// @param[in] _data     : Data buffer to hash
+		/// @param[in] _size     : Size of the data buffer
+		void update(const void* _data, uint32_t _size);
+
+		/// Finishes hashing, hasher must be initialized again before reuse.
+		///
+		/// @param[out] _digest  : Buffer to store calculated MD5 hash
+		void finalize(uint8_t _digest[16]);
+	};
+
 } // namespace rtm
 
 /// ---------------------------------------------------------------------- ///
@@ -137,6 +313,8 @@ namespace rtm {
 	uint32_t hashCity32(const void* _key, uint32_t _len);
 	uint64_t hashCity64(const void* _key, uint32_t _len);
 	uint64_t hashCity64(const void* _key, uint32_t _len, uint64_t _seed);
+	uint64_t hashFast64(const void* _key, uint32_t _len, uint64_t _seed);
+	void hashFast128(const void* _key, uint32_t _len, uint64_t _hash[2], uint64_t _seed);
 
 	//--------------------------------------------------------------------------
 	/// Calculate a string hash, suitable for short strings
@@ -155,9 +333,92 @@ namespace rtm {
 	   return h;
 	}
 
+	void hashMurmur3Batch(const void* const* _keys, const uint32_t* _lens, uint32_t _count, uint32_t* _hashes, uint32_t _seed);
+	void hashStrBatch(const char* const* _strings, uint32_t _count, uint32_t* _hashes, uint32_t _maxChars);
+
 	void hashMD5(const void* _data, uint32_t _dataSize, uint8_t _digest[16]);
+	void hashMD5Batch(const void* const* _data, const uint32_t* _dataSizes, uint32_t _count, uint8_t _digests[][16]);
 	void hashMD5toString(uint8_t _digest[16], char _hash[33]);
 
+	//--------------------------------------------------------------------------
+	/// Incremental Murmur3 hashing
+	//--------------------------------------------------------------------------
+	inline void HasherMurmur3::init(uint32_t _seed)
+	{
+		m_hash		= _seed;
+		m_tail		= 0;
+		m_tailSize	= 0;
+		m_length	= 0;
+	}
+
+	inline void HasherMurmur3::update(const void* _data, uint32_t _size)
+	{
+		const uint8_t* data = (const uint8_t*)_data;
+		const uint8_t* end  = data + _size;
+
+		const uint32_t c1 = 0xcc9e2d51;
+		const uint32_t c2 = 0x1b873593;
+
+		m_length += _size;
+
+		uint32_t h1 = m_hash;
+		uint32_t k1 = m_tail;
+		uint32_t tailSize = m_tailSize;
+
+		// complete a block left over from previous update
+		while (tailSize && (tailSize < 4) && (data < end))
+			k1 |= uint32_t(*data++) << (8 * tailSize++);
+
+		if (tailSize == 4)
+		{
+			k1 *= c1; k1 = rotl32(k1,15); k1 *= c2;
+			h1 ^= k1;
+			h1 = rotl32(h1,13);
+			h1 = h1*5+0xe6546b64;
+			k1 = 0;
+			tailSize = 0;
+		}
+
+		while (end - data >= 4)
+		{
+			k1 = uint32_t(data[0]) | (uint32_t(data[1]) << 8) | (uint32_t(data[2]) << 16) | (uint32_t(data[3]) << 24);
+			data += 4;
+
+			k1 *= c1; k1 = rotl32(k1,15); k1 *= c2;
+			h1 ^= k1;
+			h1 = rotl32(h1,13);
+			h1 = h1*5+0xe6546b64;
+			k1 = 0;
+		}
+
+		while (data < end)
+			k1 |= uint32_t(*data++) << (8 * tailSize++);
+
+		m_hash		= h1;
+		m_tail		= k1;
+		m_tailSize	= tailSize;
+	}
+
+	inline uint32_t HasherMurmur3::finalize()
+	{
+		uint32_t h1 = m_hash;
+		uint32_t k1 = m_tail;
+
+		if (m_tailSize)
+		{
+			k1 *= 0xcc9e2d51; k1 = rotl32(k1,15); k1 *= 0x1b873593; h1 ^= k1;
+		}
+
+		h1 ^= m_length;
+		h1 ^= h1 >> 16;
+		h1 *= 0x85ebca6b;
+		h1 ^= h1 >> 13;
+		h1 *= 0xc2b2ae35;
+		h1 ^= h1 >> 16;
+
+		return h1;
+	}
+
 	namespace hash_private {
 
 		template <typename S> struct fnv_internal;
@@ -170,27 +431,105 @@ namespace rtm {
 			constexpr static uint32_t FNV1_PRIME		= 0x01000193;
 		};
 
+		template <> struct fnv_internal<uint64_t>
+		{
+			constexpr static uint64_t FNV1_OFFSET_BASIS	= 0xCBF29CE484222325ULL;
+			constexpr static uint64_t FNV1_PRIME		= 0x00000100000001B3ULL;
+		};
+
 	} // namespace hash
 
+	// Loops instead of recursion so long strings stay within compiler constant evaluation limits.
+	// 32bit variants keep hashing sign extended characters so existing values do not change.
 	template <> struct hash_private::fnv1<uint32_t> : public hash_private::fnv_internal<uint32_t>
 	{
-		constexpr static inline uint32_t hash(char const* _str, const uint32_t _val = FNV1_OFFSET_BASIS)
+		constexpr static inline uint32_t hash(char const* _str, uint32_t _val = FNV1_OFFSET_BASIS)
 		{
-			return (_str[0] == '\0') ? _val : hash(&_str[1], (_val * FNV1_PRIME) ^ uint32_t(_str[0]));
+			while (*_str)
+				_val = (_val * FNV1_PRIME) ^ uint32_t(*_str++);
+			return _val;
 		}
 	};
 
 	template <> struct hash_private::fnv1a<uint32_t> : public hash_private::fnv_internal<uint32_t>
 	{
-		constexpr static inline uint32_t hash(char const* _str, const uint32_t _val = FNV1_OFFSET_BASIS)
+		constexpr static inline uint32_t hash(char const* _str, uint32_t _val = FNV1_OFFSET_BASIS)
 		{
-			return (_str[0] == '\0') ? _val : hash(&_str[1], (_val ^ uint32_t(_str[0])) * FNV1_PRIME);
+			while (*_str)
+				_val = (_val ^ uint32_t(*_str++)) * FNV1_PRIME;
+			return _val;
 		}
 	};
 
+	template <> struct hash_private::fnv1<uint64_t> : public hash_private::fnv_internal<uint64_t>
+	{
+		constexpr static inline uint64_t hash(char const* _str, uint64_t _val = FNV1_OFFSET_BASIS)
+		{
+			while (*_str)
+				_val = (_val * FNV1_PRIME) ^ uint8_t(*_str++);
+			return _val;
+		}
+
+		constexpr static inline uint64_t hash(const uint8_t* _data, uint32_t _len, uint64_t _val = FNV1_OFFSET_BASIS)
+		{
+			for (uint32_t i=0; i<_len; ++i)
+				_val = (_val * FNV1_PRIME) ^ _data[i];
+			return _val;
+		}
+	};
+
+	template <> struct hash_private::fnv1a<uint64_t> : public hash_private::fnv_internal<uint64_t>
+	{
+		constexpr static inline uint64_t hash(char const* _str, uint64_t _val = FNV1_OFFSET_BASIS)
+		{
+			while (*_str)
+				_val = (_val ^ uint8_t(*_str++)) * FNV1_PRIME;
+			return _val;
+		}
+
+		constexpr static inline uint64_t hash(const uint8_t* _data, uint32_t _len, uint64_t _val = FNV1_OFFSET_BASIS)
+		{
+			for (uint32_t i=0; i<_len; ++i)
+				_val = (_val ^ _data[i]) * FNV1_PRIME;
+			return _val;
+		}
+	};
+
+	// FNV-1/FNV-1a 64bit reference values
+	RTM_STATIC_ASSERT(hash_private::fnv1<uint64_t>::hash("")		== 0xCBF29CE484222325ULL);
+	RTM_STATIC_ASSERT(hash_private::fnv1<uint64_t>::hash("a")		== 0xAF63BD4C8601B7BEULL);
+	RTM_STATIC_ASSERT(hash_private::fnv1a<uint64_t>::hash("a")		== 0xAF63DC4C8601EC8CULL);
+	RTM_STATIC_ASSERT(hash_private::fnv1a<uint64_t>::hash("foobar")	== 0x85944171F73967E8ULL);
+
+	//--------------------------------------------------------------------------
+	/// FNV hashing, same code path as compile time hashes
+	//--------------------------------------------------------------------------
+	static inline uint32_t hashFNV1(const char* _string)
+	{
+		return hash_private::fnv1<uint32_t>::hash(_string);
+	}
+
+	static inline uint64_t hashFNV1_64(const char* _string)
+	{
+		return hash_private::fnv1<uint64_t>::hash(_string);
+	}
+
+	static inline uint64_t hashFNV1a_64(const char* _string)
+	{
+		return hash_private::fnv1a<uint64_t>::hash(_string);
+	}
+
+	static inline uint64_t hashFNV1a_64(const void* _data, uint32_t _len)
+	{
+		return hash_private::fnv1a<uint64_t>::hash((const uint8_t*)_data, _len);
+	}
+
 } // namespace rtm
 
 /// compile time string hash
 #define RTM_COMPILE_TIME_STRING_HASH(_string)	rtm::hash_private::fnv1<uint32_t>::hash(_string)
 
+/// compile time 64bit string hash, same value as rtm::hashFNV1_64 at run time
+#define RTM_COMPILE_TIME_STRING_HASH64(_string)	rtm::hash_private::fnv1<uint64_t>::hash(_string)
+
 #endif // RTM_RBASE_HASH_H
@@ -0,0 +1,679 @@
+//--------------------------------------------------------------------------//
+/// Copyright 2025 Milos Tosic. All Rights Reserved.                       ///
+/// License: http://www.opensource.org/licenses/BSD-2-Clause               ///
+//--------------------------------------------------------------------------//
+
+#ifndef RTM_RBASE_HASHMAP_H
+#define RTM_RBASE_HASHMAP_H
+
+#include <rbase/inc/platform.h>
+#include <rbase/inc/hash.h>
+#include <rbase/inc/stringfn.h>
+#include <rbase/inc/libhandler.h>
+
+namespace rtm {
+
+	//--------------------------------------------------------------------------
+	/// Hashers, a hasher provides a 64bit hash of a key and key equality.
+	//--------------------------------------------------------------------------
+
+	/// Default hasher, hashes key bytes so keys must not contain padding.
+	template <typename K>
+	struct HashMapHasher
+	{
+		static inline uint64_t	hash(const K& _key)						{ return hashFast64(&_key, sizeof(K)); }
+		static inline bool		equal(const K& _lhs, const K& _rhs)		{ return _lhs == _rhs; }
+	};
+
+	/// Hasher using MurMur3, hashes key bytes so keys must not contain padding.
+	template <typename K>
+	struct HashMapHasherMurmur3
+	{
+		static inline uint64_t	hash(const K& _key)						{ const uint64_t h = hashMurmur3(&_key, sizeof(K)); return h | (h << 32); }
+		static inline bool		equal(const K& _lhs, const K& _rhs)		{ return _lhs == _rhs; }
+	};
+
+	/// Hasher for zero terminated string keys, strings are not copied and must outlive the container.
+	struct HashMapHasherStr
+	{
+		static inline uint64_t	hash(const char* _key)						{ return hashFast64(_key, strLen(_key)); }
+		static inline bool		equal(const char* _lhs, const char* _rhs)	{ return strCmp(_lhs, _rhs) == 0; }
+	};
+
+	//--------------------------------------------------------------------------
+	/// Container forward declarations
+	//--------------------------------------------------------------------------
+
+	/// Key/value pair stored in hash maps
+	template <typename K, typename V>
+	struct HashMapEntry
+	{
+		K	m_key;
+		V	m_value;
+	};
+
+	/// Key stored in hash sets
+	template <typename K>
+	struct HashSetEntry
+	{
+		K	m_key;
+	};
+
+	/// Growable open addressing hash map
+	template <typename K, typename V, typename HASHER = HashMapHasher<K> >
+	class HashMap;
+
+	/// Fixed capacity open addressing hash map, no allocations
+	template <typename K, typename V, uint32_t CAPACITY, typename HASHER = HashMapHasher<K> >
+	class FixedHashMap;
+
+	/// Growable open addressing hash set
+	template <typename K, typename HASHER = HashMapHasher<K> >
+	class HashSet;
+
+	/// Fixed capacity open addressing hash set, no allocations
+	template <typename K, uint32_t CAPACITY, typename HASHER = HashMapHasher<K> >
+	class FixedHashSet;
+
+	namespace hashmap_private {
+
+		//--------------------------------------------------------------------------
+		/// SwissTable style table. Each slot has a control byte holding 7 bits of
+		/// the key hash, or an empty/deleted marker. Lookups compare a whole group
+		/// of control bytes at once using the widest SIMD register available, so
+		/// slots are only touched on likely matches. Control bytes of the first
+		/// group are mirrored past the end so a group can be loaded at any slot.
+		//--------------------------------------------------------------------------
+		enum : uint8_t
+		{
+			CtrlEmpty	= 0x80,
+			CtrlDeleted	= 0xFE
+		};
+
+		constexpr uint32_t GroupSize = mem_private::VEC_SIZE;
+
+		/// Returns number of slots that may be used before the table must be rehashed, max load factor is 7/8.
+		static inline uint32_t maxLoad(uint32_t _capacity)
+		{
+			return _capacity - _capacity / 8;
+		}
+
+		/// Returns a power of two capacity that holds at least given number of items.
+		static inline uint32_t capacityFor(uint32_t _numItems)
+		{
+			uint32_t capacity = GroupSize;
+			while (maxLoad(capacity) < _numItems)
+				capacity *= 2;
+			return capacity;
+		}
+
+		template <typename K, typename SLOT, typename HASHER>
+		class Table
+		{
+		public:
+			uint8_t*	m_ctrl;
+			SLOT*		m_slots;
+			uint32_t	m_capacity;
+			uint32_t	m_size;
+			uint32_t	m_growthLeft;
+
+			inline Table()
+				: m_ctrl(0)
+				, m_slots(0)
+				, m_capacity(0)
+				, m_size(0)
+				, m_growthLeft(0)
+			{}
+
+			inline void init(uint8_t* _ctrl, SLOT* _slots, uint32_t _capacity)
+			{
+				RTM_ASSERT((_capacity >= GroupSize) && ((_capacity & (_capacity - 1)) == 0), "Capacity must be a power of two, at least group size!");
+				m_ctrl			= _ctrl;
+				m_slots			= _slots;
+				m_capacity		= _capacity;
+				m_size			= 0;
+				m_growthLeft	= maxLoad(_capacity);
+				memSet(m_ctrl, CtrlEmpty, _capacity + GroupSize);
+			}
+
+			inline void destroyAll()
+			{
+				for (uint32_t i=0; i<m_capacity; ++i)
+					if (isFull(i))
+						m_slots[i].~SLOT();
+			}
+
+			inline void clear()
+			{
+				destroyAll();
+				if (m_capacity)
+					init(m_ctrl, m_slots, m_capacity);
+			}
+
+			inline bool isFull(uint32_t _index) const
+			{
+				return (m_ctrl[_index] & 0x80) == 0;
+			}
+
+			inline void setCtrl(uint32_t _index, uint8_t _ctrl)
+			{
+				m_ctrl[_index] = _ctrl;
+				if (_index < GroupSize)
+					m_ctrl[m_capacity + _index] = _ctrl;
+			}
+
+			inline uint32_t find(const K& _key, uint64_t _hash) const
+			{
+				if (!m_capacity)
+					return UINT32_MAX;
+
+				const uint32_t mask = m_capacity - 1;
+				const mem_private::Vec h2		= mem_private::vecSplat(uint8_t(_hash & 0x7f));
+				const mem_private::Vec empty	= mem_private::vecSplat(CtrlEmpty);
+
+				uint32_t pos = uint32_t(_hash >> 7) & mask;
+				for (uint32_t step=GroupSize; ; step+=GroupSize)
+				{
+					const mem_private::Vec group = mem_private::vecLoad(m_ctrl + pos);
+
+					uint64_t match = mem_private::vecMask(mem_private::vecCmpEq(group, h2));
+					while (match)
+					{
+						const uint32_t index = (pos + mem_private::maskFirst(match)) & mask;
+						if (HASHER::equal(m_slots[index].m_key, _key))
+							return index;
+						match = mem_private::maskClearFirst(match);
+					}
+
+					// an empty slot ends the probe sequence, key would have been placed there
+					if (mem_private::vecMask(mem_private::vecCmpEq(group, empty)))
+						return UINT32_MAX;
+
+					pos = (pos + step) & mask;
+				}
+			}
+
+			/// Finds first empty or deleted slot in the probe sequence, optionally returns start of the group it was found in.
+			inline uint32_t findFree(uint64_t _hash, uint32_t* _groupStart = 0) const
+			{
+				const uint32_t mask = m_capacity - 1;
+				const mem_private::Vec empty	= mem_private::vecSplat(CtrlEmpty);
+				const mem_private::Vec deleted	= mem_private::vecSplat(CtrlDeleted);
+
+				uint32_t pos = uint32_t(_hash >> 7) & mask;
+				for (uint32_t step=GroupSize; ; step+=GroupSize)
+				{
+					const mem_private::Vec group = mem_private::vecLoad(m_ctrl + pos);
+					const uint64_t match = mem_private::vecMask(mem_private::vecOr(mem_private::vecCmpEq(group, empty), mem_private::vecCmpEq(group, deleted)));
+					if (match)
+					{
+						if (_groupStart)
+							*_groupStart = pos;
+						return (pos + mem_private::maskFirst(match)) & mask;
+					}
+
+					pos = (pos + step) & mask;
+				}
+			}
+
+			/// Claims a slot for a key known not to be in the table, slot is not constructed.
+			inline uint32_t claim(uint64_t _hash)
+			{
+				RTM_ASSERT(m_growthLeft > 0, "Table is full!");
+				const uint32_t index = findFree(_hash);
+				m_growthLeft -= m_ctrl[index] == CtrlEmpty ? 1 : 0;
+				setCtrl(index, uint8_t(_hash & 0x7f));
+				++m_size;
+				return index;
+			}
+
+			inline void erase(uint32_t _index)
+			{
+				m_slots[_index].~SLOT();
+				setCtrl(_index, CtrlDeleted);
+				--m_size;
+			}
+
+			/// Moves all items into another, empty table.
+			inline void moveTo(Table& _table)
+			{
+				for (uint32_t i=0; i<m_capacity; ++i)
+				{
+					if (!isFull(i))
+						continue;
+
+					const uint32_t index = _table.claim(HASHER::hash(m_slots[i].m_key));
+					new (&_table.m_slots[index], rtmAllocTag::Tag) SLOT(m_slots[i]);
+					m_slots[i].~SLOT();
+				}
+				m_size = 0;
+			}
+
+			/// Removes deleted markers without allocating, items are moved only if they
+			/// end up in a different group of their probe sequence.
+			inline void rehashInPlace()
+			{
+				const uint32_t mask = m_capacity - 1;
+
+				// full slots become deleted, meaning 'needs placement', deleted slots become empty
+				for (uint32_t i=0; i<m_capacity; ++i)
+					m_ctrl[i] = isFull(i) ? CtrlDeleted : CtrlEmpty;
+				memCopy(m_ctrl + m_capacity, GroupSize, m_ctrl, GroupSize);
+
+				RTM_ALIGN(16) uint8_t temp[sizeof(SLOT)];
+
+				for (uint32_t i=0; i<m_capacity; ++i)
+				{
+					if (m_ctrl[i] != CtrlDeleted)
+						continue;
+
+					const uint64_t hash = HASHER::hash(m_slots[i].m_key);
+					uint32_t groupStart;
+					const uint32_t target = findFree(hash, &groupStart);
+
+					if (((i - groupStart) & mask) < GroupSize)
+					{
+						// already in the group it would be placed in
+						setCtrl(i, uint8_t(hash & 0x7f));
+						continue;
+					}
+
+					if (m_ctrl[target] == CtrlEmpty)
+					{
+						new (&m_slots[target], rtmAllocTag::Tag) SLOT(m_slots[i]);
+						m_slots[i].~SLOT();
+						setCtrl(target, uint8_t(hash & 0x7f));
+						setCtrl(i, CtrlEmpty);
+						continue;
+					}
+
+					// target holds another item that still needs placement, swap and process this slot again
+					SLOT* tempSlot = new (temp, rtmAllocTag::Tag) SLOT(m_slots[target]);
+					m_slots[target].~SLOT();
+					new (&m_slots[target], rtmAllocTag::Tag) SLOT(m_slots[i]);
+					m_slots[i].~SLOT();
+					new (&m_slots[i], rtmAllocTag::Tag) SLOT(*tempSlot);
+					tempSlot->~SLOT();
+					setCtrl(target, uint8_t(hash & 0x7f));
+					--i;
+				}
+
+				m_growthLeft = maxLoad(m_capacity) - m_size;
+			}
+
+			template <typename FN>
+			inline void forEach(FN _fn)
+			{
+				for (uint32_t i=0; i<m_capacity; ++i)
+					if (isFull(i))
+						_fn(m_slots[i]);
+			}
+		};
+
+		//--------------------------------------------------------------------------
+		/// Heap storage, control bytes and slots share one allocation
+		//--------------------------------------------------------------------------
+		template <typename K, typename SLOT, typename HASHER>
+		class GrowableTable
+		{
+		protected:
+			typedef Table<K, SLOT, HASHER> TableType;
+
+			TableType	m_table;
+
+			inline GrowableTable()
+			{
+			}
+
+			inline ~GrowableTable()
+			{
+				release();
+			}
+
+			static inline uint32_t slotsOffset(uint32_t _capacity)
+			{
+				const uint32_t align = RTM_ALIGNOF(SLOT) > 16 ? uint32_t(RTM_ALIGNOF(SLOT)) : 16;
+				return (_capacity + GroupSize + align - 1) & ~(align - 1);
+			}
+
+			inline void release()
+			{
+				if (!m_table.m_ctrl)
+					return;
+
+				m_table.destroyAll();
+				RBASE_NAMESPACE::rtm_free(m_table.m_ctrl, 64);
+				m_table = TableType();
+			}
+
+			inline void resize(uint32_t _capacity)
+			{
+				uint8_t* memory = (uint8_t*)RBASE_NAMESPACE::rtm_alloc(slotsOffset(_capacity) + sizeof(SLOT) * _capacity, 64);
+				RTM_ASSERT(memory != 0, "Failed to allocate memory!");
+
+				TableType table;
+				table.init(memory, (SLOT*)(memory + slotsOffset(_capacity)), _capacity);
+
+				if (m_table.m_ctrl)
+				{
+					m_table.moveTo(table);
+					RBASE_NAMESPACE::rtm_free(m_table.m_ctrl, 64);
+				}
+
+				m_table = table;
+			}
+
+			/// Makes room for one more item, either by dropping deleted markers or by growing.
+			inline bool prepareInsert()
+			{
+				if (m_table.m_growthLeft)
+					return true;
+
+				if (m_table.m_capacity && (m_table.m_size <= maxLoad(m_table.m_capacity) / 2))
+					m_table.rehashInPlace();
+				else
+					resize(m_table.m_capacity ? m_table.m_capacity * 2 : GroupSize);
+				return true;
+			}
+
+		public:
+			/// Reserves space for given number of items.
+			///
+			/// @param[in] _numItems : Number of items
+			inline void reserve(uint32_t _numItems)
+			{
+				const uint32_t capacity = capacityFor(_numItems);
+				if (capacity > m_table.m_capacity)
+					resize(capacity);
+			}
+		};
+
+		//--------------------------------------------------------------------------
+		/// Inline storage, capacity is fixed
+		//--------------------------------------------------------------------------
+		template <typename K, typename SLOT, typename HASHER, uint32_t CAPACITY>
+		class FixedTable
+		{
+		protected:
+			typedef Table<K, SLOT, HASHER> TableType;
+
+			enum { Capacity = CAPACITY < GroupSize ? GroupSize : CAPACITY };
+
+			RTM_ALIGN(16) uint8_t	m_ctrl[Capacity + GroupSize];
+			RTM_ALIGN(16) uint8_t	m_slotStorage[Capacity * sizeof(SLOT)];
+			TableType				m_table;
+
+			inline FixedTable()
+			{
+				RTM_STATIC_ASSERT(((CAPACITY & (CAPACITY - 1)) == 0) && (CAPACITY != 0), "CAPACITY must be a power of two!");
+				RTM_STATIC_ASSERT(RTM_ALIGNOF(SLOT) <= 16, "Slot alignment too large for inline storage!");
+				m_table.init(m_ctrl, (SLOT*)m_slotStorage, Capacity);
+			}
+
+			inline ~FixedTable()
+			{
+				m_table.destroyAll();
+			}
+
+			/// Makes room for one more item by dropping deleted markers, fails if the table is full.
+			inline bool prepareInsert()
+			{
+				if (m_table.m_growthLeft)
+					return true;
+
+				if (m_table.m_size == maxLoad(m_table.m_capacity))
+					return false;
+
+				m_table.rehashInPlace();
+				return true;
+			}
+		};
+
+		//--------------------------------------------------------------------------
+		/// Map interface shared by growable and fixed variants
+		//--------------------------------------------------------------------------
+		template <typename K, typename V, typename HASHER, typename STORAGE>
+		class MapBase : public STORAGE
+		{
+		public:
+			typedef HashMapEntry<K, V> Entry;
+
+			inline MapBase()
+			{
+			}
+
+			MapBase(const MapBase&) = delete;
+			MapBase& operator=(const MapBase&) = delete;
+
+			/// Finds value associated with a key.
+			///
+			/// @param[in] _key      : Key to find
+			///
+			/// @returns pointer to the value or null if key is not in the map.
+			inline V* find(const K& _key)
+			{
+				const uint32_t index = this->m_table.find(_key, HASHER::hash(_key));
+				return index == UINT32_MAX ? 0 : &this->m_table.m_slots[index].m_value;
+			}
+
+			/// Finds value associated with a key.
+			///
+			/// @param[in] _key      : Key to find
+			///
+			/// @returns pointer to the value or null if key is not in the map.
+			inline const V* find(const K& _key) const
+			{
+				const uint32_t index = this->m_table.find(_key, HASHER::hash(_key));
+				return index == UINT32_MAX ? 0 : &this->m_table.m_slots[index].m_value;
+			}
+
+			/// Checks if key is in the map.
+			///
+			/// @param[in] _key      : Key to find
+			///
+			/// @returns true if key is in the map.
+			inline bool contains(const K& _key) const
+			{
+				return this->m_table.find(_key, HASHER::hash(_key)) != UINT32_MAX;
+			}
+
+			/// Inserts a key/value pair, value is replaced if key is already in the map.
+			///
+			/// @param[in] _key      : Key to insert
+			/// @param[in] _value    : Value to associate with the key
+			///
+			/// @returns pointer to the stored value or null if fixed capacity map is full.
+			inline V* insert(const K& _key, const V& _value)
+			{
+				const uint64_t hash = HASHER::hash(_key);
+				uint32_t index = this->m_table.find(_key, hash);
+				if (index != UINT32_MAX)
+				{
+					this->m_table.m_slots[index].m_value = _value;
+					return &this->m_table.m_slots[index].m_value;
+				}
+
+				if (!this->prepareInsert())
+					return 0;
+
+				index = this->m_table.claim(hash);
+				Entry* entry = new (&this->m_table.m_slots[index], rtmAllocTag::Tag) Entry{ _key, _value };
+				return &entry->m_value;
+			}
+
+			/// Removes a key from the map.
+			///
+			/// @param[in] _key      : Key to remove
+			///
+			/// @returns true if key was found and removed.
+			inline bool erase(const K& _key)
+			{
+				const uint32_t index = this->m_table.find(_key, HASHER::hash(_key));
+				if (index == UINT32_MAX)
+					return false;
+
+				this->m_table.erase(index);
+				return true;
+			}
+
+			/// Removes all items, memory is kept.
+			inline void clear()
+			{
+				this->m_table.clear();
+			}
+
+			/// Calls a function for each entry, in no particular order.
+			///
+			/// @param[in] _fn       : Function taking an Entry reference
+			template <typename FN>
+			inline void forEach(FN _fn)
+			{
+				this->m_table.forEach(_fn);
+			}
+
+			inline uint32_t size() const
+			{
+				return this->m_table.m_size;
+			}
+
+			inline uint32_t capacity() const
+			{
+				return this->m_table.m_capacity;
+			}
+
+			inline bool isEmpty() const
+			{
+				return this->m_table.m_size == 0;
+			}
+		};
+
+		//--------------------------------------------------------------------------
+		/// Set interface shared by growable and fixed variants
+		//--------------------------------------------------------------------------
+		template <typename K, typename HASHER, typename STORAGE>
+		class SetBase : public STORAGE
+		{
+		public:
+			typedef HashSetEntry<K> Entry;
+
+			inline SetBase()
+			{
+			}
+
+			SetBase(const SetBase&) = delete;
+			SetBase& operator=(const SetBase&) = delete;
+
+			/// Checks if key is in the set.
+			///
+			/// @param[in] _key      : Key to find
+			///
+			/// @returns true if key is in the set.
+			inline bool contains(const K& _key) const
+			{
+				return this->m_table.find(_key, HASHER::hash(_key)) != UINT32_MAX;
+			}
+
+			/// Inserts a key into the set.
+			///
+			/// @param[in] _key      : Key to insert
+			///
+			/// @returns true if key was inserted, false if already present or fixed capacity set is full.
+			inline bool insert(const K& _key)
+			{
+				const uint64_t hash = HASHER::hash(_key);
+				if (this->m_table.find(_key, hash) != UINT32_MAX)
+					return false;
+
+				if (!this->prepareInsert())
+					return false;
+
+				const uint32_t index = this->m_table.claim(hash);
+				new (&this->m_table.m_slots[index], rtmAllocTag::Tag) Entry{ _key };
+				return true;
+			}
+
+			/// Removes a key from the set.
+			///
+			/// @param[in] _key      : Key to remove
+			///
+			/// @returns true if key was found and removed.
+			inline bool erase(const K& _key)
+			{
+				const uint32_t index = this->m_table.find(_key, HASHER::hash(_key));
+				if (index == UINT32_MAX)
+					return false;
+
+				this->m_table.erase(index);
+				return true;
+			}
+
+			/// Removes all keys, memory is kept.
+			inline void clear()
+			{
+				this->m_table.clear();
+			}
+
+			/// Calls a function for each entry, in no particular order.
+			///
+			/// @param[in] _fn       : Function taking an Entry reference
+			template <typename FN>
+			inline void forEach(FN _fn)
+			{
+				this->m_table.forEach(_fn);
+			}
+
+			inline uint32_t size() const
+			{
+				return this->m_table.m_size;
+			}
+
+			inline uint32_t capacity() const
+			{
+				return this->m_table.m_capacity;
+			}
+
+			inline bool isEmpty() const
+			{
+				return this->m_table.m_size == 0;
+			}
+		};
+
+	} // namespace hashmap_private
+
+	//--------------------------------------------------------------------------
+	/// Growable open addressing hash map, memory is allocated through rtm_alloc
+	//--------------------------------------------------------------------------
+	template <typename K, typename V, typename HASHER>
+	class HashMap : public hashmap_private::MapBase<K, V, HASHER, hashmap_private::GrowableTable<K, HashMapEntry<K, V>, HASHER> >
+	{
+	};
+
+	//--------------------------------------------------------------------------
+	/// Fixed capacity open addressing hash map, CAPACITY must be a power of two
+	/// and at most 7/8 of it can be used.
+	//--------------------------------------------------------------------------
+	template <typename K, typename V, uint32_t CAPACITY, typename HASHER>
+	class FixedHashMap : public hashmap_private::MapBase<K, V, HASHER, hashmap_private::FixedTable<K, HashMapEntry<K, V>, HASHER, CAPACITY> >
+	{
+	};
+
+	//--------------------------------------------------------------------------
+	/// Growable open addressing hash set, memory is allocated through rtm_alloc
+	//--------------------------------------------------------------------------
+	template <typename K, typename HASHER>
+	class HashSet : public hashmap_private::SetBase<K, HASHER, hashmap_private::GrowableTable<K, HashSetEntry<K>, HASHER> >
+	{
+	};
+
+	//--------------------------------------------------------------------------
+	/// Fixed capacity open addressing hash set, CAPACITY must be a power of two
+	/// and at most 7/8 of it can be used.
+	//--------------------------------------------------------------------------
+	template <typename K, uint32_t CAPACITY, typename HASHER>
+	class FixedHashSet : public hashmap_private::SetBase<K, HASHER, hashmap_private::FixedTable<K, HashSetEntry<K>, HASHER, CAPACITY> >
+	{
+	};
+
+} // namespace rtm
+
+#endif // RTM_RBASE_HASHMAP_H
@@ -8,63 +8,257 @@
 
 #include <rbase/inc/thread.h>
 #include <rbase/inc/stringfn.h>
+#include <rbase/inc/spinlock.h>
+#include <rbase/inc/cpu.h>
 #include <math.h>
+#include <atomic>
+#include <new>
 
 namespace rtm {
 
+	namespace itc_private {
+
+		/// RWBuffer storage block, data follows the header.
+		struct Block
+		{
+			Block*					m_next;
+			std::atomic<uint32_t>	m_pos;		// write position, can run past capacity when reservations race
+			uint32_t				m_end;		// end of valid data, set once block is closed
+			uint32_t				m_capacity;
+			bool					m_pooled;
+
+			inline uint8_t* data()
+			{
+				return (uint8_t*)(this + 1);
+			}
+
+			inline void reset()
+			{
+				m_next	= 0;
+				m_end	= 0;
+				m_pos.store(0, std::memory_order_relaxed);
+			}
+		};
+
+	} // namespace itc_private
+
+	//--------------------------------------------------------------------------
+	/// Thread safe pool of fixed size RWBuffer pages. Pages are recycled
+	/// between producers and consumers so memory use follows the workload
+	/// instead of the worst case frame.
+	//--------------------------------------------------------------------------
+	class RWBufferPool
+	{
+		typedef itc_private::Block Block;
+
+		SpinLock	m_lock;
+		Block*		m_freePages;
+		uint32_t	m_pageSize;
+		uint32_t	m_numPages;
+		uint32_t	m_numFreePages;
+
+		RTM_CLASS_NO_COPY(RWBufferPool)
+
+	public:
+		/// @param[in] _pageSize : Usable bytes per page
+		RWBufferPool(uint32_t _pageSize = 16*1024)
+			: m_freePages(0)
+			, m_pageSize(_pageSize)
+			, m_numPages(0)
+			, m_numFreePages(0)
+		{
+		}
+
+		~RWBufferPool()
+		{
+			RTM_ASSERT(m_numPages == m_numFreePages, "Pages still in use!");
+			trim(0);
+		}
+
+		/// Returns usable bytes per page.
+		uint32_t getPageSize() const { return m_pageSize; }
+
+		/// Returns number of pages allocated, in use or free.
+		uint32_t getNumPages() const { return m_numPages; }
+
+		/// Returns number of pages ready for reuse.
+		uint32_t getNumFreePages() const { return m_numFreePages; }
+
+		/// Gets a page from the free list, allocates one if the list is empty.
+		Block* alloc()
+		{
+			Block* page = 0;
+			{
+				SpinLockScope lock(m_lock);
+				if (m_freePages)
+				{
+					page		= m_freePages;
+					m_freePages	= page->m_next;
+					--m_numFreePages;
+				}
+				else
+					++m_numPages;
+			}
+
+			if (!page)
+			{
+				page = new (new uint8_t[sizeof(Block) + m_pageSize]) Block;
+				page->m_capacity	= m_pageSize;
+				page->m_pooled		= true;
+			}
+
+			page->reset();
+			return page;
+		}
+
+		/// Returns a page to the free list.
+		void release(Block* _page)
+		{
+			SpinLockScope lock(m_lock);
+			_page->m_next	= m_freePages;
+			m_freePages		= _page;
+			++m_numFreePages;
+		}
+
+		/// Releases free pages back to the allocator.
+		///
+		/// @param[in] _numFreePages : Number of free pages to keep
+		void trim(uint32_t _numFreePages)
+		{
+			SpinLockScope lock(m_lock);
+			while (m_numFreePages > _numFreePages)
+			{
+				Block* page	= m_freePages;
+				m_freePages	= page->m_next;
+				delete[] (uint8_t*)page;
+				--m_numFreePages;
+				--m_numPages;
+			}
+		}
+	};
+
+	//--------------------------------------------------------------------------
+	/// Byte stream written by producer(s) between start and finish and read by
+	/// a consumer afterwards. Storage is a chain of blocks, writes that do not
+	/// fit chain a new block instead of failing. reserve is thread safe so
+	/// several producers can fill the buffer concurrently. With a pool set,
+	/// blocks are pool pages and the consumer returns them as it reads.
+	//--------------------------------------------------------------------------
 	class RWBuffer
 	{
-		uint8_t*	m_buffer;
-		uint32_t	m_pos;
-		uint32_t	m_size;
-		uint32_t	m_capacity;
+		typedef itc_private::Block Block;
+
+		Block*					m_first;
+		std::atomic<Block*>		m_writeBlock;
+		Block*					m_readBlock;
+		uint32_t				m_readPos;
+		uint32_t				m_capacity;
+		RWBufferPool*			m_pool;
 
 		RTM_CLASS_NO_COPY(RWBuffer)
 
 	public:
 		RWBuffer()
-			: m_buffer(0)
-			, m_pos(0)
-			, m_size(0)
+			: m_first(0)
+			, m_writeBlock(0)
+			, m_readBlock(0)
+			, m_readPos(0)
 			, m_capacity(0)
+			, m_pool(0)
 		{
 		}
 
 		~RWBuffer()
 		{
-			delete[] m_buffer;
+			freeBlocks(m_first);
 		}
 
+		/// Sets size of the first block, chained blocks are at least this large.
 		void setCapacity(uint32_t _capacity)
 		{
-			delete[] m_buffer;
-			m_buffer	= (uint8_t*)new uint8_t[_capacity];
+			if (m_first && !m_pool && (m_capacity == _capacity))
+			{
+				start();
+				return;
+			}
+
+			freeBlocks(m_first);
+			m_pool		= 0;
 			m_capacity	= _capacity;
+			m_first		= allocBlock(_capacity);
+			m_writeBlock.store(m_first, std::memory_order_relaxed);
+			m_readBlock	= 0;
 		}
-		
+
+		/// Makes buffer take pages from a pool, reads return pages as they are consumed.
+		///
+		/// @param[in] _pool : Page pool, must outlive the buffer
+		void setPool(RWBufferPool* _pool)
+		{
+			freeBlocks(m_first);
+			m_pool		= _pool;
+			m_capacity	= _pool->getPageSize();
+			m_first		= allocBlock(0);
+			m_writeBlock.store(m_first, std::memory_order_relaxed);
+			m_readBlock	= 0;
+		}
+
+		/// Discards chained blocks and prepares buffer for writing.
 		void start()
 		{
-			m_pos	= 0;
-			m_size	= m_capacity;
+			freeBlocks(m_first->m_next);
+			m_first->reset();
+			m_writeBlock.store(m_first, std::memory_order_relaxed);
+			m_readBlock	= 0;
 		}
 
+		/// Ends writing and prepares buffer for reading, all producers must be done.
 		void finish()
 		{
-			m_size	= m_pos;
-			m_pos	= 0;
+			Block* block = m_writeBlock.load(std::memory_order_acquire);
+			const uint32_t pos = block->m_pos.load(std::memory_order_relaxed);
+			block->m_end = pos < block->m_capacity ? pos : block->m_capacity;
+
+			m_readBlock	= m_first;
+			m_readPos	= 0;
 		}
 
+		/// Returns true, writes chain new blocks when the buffer is full.
 		bool spaceAvailable() const
 		{
-			return m_pos < m_size;
+			return true;
 		}
 
+		/// Writes data, single producer only.
 		void write(const void* _data, uint32_t _size)
 		{
-			RTM_ASSERT(m_size == m_capacity, "Write called outside of start/finish!");
-			RTM_ASSERT(m_pos + _size <= m_size, "Command buffer is full!");
-			memCopy(&m_buffer[m_pos], m_capacity - m_pos, _data, _size);
-			m_pos += _size;
+			RTM_ASSERT(m_readBlock == 0, "Write called outside of start/finish!");
+
+			const uint8_t* data = (const uint8_t*)_data;
+			Block* block = m_writeBlock.load(std::memory_order_relaxed);
+			uint32_t pos = block->m_pos.load(std::memory_order_relaxed);
+
+			while (_size)
+			{
+				if (pos == block->m_capacity)
+				{
+					block->m_end	= pos;
+					Block* next		= allocBlock(_size);
+					block->m_next	= next;
+					block			= next;
+					pos				= 0;
+					m_writeBlock.store(next, std::memory_order_relaxed);
+				}
+
+				const uint32_t room = block->m_capacity - pos;
+				const uint32_t size = _size < room ? _size : room;
+				memCopy(&block->data()[pos], room, data, size);
+				pos		+= size;
+				data	+= size;
+				_size	-= size;
+			}
+
+			block->m_pos.store(pos, std::memory_order_relaxed);
 		}
 
 		template <typename T>
@@ -73,16 +267,59 @@ namespace rtm {
 			write((const char*)(&_value), sizeof(T));
 		}
 
-		bool dataAvailable() const
+		/// Reserves contiguous space, thread safe. Must not be mixed with write in the same frame.
+		///
+		/// @param[in] _size : Number of bytes to reserve
+		///
+		/// @returns pointer to write data to.
+		uint8_t* reserve(uint32_t _size)
 		{
-			return m_pos < m_size;
+			RTM_ASSERT(m_readBlock == 0, "Reserve called outside of start/finish!");
+
+			for (;;)
+			{
+				Block* block = m_writeBlock.load(std::memory_order_acquire);
+				const uint32_t pos = block->m_pos.fetch_add(_size, std::memory_order_relaxed);
+				if (pos + _size <= block->m_capacity)
+					return &block->data()[pos];
+
+				// the reservation that crossed the end closes the block and chains a new one
+				if (pos <= block->m_capacity)
+				{
+					block->m_end = pos;
+					Block* next = allocBlock(_size);
+					next->m_pos.store(_size, std::memory_order_relaxed);
+					block->m_next = next;
+					m_writeBlock.store(next, std::memory_order_release);
+					return next->data();
+				}
+
+				while (m_writeBlock.load(std::memory_order_acquire) == block)
+					threadYield();
+			}
+		}
+
+		bool dataAvailable()
+		{
+			return nextReadBlock();
 		}
 
 		void read(void* _data, uint32_t _size)
 		{
-			RTM_ASSERT(m_pos + _size <= m_size, "Trying to read beyond command buffer end!");
-			memCopy(_data, _size,  &m_buffer[m_pos], _size);
-			m_pos += _size;
+			uint8_t* data = (uint8_t*)_data;
+			while (_size)
+			{
+				const bool available = nextReadBlock();
+				RTM_ASSERT(available, "Trying to read beyond command buffer end!");
+				RTM_UNUSED(available);
+
+				const uint32_t left = m_readBlock->m_end - m_readPos;
+				const uint32_t size = _size < left ? _size : left;
+				memCopy(data, _size, &m_readBlock->data()[m_readPos], size);
+				m_readPos	+= size;
+				data		+= size;
+				_size		-= size;
+			}
 		}
 
 		template <typename T>
@@ -91,11 +328,14 @@ namespace rtm {
 			read((char*)&_value, sizeof(T));
 		}
 
+		/// Skips data, returning pointer to it. Data written with reserve is never split between blocks.
+		/// With a pool set, pointer is valid until reading moves on to the next block.
 		const uint8_t* skip(uint32_t _size)
 		{
-			RTM_ASSERT(m_pos + _size <= m_size, "Trying to read/write beyond command buffer end!");
-			const uint8_t* result = &m_buffer[m_pos];
-			m_pos += _size;
+			nextReadBlock();
+			RTM_ASSERT(m_readBlock && (m_readPos + _size <= m_readBlock->m_end), "Trying to read/write beyond command buffer end!");
+			const uint8_t* result = &m_readBlock->data()[m_readPos];
+			m_readPos += _size;
 			return result;
 		}
 
@@ -104,33 +344,153 @@ namespace rtm {
 		{
 			skip(sizeof(T));
 		}
+
+	private:
+		/// Moves to next block with unread data, returns false if there is none.
+		bool nextReadBlock()
+		{
+			if (!m_readBlock)
+				return false;
+
+			while (m_readPos == m_readBlock->m_end)
+			{
+				Block* next = m_readBlock->m_next;
+				if (!next)
+					return false;
+
+				// consumed pages go back to the pool right away
+				if (m_pool)
+				{
+					RTM_ASSERT(m_readBlock == m_first, "");
+					m_first = next;
+					freeBlock(m_readBlock);
+				}
+
+				m_readBlock	= next;
+				m_readPos	= 0;
+			}
+			return true;
+		}
+
+		/// Allocates a block, pool pages are used unless size does not fit in one.
+		Block* allocBlock(uint32_t _minSize)
+		{
+			if (m_pool && (_minSize <= m_pool->getPageSize()))
+				return m_pool->alloc();
+
+			const uint32_t capacity = _minSize > m_capacity ? _minSize : m_capacity;
+			Block* block = new (new uint8_t[sizeof(Block) + capacity]) Block;
+			block->m_capacity	= capacity;
+			block->m_pooled		= false;
+			block->reset();
+			return block;
+		}
+
+		void freeBlock(Block* _block)
+		{
+			if (_block->m_pooled)
+				m_pool->release(_block);
+			else
+				delete[] (uint8_t*)_block;
+		}
+
+		void freeBlocks(Block* _block)
+		{
+			while (_block)
+			{
+				Block* next = _block->m_next;
+				freeBlock(_block);
+				_block = next;
+			}
+		}
 	};
 
+	//--------------------------------------------------------------------------
+	/// Hands frames of commands from a producer to a consumer thread through a
+	/// ring of buffers. Producer can run up to (number of buffers - 1) frames
+	/// ahead of the consumer before frame() stalls.
+	//--------------------------------------------------------------------------
 	class CommandBuffer
 	{
-		RWBuffer		m_commandBuffers[2];
-		RWBuffer*		m_cmdBufferProduce;
-		RWBuffer*		m_cmdBufferConsume;
-		Semaphore		m_semConsume;
-		Semaphore		m_semProduce;
-		Thread			m_appThread;
-		bool			m_runThread;
-		ThreadEntry		m_consumerFunc;
+		RWBuffer*				m_commandBuffers;
+		uint32_t				m_numBuffers;
+		uint32_t				m_produceIndex;
+		uint32_t				m_consumeIndex;
+		RWBuffer*				m_cmdBufferProduce;
+		RWBuffer*				m_cmdBufferConsume;
+		Semaphore				m_semFree;			// buffers producer can move on to
+		Semaphore				m_semFilled;		// finished frames, plus one post on shutdown
+		std::atomic<int32_t>	m_queueDepth;
+		uint32_t				m_maxQueueDepth;
+		uint32_t				m_numStalls;
+		uint64_t				m_stallClock;
+		uint64_t				m_lastStallClock;
+		Thread					m_appThread;
+		bool					m_runThread;
+		ThreadEntry				m_consumerFunc;
 
 	public:
-		CommandBuffer(uint32_t _bufferSize = 32*1024);
+		/// @param[in] _bufferSize : Initial size of each buffer
+		/// @param[in] _numBuffers : Number of buffers in the ring, 2 for double buffering
+		CommandBuffer(uint32_t _bufferSize = 32*1024, uint32_t _numBuffers = 2);
+
+		/// Command buffers grow by chaining pages from a pool.
+		///
+		/// @param[in] _pool       : Page pool, must outlive the command buffer
+		/// @param[in] _numBuffers : Number of buffers in the ring, 2 for double buffering
+		CommandBuffer(RWBufferPool* _pool, uint32_t _numBuffers = 2);
 		~CommandBuffer();
 
 		void init(ThreadEntry _consumerFunc);
+
+		/// Hands current buffer to the consumer, waits only if all other buffers are still queued.
 		void frame();
+
+		/// Hands last buffer to the consumer and waits for all frames to be consumed.
 		void shutDown();
 
+		/// Returns number of frames submitted but not yet consumed.
+		uint32_t getQueueDepth() const { return uint32_t(m_queueDepth.load(std::memory_order_relaxed)); }
+
+		/// Returns largest queue depth seen by frame().
+		uint32_t getMaxQueueDepth() const { return m_maxQueueDepth; }
+
+		/// Returns number of frame() calls that had to wait for the consumer.
+		uint32_t getNumStalls() const { return m_numStalls; }
+
+		/// Returns time frame() spent waiting for the consumer, in seconds.
+		float getStallTime() const { return cpuTime(m_stallClock, cpuFrequency()); }
+
+		/// Returns time the last frame() call spent waiting for the consumer, in seconds.
+		float getLastStallTime() const { return cpuTime(m_lastStallClock, cpuFrequency()); }
+
+		/// Resets stall and queue depth counters.
+		void resetCounters();
+
 		template <typename T>
 		void write(const T& _value)
 		{
 			m_cmdBufferProduce->write<T>(_value);
 		}
 
+		/// Reserves space for a command, can be called from several producer threads at once.
+		/// Must not be mixed with write in the same frame and all producers must be done before frame is called.
+		///
+		/// @param[in] _size : Command size in bytes
+		///
+		/// @returns pointer to write the command to.
+		uint8_t* reserve(uint32_t _size)
+		{
+			return m_cmdBufferProduce->reserve(_size);
+		}
+
+		/// Writes a command, can be called from several producer threads at once, see reserve.
+		template <typename T>
+		void submit(const T& _value)
+		{
+			memCopy(reserve(sizeof(T)), sizeof(T), &_value, sizeof(T));
+		}
+
 		template <typename T>
 		void read(T& _value)
 		{
@@ -148,6 +508,8 @@ namespace rtm {
 		}
 
 	private:
+		void initBuffers(uint32_t _numBuffers);
+
 		static int32_t consumerThread(void* _userData);
 	};
 
@@ -0,0 +1,191 @@
+//--------------------------------------------------------------------------//
+/// Copyright 2025 Milos Tosic. All Rights Reserved.                       ///
+/// License: http://www.opensource.org/licenses/BSD-2-Clause               ///
+//--------------------------------------------------------------------------//
+
+#ifndef RTM_RBASE_JOBS_H
+#define RTM_RBASE_JOBS_H
+
+#include <rbase/inc/platform.h>
+#include <rbase/inc/sem.h>
+#include <rbase/inc/thread.h>
+#include <atomic>
+#include <type_traits>
+
+namespace rtm {
+
+	/// Job entry point
+	typedef void (*JobFunction)(void* _userData);
+
+	//--------------------------------------------------------------------------
+	/// Counts unfinished jobs of a group, JobSystem::wait joins on it
+	//--------------------------------------------------------------------------
+	class JobCounter
+	{
+		friend class JobSystem;
+
+		std::atomic<int32_t>	m_count;
+
+	public:
+		inline JobCounter()
+			: m_count(0)
+		{
+		}
+
+		JobCounter(const JobCounter&) = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+
+		/// Returns true if all jobs associated with counter have finished.
+		inline bool isDone() const
+		{
+			return m_count.load(std::memory_order_acquire) == 0;
+		}
+	};
+
+	//--------------------------------------------------------------------------
+	/// Work stealing job system. Each worker owns a Chase-Lev deque, pushes and
+	/// pops jobs at its bottom while idle workers steal from the top of other
+	/// deques. Jobs submitted from threads outside of the system go through a
+	/// shared queue. Waiting on a counter executes other jobs instead of blocking.
+	//--------------------------------------------------------------------------
+	class JobSystem
+	{
+	public:
+		struct Job
+		{
+			JobFunction	m_function;
+			void*		m_userData;
+			JobCounter*	m_counter;
+		};
+
+		struct Worker;
+		struct InjectQueue;
+
+	private:
+		Worker*					m_workers;
+		Thread*					m_threads;
+		InjectQueue*			m_injectQueue;
+		Semaphore				m_wakeup;
+		std::atomic<int32_t>	m_numSleeping;
+		std::atomic<int32_t>	m_running;
+		uint32_t				m_numThreads;
+		uint32_t				m_tlsIndex;
+		bool					m_pinThreads;
+
+	public:
+		JobSystem();
+		~JobSystem();
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+		/// Starts worker threads, calling thread becomes worker 0.
+		///
+		/// @param[in] _numThreads : Total number of threads including calling one, 0 for number of hardware threads
+		/// @param[in] _pinThreads : Pin worker threads to hardware threads
+		///
+		/// @returns true on success.
+		bool init(uint32_t _numThreads = 0, bool _pinThreads = true);
+
+		/// Waits for worker threads to finish and releases resources, pending jobs are not executed.
+		void shutdown();
+
+		/// Returns number of threads executing jobs, including the thread that called init.
+		inline uint32_t getNumThreads() const { return m_numThreads; }
+
+		/// Schedules a job. Can be called from any thread, including from within jobs.
+		///
+		/// @param[in] _function   : Job function
+		/// @param[in] _userData   : User data passed to job function
+		/// @param[in] _counter    : Optional counter, incremented now and decremented when job finishes
+		void run(JobFunction _function, void* _userData, JobCounter* _counter = 0);
+
+		/// Waits for all jobs associated with counter to finish, executing other jobs meanwhile.
+		///
+		/// @param[in] _counter    : Counter to wait on
+		void wait(JobCounter* _counter);
+
+		/// Calls a function for sub ranges of [_begin, _end) in parallel and waits for completion.
+		///
+		/// @param[in] _begin      : First index
+		/// @param[in] _end        : One past last index
+		/// @param[in] _fn         : Function or lambda called as _fn(uint32_t _rangeBegin, uint32_t _rangeEnd), used in place
+		/// @param[in] _grainSize  : Number of indices per call, 0 to pick based on range and thread count
+		template <typename FN>
+		inline void parallelFor(uint32_t _begin, uint32_t _end, FN&& _fn, uint32_t _grainSize = 0);
+
+	private:
+		Worker*	getWorker() const;
+		bool	getJob(Worker* _worker, Job& _job);
+		void	execute(const Job& _job);
+		void	workerLoop(Worker* _worker);
+
+		static int32_t workerEntry(void* _userData);
+	};
+
+	namespace jobs_private {
+
+		/// Threads claim chunks of the range from a shared cursor, so uneven work balances itself.
+		template <typename FN>
+		struct ParallelFor
+		{
+			FN*						m_fn;
+			std::atomic<uint64_t>	m_next;
+			uint64_t				m_end;
+			uint32_t				m_grainSize;
+
+			static void run(void* _userData)
+			{
+				ParallelFor* pf = (ParallelFor*)_userData;
+				for (;;)
+				{
+					const uint64_t begin = pf->m_next.fetch_add(pf->m_grainSize, std::memory_order_relaxed);
+					if (begin >= pf->m_end)
+						break;
+
+					const uint64_t end = begin + pf->m_grainSize < pf->m_end ? begin + pf->m_grainSize : pf->m_end;
+					(*pf->m_fn)(uint32_t(begin), uint32_t(end));
+				}
+			}
+		};
+
+	} // namespace jobs_private
+
+	template <typename FN>
+	inline void JobSystem::parallelFor(uint32_t _begin, uint32_t _end, FN&& _fn, uint32_t _grainSize)
+	{
+		if (_begin >= _end)
+			return;
+
+		const uint32_t size = _end - _begin;
+
+		// several chunks per thread so faster threads pick up slack
+		if (_grainSize == 0)
+		{
+			_grainSize = size / (m_numThreads * 8);
+			_grainSize = _grainSize ? _grainSize : 1;
+		}
+
+		const uint32_t numChunks = (size + _grainSize - 1) / _grainSize;
+		const uint32_t numJobs = numChunks < m_numThreads ? numChunks - 1 : m_numThreads - 1;
+
+		// a temporary function object lives until parallelFor returns, so it is used in place
+		typedef jobs_private::ParallelFor<typename std::remove_reference<FN>::type> ParallelForType;
+
+		ParallelForType pf;
+		pf.m_fn			= &_fn;
+		pf.m_next.store(_begin, std::memory_order_relaxed);
+		pf.m_end		= _end;
+		pf.m_grainSize	= _grainSize;
+
+		JobCounter counter;
+		for (uint32_t i=0; i<numJobs; ++i)
+			run(ParallelForType::run, &pf, &counter);
+
+		ParallelForType::run(&pf);
+		wait(&counter);
+	}
+
+} // namespace rtm
+
+#endif // RTM_RBASE_JOBS_H
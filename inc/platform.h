@@ -212,6 +212,43 @@
 #define	RTM_32BIT 1
 #endif
 
+//--------------------------------------------------------------------------
+/// SIMD instruction sets available at compile time
+//--------------------------------------------------------------------------
+#define RTM_SIMD_SSE2			0
+#define RTM_SIMD_AVX2			0
+#define RTM_SIMD_NEON			0
+
+#if RTM_CPU_X86 && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)))
+#undef	RTM_SIMD_SSE2
+#define	RTM_SIMD_SSE2			1
+#endif
+
+#if RTM_SIMD_SSE2 && defined(__AVX2__)
+#undef	RTM_SIMD_AVX2
+#define	RTM_SIMD_AVX2			1
+#endif
+
+#if RTM_CPU_ARM && (defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64))
+#undef	RTM_SIMD_NEON
+#define	RTM_SIMD_NEON			1
+#endif
+
+//--------------------------------------------------------------------------
+/// Address sanitizer
+//--------------------------------------------------------------------------
+#define RTM_ADDRESS_SANITIZER	0
+
+#if defined(__SANITIZE_ADDRESS__)
+#undef	RTM_ADDRESS_SANITIZER
+#define	RTM_ADDRESS_SANITIZER	1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#undef	RTM_ADDRESS_SANITIZER
+#define	RTM_ADDRESS_SANITIZER	1
+#endif
+#endif
+
 //--------------------------------------------------------------------------
 /// Alignment macros
 //--------------------------------------------------------------------------
@@ -244,7 +281,7 @@
 #if RTM_COMPILER_MSVC
 #define RNOINLINE	__declspec(noinline)
 #elif RTM_COMPILER_GCC || RTM_COMPILER_CLANG || RTM_COMPILER_SNC
-#define RNOINLINE	__attribute__((no_inline))
+#define RNOINLINE	__attribute__((noinline))
 #else
 #error "Unsupported compiler!"
 #endif
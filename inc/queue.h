@@ -7,11 +7,28 @@
 #define RTM_RBASE_QUEUE_H
 
 #include <atomic>
-#include <math.h>
 #include <rbase/inc/libhandler.h>
+#include <rbase/inc/sem.h>
+#include <rbase/inc/cpu.h>
+#include <rbase/inc/spinlock.h>
+#include <rbase/inc/stringfn.h>
 
 namespace rtm {
 
+	namespace queue_private {
+
+		/// Returns milliseconds left of a timed wait, -1 for infinite wait.
+		static inline int32_t remainingMs(int32_t _ms, uint64_t _startClock)
+		{
+			if (_ms < 0)
+				return -1;
+
+			const uint64_t elapsed = (cpuClock() - _startClock) * 1000 / cpuFrequency();
+			return elapsed >= uint64_t(_ms) ? 0 : _ms - int32_t(elapsed);
+		}
+
+	} // namespace queue_private
+
 	// Taken from http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
 
 	template <typename T>
@@ -36,6 +53,8 @@ namespace rtm {
 		std::atomic<size_t>     m_dequeue_pos;
 		cacheline_pad_t         m_pad3;
 		size_t					m_bufferSize;
+		EventCount				m_notEmpty;
+		EventCount				m_notFull;
 
 		RTM_CLASS_NO_COPY(MpMcQueue);
 
@@ -109,6 +128,166 @@ namespace rtm {
 			return true;
 		}
 
+		/// Enqueues as many items as there is room for, claiming them with a single CAS.
+		///
+		/// @param[in] _data   : Items to enqueue
+		/// @param[in] _count  : Number of items
+		///
+		/// @returns number of items enqueued.
+		uint32_t enqueueBulk(T const* _data, uint32_t _count)
+		{
+			uint32_t count;
+			size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+			for (;;)
+			{
+				count = 0;
+				while (count < _count)
+				{
+					size_t seq = m_buffer[(pos + count) & m_buffer_mask].m_sequence.load(std::memory_order_acquire);
+					if (seq != pos + count)
+						break;
+					++count;
+				}
+
+				if (count == 0)
+				{
+					size_t seq = m_buffer[pos & m_buffer_mask].m_sequence.load(std::memory_order_acquire);
+					if ((intptr_t)seq - (intptr_t)pos < 0)
+						return 0;
+					pos = m_enqueue_pos.load(std::memory_order_relaxed);
+					continue;
+				}
+
+				if (m_enqueue_pos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed))
+					break;
+			}
+
+			for (uint32_t i=0; i<count; ++i)
+			{
+				cell_t* cell = &m_buffer[(pos + i) & m_buffer_mask];
+				cell->m_data = _data[i];
+				cell->m_sequence.store(pos + i + 1, std::memory_order_release);
+			}
+
+			if (count > 1)
+				m_notEmpty.notifyAll();
+			else
+				m_notEmpty.notify();
+			return count;
+		}
+
+		/// Dequeues up to given number of items, claiming them with a single CAS.
+		///
+		/// @param[out] _data  : Buffer receiving items
+		/// @param[in] _count  : Maximum number of items to dequeue
+		///
+		/// @returns number of items dequeued.
+		uint32_t dequeueBulk(T* _data, uint32_t _count)
+		{
+			uint32_t count;
+			size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+			for (;;)
+			{
+				count = 0;
+				while (count < _count)
+				{
+					size_t seq = m_buffer[(pos + count) & m_buffer_mask].m_sequence.load(std::memory_order_acquire);
+					if (seq != pos + count + 1)
+						break;
+					++count;
+				}
+
+				if (count == 0)
+				{
+					size_t seq = m_buffer[pos & m_buffer_mask].m_sequence.load(std::memory_order_acquire);
+					if ((intptr_t)seq - (intptr_t)(pos + 1) < 0)
+						return 0;
+					pos = m_dequeue_pos.load(std::memory_order_relaxed);
+					continue;
+				}
+
+				if (m_dequeue_pos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed))
+					break;
+			}
+
+			for (uint32_t i=0; i<count; ++i)
+			{
+				cell_t* cell = &m_buffer[(pos + i) & m_buffer_mask];
+				_data[i] = cell->m_data;
+				cell->m_sequence.store(pos + i + m_buffer_mask + 1, std::memory_order_release);
+			}
+
+			if (count > 1)
+				m_notFull.notifyAll();
+			else
+				m_notFull.notify();
+			return count;
+		}
+
+		/// Enqueues an item, waiting for room if the queue is full. Wakes a thread
+		/// blocked in pop, enqueue does not so it stays free of fences.
+		///
+		/// @param[in] _data   : Item to enqueue
+		/// @param[in] _ms     : Milliseconds to wait for, -1 to wait forever
+		///
+		/// @returns true if item was enqueued, false on timeout.
+		bool push(T const& _data, int32_t _ms = -1)
+		{
+			const uint64_t startClock = _ms > 0 ? cpuClock() : 0;
+			for (;;)
+			{
+				if (enqueue(_data))
+					break;
+
+				const int32_t ms = queue_private::remainingMs(_ms, startClock);
+				if (ms == 0)
+					return false;
+
+				m_notFull.prepareWait();
+				if (enqueue(_data))
+				{
+					m_notFull.cancelWait();
+					break;
+				}
+				m_notFull.commitWait(ms);
+			}
+
+			m_notEmpty.notify();
+			return true;
+		}
+
+		/// Dequeues an item, waiting for one if the queue is empty. Wakes a thread
+		/// blocked in push, dequeue does not so it stays free of fences.
+		///
+		/// @param[out] _data  : Dequeued item
+		/// @param[in] _ms     : Milliseconds to wait for, -1 to wait forever
+		///
+		/// @returns true if item was dequeued, false on timeout.
+		bool pop(T& _data, int32_t _ms = -1)
+		{
+			const uint64_t startClock = _ms > 0 ? cpuClock() : 0;
+			for (;;)
+			{
+				if (dequeue(_data))
+					break;
+
+				const int32_t ms = queue_private::remainingMs(_ms, startClock);
+				if (ms == 0)
+					return false;
+
+				m_notEmpty.prepareWait();
+				if (dequeue(_data))
+				{
+					m_notEmpty.cancelWait();
+					break;
+				}
+				m_notEmpty.commitWait(ms);
+			}
+
+			m_notFull.notify();
+			return true;
+		}
+
 		template <typename U>
 		bool enqueue(U const& data)
 		{
@@ -136,33 +315,58 @@ namespace rtm {
 		}
 	};
 
+	//--------------------------------------------------------------------------
+	/// Bounded single producer single consumer ring. Producer and consumer
+	/// indices live on separate cache lines and each side keeps a cached copy
+	/// of the other side's index, refreshed only when the ring looks full or
+	/// empty. writeN/readN move a batch and publish it with a single store.
+	/// Only the blocking push and pop wake each other, other operations stay
+	/// free of fences.
+	//--------------------------------------------------------------------------
 	template <class T = uintptr_t>
 	class SpScQueue
 	{
-		T*					m_buffer;
-		std::atomic<int>	m_read;
-		std::atomic<int>	m_write;
-		int					m_capacity;
-		int					m_size;
-		int					m_size_mask;
+		static size_t const     cacheline_size = 64;
+		typedef char            cacheline_pad_t[cacheline_size];
+
+		// indices are free running, masked on buffer access
+		cacheline_pad_t			m_pad0;
+		std::atomic<uint32_t>	m_write;
+		uint32_t				m_readCached;		// producer's view of m_read
+		cacheline_pad_t			m_pad1;
+		std::atomic<uint32_t>	m_read;
+		uint32_t				m_writeCached;		// consumer's view of m_write
+		cacheline_pad_t			m_pad2;
+		T*						m_buffer;
+		uint32_t				m_capacity;
+		uint32_t				m_size;
+		uint32_t				m_size_mask;
+		EventCount				m_notEmpty;
+		EventCount				m_notFull;
 
 		RTM_CLASS_NO_COPY(SpScQueue);
 
 	public:
 		SpScQueue(int _capacity)
-			: m_read(0)
-			, m_write(0)
-			, m_capacity(_capacity)
+			: m_write(0)
+			, m_readCached(0)
+			, m_read(0)
+			, m_writeCached(0)
+			, m_capacity(uint32_t(_capacity))
 		{
-			int power = (int)floor(log(_capacity)/log(2)) + 1;
-			m_size		= 1 << power;
+			RTM_ASSERT(_capacity > 0, "Invalid capacity!");
+
+			m_size = 1;
+			while (m_size < m_capacity)
+				m_size <<= 1;
+
 			m_size_mask	= m_size - 1;
-			m_buffer	= new T[m_size];
+			m_buffer	= rtm_new_array<T>(m_size);
 		}
 
 		~SpScQueue()
 		{
-			delete[] m_buffer;
+			rtm_delete_array<T>(m_size, m_buffer);
 		}
 
 		bool write(const T& _item);
@@ -170,6 +374,40 @@ namespace rtm {
 		bool peek(T* _item);
 		void reset();
 
+		/// Writes as many items as there is room for, publishing them at once. Producer side only.
+		///
+		/// @param[in] _items  : Items to write
+		/// @param[in] _count  : Number of items
+		///
+		/// @returns number of items written.
+		uint32_t writeN(const T* _items, uint32_t _count);
+
+		/// Reads up to given number of items, releasing their slots at once. Consumer side only.
+		///
+		/// @param[out] _items : Buffer receiving items
+		/// @param[in] _count  : Maximum number of items to read
+		///
+		/// @returns number of items read.
+		uint32_t readN(T* _items, uint32_t _count);
+
+		/// Writes an item, waiting for room if the queue is full. Wakes the consumer
+		/// blocked in pop, write does not so it stays free of fences.
+		///
+		/// @param[in] _item   : Item to write
+		/// @param[in] _ms     : Milliseconds to wait for, -1 to wait forever
+		///
+		/// @returns true if item was written, false on timeout.
+		bool push(const T& _item, int32_t _ms = -1);
+
+		/// Reads an item, waiting for one if the queue is empty. Wakes the producer
+		/// blocked in push, read does not so it stays free of fences.
+		///
+		/// @param[out] _item  : Item read
+		/// @param[in] _ms     : Milliseconds to wait for, -1 to wait forever
+		///
+		/// @returns true if item was read, false on timeout.
+		bool pop(T* _item, int32_t _ms = -1);
+
 		template <typename U>
 		bool write(U const& data)
 		{
@@ -192,54 +430,684 @@ namespace rtm {
 			}
 			return false;
 		}
+
+	private:
+		/// Returns number of free slots, refreshing cached read index only when needed.
+		inline uint32_t writeSpace(uint32_t _write, uint32_t _needed)
+		{
+			uint32_t space = m_capacity - (_write - m_readCached);
+			if (space < _needed)
+			{
+				m_readCached	= m_read.load(std::memory_order_acquire);
+				space			= m_capacity - (_write - m_readCached);
+			}
+			return space;
+		}
+
+		/// Returns number of readable items, refreshing cached write index only when needed.
+		inline uint32_t readSpace(uint32_t _read, uint32_t _needed)
+		{
+			uint32_t available = m_writeCached - _read;
+			if (available < _needed)
+			{
+				m_writeCached	= m_write.load(std::memory_order_acquire);
+				available		= m_writeCached - _read;
+			}
+			return available;
+		}
 	};
 
 	template <class T>
 	bool SpScQueue<T>::write(const T& _item)
 	{
-		const int w = m_write.load(std::memory_order_relaxed);
-		const int r = m_read.load(std::memory_order_acquire);
-		const int nitems = w - r;
-		if (nitems == m_capacity || nitems + m_size == m_capacity)
+		const uint32_t w = m_write.load(std::memory_order_relaxed);
+		if (writeSpace(w, 1) == 0)
 			return false;
 
-		m_buffer[w] = _item;
-		m_write.store((w+1) & m_size_mask, std::memory_order_release);
+		m_buffer[w & m_size_mask] = _item;
+		m_write.store(w + 1, std::memory_order_release);
 		return true;
 	}
 
 	template <class T>
 	bool SpScQueue<T>::read(T* _item)
 	{
-		const int r = m_read.load(std::memory_order_relaxed);
-		const int w = m_write.load(std::memory_order_acquire);
-		if (r == w)
+		const uint32_t r = m_read.load(std::memory_order_relaxed);
+		if (readSpace(r, 1) == 0)
 			return false;
 
-		*_item = m_buffer[r];
-		m_read.store((r+1) & m_size_mask, std::memory_order_release);
+		*_item = m_buffer[r & m_size_mask];
+		m_read.store(r + 1, std::memory_order_release);
 		return true;
 	}
 
 	template <class T>
 	bool SpScQueue<T>::peek(T* _item)
 	{
-		const int r = m_read.load(std::memory_order_relaxed);
-		const int w = m_write.load(std::memory_order_acquire);
-		if (r == w)
+		const uint32_t r = m_read.load(std::memory_order_relaxed);
+		if (readSpace(r, 1) == 0)
 			return false;
 
-		*_item = m_buffer[r];
+		*_item = m_buffer[r & m_size_mask];
 		return true;
 	}
 
 	template <class T>
 	void SpScQueue<T>::reset()
 	{
-		m_read	= 0;
-		m_write	= 0;
+		m_read			= 0;
+		m_write			= 0;
+		m_readCached	= 0;
+		m_writeCached	= 0;
+	}
+
+	template <class T>
+	uint32_t SpScQueue<T>::writeN(const T* _items, uint32_t _count)
+	{
+		const uint32_t w		= m_write.load(std::memory_order_relaxed);
+		const uint32_t space	= writeSpace(w, _count);
+		const uint32_t count	= _count < space ? _count : space;
+		if (count == 0)
+			return 0;
+
+		for (uint32_t i=0; i<count; ++i)
+			m_buffer[(w + i) & m_size_mask] = _items[i];
+
+		m_write.store(w + count, std::memory_order_release);
+		return count;
+	}
+
+	template <class T>
+	uint32_t SpScQueue<T>::readN(T* _items, uint32_t _count)
+	{
+		const uint32_t r			= m_read.load(std::memory_order_relaxed);
+		const uint32_t available	= readSpace(r, _count);
+		const uint32_t count		= _count < available ? _count : available;
+		if (count == 0)
+			return 0;
+
+		for (uint32_t i=0; i<count; ++i)
+			_items[i] = m_buffer[(r + i) & m_size_mask];
+
+		m_read.store(r + count, std::memory_order_release);
+		return count;
+	}
+
+	template <class T>
+	bool SpScQueue<T>::push(const T& _item, int32_t _ms)
+	{
+		const uint64_t startClock = _ms > 0 ? cpuClock() : 0;
+		for (;;)
+		{
+			if (write(_item))
+				break;
+
+			const int32_t ms = queue_private::remainingMs(_ms, startClock);
+			if (ms == 0)
+				return false;
+
+			m_notFull.prepareWait();
+			if (write(_item))
+			{
+				m_notFull.cancelWait();
+				break;
+			}
+			m_notFull.commitWait(ms);
+		}
+
+		m_notEmpty.notify();
+		return true;
 	}
 
+	template <class T>
+	bool SpScQueue<T>::pop(T* _item, int32_t _ms)
+	{
+		const uint64_t startClock = _ms > 0 ? cpuClock() : 0;
+		for (;;)
+		{
+			if (read(_item))
+				break;
+
+			const int32_t ms = queue_private::remainingMs(_ms, startClock);
+			if (ms == 0)
+				return false;
+
+			m_notEmpty.prepareWait();
+			if (read(_item))
+			{
+				m_notEmpty.cancelWait();
+				break;
+			}
+			m_notEmpty.commitWait(ms);
+		}
+
+		m_notFull.notify();
+		return true;
+	}
+
+	//--------------------------------------------------------------------------
+	/// Single producer single consumer ring of variable size records. Producer
+	/// reserves space, writes the record in place and commits it, consumer
+	/// peeks at the oldest record and releases it when done. Records never
+	/// straddle the end of the buffer, a padding record fills the tail instead.
+	//--------------------------------------------------------------------------
+	class SpScByteQueue
+	{
+		static size_t const     cacheline_size = 64;
+		typedef char            cacheline_pad_t[cacheline_size];
+
+		static uint32_t const	record_align	= 8;
+		static uint32_t const	header_size		= 8;			// payload size, keeps payload 8 byte aligned
+		static uint32_t const	padding_record	= 0xffffffff;
+
+		cacheline_pad_t			m_pad0;
+		std::atomic<uint32_t>	m_write;
+		uint32_t				m_readCached;		// producer's view of m_read
+		uint32_t				m_reservePos;		// write position of reserved record header
+		uint32_t				m_reserveEnd;		// write position after reserved record
+		bool					m_reserved;
+		cacheline_pad_t			m_pad1;
+		std::atomic<uint32_t>	m_read;
+		uint32_t				m_writeCached;		// consumer's view of m_write
+		uint32_t				m_peekEnd;			// read position after peeked record
+		bool					m_peeked;
+		cacheline_pad_t			m_pad2;
+		uint8_t*				m_buffer;
+		uint32_t				m_size;
+		uint32_t				m_size_mask;
+
+		RTM_CLASS_NO_COPY(SpScByteQueue);
+
+	public:
+		/// @param[in] _size   : Buffer size in bytes, rounded up to a power of 2
+		SpScByteQueue(uint32_t _size)
+			: m_write(0)
+			, m_readCached(0)
+			, m_reservePos(0)
+			, m_reserveEnd(0)
+			, m_reserved(false)
+			, m_read(0)
+			, m_writeCached(0)
+			, m_peekEnd(0)
+			, m_peeked(false)
+		{
+			m_size = 64;
+			while (m_size < _size)
+				m_size <<= 1;
+
+			m_size_mask	= m_size - 1;
+			m_buffer	= (uint8_t*)RBASE_NAMESPACE::rtm_alloc(m_size, cacheline_size);
+		}
+
+		~SpScByteQueue()
+		{
+			RBASE_NAMESPACE::rtm_free(m_buffer, cacheline_size);
+		}
+
+		/// Returns largest record size that can always be reserved once consumer catches up.
+		uint32_t maxRecordSize() const
+		{
+			return m_size / 2 - header_size;
+		}
+
+		/// Reserves space for a record. Producer side only.
+		///
+		/// @param[in] _size   : Record size in bytes, at most maxRecordSize
+		///
+		/// @returns pointer to 8 byte aligned space to write the record to, 0 if there is not enough room.
+		void* reserve(uint32_t _size)
+		{
+			RTM_ASSERT(!m_reserved, "Previous record was not committed!");
+			RTM_ASSERT(_size <= maxRecordSize(), "Record too large!");
+
+			const uint32_t w			= m_write.load(std::memory_order_relaxed);
+			const uint32_t record		= recordSize(_size);
+			const uint32_t contiguous	= m_size - (w & m_size_mask);
+			const uint32_t needed		= record > contiguous ? contiguous + record : record;
+
+			if (m_size - (w - m_readCached) < needed)
+			{
+				m_readCached = m_read.load(std::memory_order_acquire);
+				if (m_size - (w - m_readCached) < needed)
+					return 0;
+			}
+
+			uint32_t pos = w;
+			if (record > contiguous)
+			{
+				// consumer skips the rest of the buffer
+				*(uint32_t*)&m_buffer[pos & m_size_mask] = padding_record;
+				pos += contiguous;
+			}
+
+			*(uint32_t*)&m_buffer[pos & m_size_mask] = _size;
+			m_reservePos	= pos;
+			m_reserveEnd	= pos + record;
+			m_reserved		= true;
+			return &m_buffer[(pos & m_size_mask) + header_size];
+		}
+
+		/// Publishes the reserved record to the consumer.
+		void commit()
+		{
+			RTM_ASSERT(m_reserved, "Nothing reserved!");
+			m_write.store(m_reserveEnd, std::memory_order_release);
+			m_reserved = false;
+		}
+
+		/// Publishes the reserved record, shrunk to the number of bytes actually written.
+		///
+		/// @param[in] _size   : Record size in bytes, not larger than the reserved size
+		void commit(uint32_t _size)
+		{
+			RTM_ASSERT(m_reserved, "Nothing reserved!");
+			uint32_t* header = (uint32_t*)&m_buffer[m_reservePos & m_size_mask];
+			RTM_ASSERT(_size <= *header, "Committed size larger than reserved!");
+
+			*header			= _size;
+			m_reserveEnd	= m_reservePos + recordSize(_size);
+			commit();
+		}
+
+		/// Reserves, copies and commits a record.
+		///
+		/// @param[in] _data   : Record data
+		/// @param[in] _size   : Record size in bytes
+		///
+		/// @returns true if record was written, false if there is not enough room.
+		bool write(const void* _data, uint32_t _size)
+		{
+			void* dst = reserve(_size);
+			if (!dst)
+				return false;
+			memCopy(dst, _size, _data, _size);
+			commit();
+			return true;
+		}
+
+		/// Returns oldest record without removing it. Consumer side only.
+		///
+		/// @param[out] _size  : Record size in bytes
+		///
+		/// @returns pointer to the record, valid until release, or 0 if the queue is empty.
+		const void* peek(uint32_t* _size)
+		{
+			uint32_t r = m_read.load(std::memory_order_relaxed);
+
+			for (;;)
+			{
+				if (r == m_writeCached)
+				{
+					m_writeCached = m_write.load(std::memory_order_acquire);
+					if (r == m_writeCached)
+						return 0;
+				}
+
+				const uint32_t size = *(const uint32_t*)&m_buffer[r & m_size_mask];
+				if (size != padding_record)
+				{
+					m_peekEnd	= r + recordSize(size);
+					m_peeked	= true;
+					*_size		= size;
+					return &m_buffer[(r & m_size_mask) + header_size];
+				}
+
+				r += m_size - (r & m_size_mask);
+			}
+		}
+
+		/// Removes the record returned by the last peek, its memory can be overwritten afterwards.
+		void release()
+		{
+			RTM_ASSERT(m_peeked, "Nothing peeked!");
+			m_read.store(m_peekEnd, std::memory_order_release);
+			m_peeked = false;
+		}
+
+	private:
+		static inline uint32_t recordSize(uint32_t _size)
+		{
+			return (header_size + _size + record_align - 1) & ~(record_align - 1);
+		}
+	};
+
+	//--------------------------------------------------------------------------
+	/// Intrusive unbounded multi producer single consumer queue, taken from
+	/// http://www.1024cores.net/home/lock-free-algorithms/queues/intrusive-mpsc-node-based-queue
+	/// Queued types derive from MpScQueueNode, the queue does not own them.
+	/// Push is wait free, pop can return 0 while a producer is between its two
+	/// stores even though the queue is not empty.
+	//--------------------------------------------------------------------------
+	struct MpScQueueNode
+	{
+		std::atomic<MpScQueueNode*>	m_next;
+	};
+
+	template <typename T>
+	class MpScQueue
+	{
+		static size_t const     cacheline_size = 64;
+		typedef char            cacheline_pad_t[cacheline_size];
+
+		std::atomic<MpScQueueNode*>	m_head;
+		cacheline_pad_t				m_pad0;
+		MpScQueueNode*				m_tail;
+		MpScQueueNode				m_stub;
+
+		RTM_CLASS_NO_COPY(MpScQueue);
+
+	public:
+		MpScQueue()
+			: m_head(&m_stub)
+			, m_tail(&m_stub)
+		{
+			m_stub.m_next.store(0, std::memory_order_relaxed);
+		}
+
+		/// Adds a node to the queue, can be called from any thread.
+		///
+		/// @param[in] _node   : Node to add, must not be in a queue already
+		void push(T* _node)
+		{
+			push(static_cast<MpScQueueNode*>(_node));
+		}
+
+		/// Removes a node from the queue, only one thread may call this at a time.
+		///
+		/// @returns node or 0 if the queue is empty.
+		T* pop()
+		{
+			MpScQueueNode* tail = m_tail;
+			MpScQueueNode* next = tail->m_next.load(std::memory_order_acquire);
+
+			if (tail == &m_stub)
+			{
+				if (!next)
+					return 0;
+				m_tail	= next;
+				tail	= next;
+				next	= next->m_next.load(std::memory_order_acquire);
+			}
+
+			if (next)
+			{
+				m_tail = next;
+				return static_cast<T*>(tail);
+			}
+
+			// producer has swapped head but not linked the node yet
+			if (tail != m_head.load(std::memory_order_acquire))
+				return 0;
+
+			// tail is the last node, put stub behind it so it can be unlinked
+			push(&m_stub);
+			next = tail->m_next.load(std::memory_order_acquire);
+			if (next)
+			{
+				m_tail = next;
+				return static_cast<T*>(tail);
+			}
+
+			return 0;
+		}
+
+		/// Returns true if queue looks empty, exact only on the consumer thread with no producers active.
+		bool isEmpty() const
+		{
+			return (m_tail == &m_stub) && (m_stub.m_next.load(std::memory_order_acquire) == 0);
+		}
+
+	private:
+		void push(MpScQueueNode* _node)
+		{
+			_node->m_next.store(0, std::memory_order_relaxed);
+			MpScQueueNode* prev = m_head.exchange(_node, std::memory_order_acq_rel);
+			prev->m_next.store(_node, std::memory_order_release);
+		}
+	};
+
+	//--------------------------------------------------------------------------
+	/// Unbounded multi producer multi consumer queue. Items are stored in a
+	/// linked list of fixed size segments, producers claim slots with a single
+	/// atomic increment and consumers claim ready slots with a CAS. Consumed
+	/// segments go to a free list once no thread references them, so steady
+	/// state traffic does not allocate. Like MpMcQueue, dequeue can return false
+	/// while a producer that claimed the next slot is still writing it.
+	//--------------------------------------------------------------------------
+	template <typename T, uint32_t SEGMENT_SIZE = 256>
+	class MpMcQueueUnbounded
+	{
+		static size_t const     cacheline_size = 64;
+		typedef char            cacheline_pad_t[cacheline_size];
+
+		// set in reference count once segment is unlinked, whoever drops it to exactly this value recycles the segment
+		static uint32_t const	retired_flag = 0x80000000;
+
+		struct slot_t
+		{
+			std::atomic<uint32_t>	m_ready;
+			T						m_data;
+		};
+
+		struct segment_t
+		{
+			std::atomic<uint32_t>	m_enqueue_pos;
+			cacheline_pad_t			m_pad0;
+			std::atomic<uint32_t>	m_dequeue_pos;
+			cacheline_pad_t			m_pad1;
+			std::atomic<segment_t*>	m_next;
+			std::atomic<uint32_t>	m_refs;
+			segment_t*				m_nextFree;
+			slot_t					m_slots[SEGMENT_SIZE];
+		};
+
+		cacheline_pad_t				m_pad0;
+		std::atomic<segment_t*>		m_head;
+		cacheline_pad_t				m_pad1;
+		std::atomic<segment_t*>		m_tail;
+		cacheline_pad_t				m_pad2;
+		SpinLock					m_freeLock;
+		segment_t*					m_freeList;
+
+		RTM_CLASS_NO_COPY(MpMcQueueUnbounded);
+
+	public:
+		MpMcQueueUnbounded()
+			: m_freeList(0)
+		{
+			RTM_STATIC_ASSERT(SEGMENT_SIZE >= 2, "Segment too small!");
+
+			segment_t* segment = allocSegment();
+			m_head.store(segment, std::memory_order_relaxed);
+			m_tail.store(segment, std::memory_order_relaxed);
+		}
+
+		~MpMcQueueUnbounded()
+		{
+			segment_t* segment = m_head.load(std::memory_order_relaxed);
+			while (segment)
+			{
+				segment_t* next = segment->m_next.load(std::memory_order_relaxed);
+				rtm_delete<segment_t>(segment);
+				segment = next;
+			}
+
+			while (m_freeList)
+			{
+				segment_t* next = m_freeList->m_nextFree;
+				rtm_delete<segment_t>(m_freeList);
+				m_freeList = next;
+			}
+		}
+
+		/// Enqueues an item, never fails.
+		///
+		/// @param[in] _data   : Item to enqueue
+		void enqueue(T const& _data)
+		{
+			for (;;)
+			{
+				segment_t* segment = pin(m_tail);
+
+				const uint32_t pos = segment->m_enqueue_pos.fetch_add(1, std::memory_order_relaxed);
+				if (pos < SEGMENT_SIZE)
+				{
+					slot_t& slot = segment->m_slots[pos];
+					slot.m_data = _data;
+					slot.m_ready.store(1, std::memory_order_release);
+					unpin(segment);
+					return;
+				}
+
+				// segment is full, link a new one with the item already in place
+				segment_t* next = segment->m_next.load(std::memory_order_acquire);
+				if (!next)
+				{
+					segment_t* newSegment = allocSegment();
+					newSegment->m_enqueue_pos.store(1, std::memory_order_relaxed);
+					newSegment->m_slots[0].m_data = _data;
+					newSegment->m_slots[0].m_ready.store(1, std::memory_order_relaxed);
+
+					if (segment->m_next.compare_exchange_strong(next, newSegment, std::memory_order_seq_cst))
+					{
+						segment_t* tail = segment;
+						m_tail.compare_exchange_strong(tail, newSegment, std::memory_order_seq_cst);
+						unpin(segment);
+						return;
+					}
+
+					// never published, no other thread can see it
+					freeSegment(newSegment);
+				}
+
+				segment_t* tail = segment;
+				m_tail.compare_exchange_strong(tail, next, std::memory_order_seq_cst);
+				unpin(segment);
+			}
+		}
+
+		/// Dequeues an item.
+		///
+		/// @param[out] _data  : Dequeued item
+		///
+		/// @returns true if an item was dequeued, false if queue is empty.
+		bool dequeue(T& _data)
+		{
+			for (;;)
+			{
+				segment_t* segment = pin(m_head);
+
+				uint32_t pos = segment->m_dequeue_pos.load(std::memory_order_acquire);
+				if (pos < SEGMENT_SIZE)
+				{
+					slot_t& slot = segment->m_slots[pos];
+					if (!slot.m_ready.load(std::memory_order_acquire))
+					{
+						unpin(segment);
+						return false;
+					}
+
+					const bool claimed = segment->m_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed);
+					if (claimed)
+						_data = slot.m_data;
+
+					unpin(segment);
+					if (claimed)
+						return true;
+					continue;
+				}
+
+				// segment consumed, move head past it
+				segment_t* next = segment->m_next.load(std::memory_order_acquire);
+				if (!next)
+				{
+					unpin(segment);
+					return false;
+				}
+
+				// tail must not point to a segment that can be recycled
+				segment_t* tail = segment;
+				m_tail.compare_exchange_strong(tail, next, std::memory_order_seq_cst);
+
+				segment_t* head = segment;
+				if (m_head.compare_exchange_strong(head, next, std::memory_order_seq_cst))
+				{
+					unpin(segment);
+					retire(segment);
+				}
+				else
+					unpin(segment);
+			}
+		}
+
+	private:
+		/// Takes a reference to the segment pointed to, validating it is still current after the reference is taken.
+		segment_t* pin(std::atomic<segment_t*>& _pointer)
+		{
+			for (;;)
+			{
+				segment_t* segment = _pointer.load(std::memory_order_seq_cst);
+				segment->m_refs.fetch_add(1, std::memory_order_seq_cst);
+				if (_pointer.load(std::memory_order_seq_cst) == segment)
+					return segment;
+				unpin(segment);
+			}
+		}
+
+		void unpin(segment_t* _segment)
+		{
+			if (_segment->m_refs.fetch_sub(1, std::memory_order_seq_cst) == retired_flag + 1)
+				recycle(_segment);
+		}
+
+		void retire(segment_t* _segment)
+		{
+			if (_segment->m_refs.fetch_add(retired_flag, std::memory_order_seq_cst) == 0)
+				recycle(_segment);
+		}
+
+		void recycle(segment_t* _segment)
+		{
+			// references are never reset, a late pin of a free segment only bumps them and fails validation
+			uint32_t refs = retired_flag;
+			if (_segment->m_refs.compare_exchange_strong(refs, 0, std::memory_order_seq_cst))
+				freeSegment(_segment);
+		}
+
+		segment_t* allocSegment()
+		{
+			segment_t* segment = 0;
+			{
+				SpinLockScope lock(m_freeLock);
+				if (m_freeList)
+				{
+					segment		= m_freeList;
+					m_freeList	= segment->m_nextFree;
+				}
+			}
+
+			if (!segment)
+			{
+				segment = rtm_new<segment_t>();
+				segment->m_refs.store(0, std::memory_order_relaxed);
+			}
+
+			segment->m_enqueue_pos.store(0, std::memory_order_relaxed);
+			segment->m_dequeue_pos.store(0, std::memory_order_relaxed);
+			segment->m_next.store(0, std::memory_order_relaxed);
+			for (uint32_t i=0; i<SEGMENT_SIZE; ++i)
+				segment->m_slots[i].m_ready.store(0, std::memory_order_relaxed);
+			return segment;
+		}
+
+		void freeSegment(segment_t* _segment)
+		{
+			SpinLockScope lock(m_freeLock);
+			_segment->m_nextFree	= m_freeList;
+			m_freeList				= _segment;
+		}
+	};
+
 } // namespace rtm
 
 #endif // RTM_RBASE_QUEUE_H
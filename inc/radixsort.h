@@ -9,9 +9,13 @@
 #define RTM_RBASE_RADIXSORT_H
 
 #include <rbase/inc/platform.h>
+#include <rbase/inc/stringfn.h>
+#include <rbase/inc/jobs.h>
 
 namespace rtm {
 
+	class StringView;
+
 	constexpr uint32_t RTM_RADIXSORT_BITS			= 11;
 	constexpr uint32_t RTM_RADIXSORT_HISTOGRAM_SIZE = (1 << RTM_RADIXSORT_BITS);
 	constexpr uint32_t RTM_RADIXSORT_BIT_MASK		= (RTM_RADIXSORT_HISTOGRAM_SIZE - 1);
@@ -22,6 +26,8 @@ namespace rtm {
 	/// @param[in] _tempKeys	: Temporary buffer for key sorting
 	/// @param[in] _size		: Number of values to sort
 	void sortRadix(uint32_t* _keys, uint32_t* _tempKeys, uint32_t _size);
+	void sortRadix(int32_t* _keys, int32_t* _tempKeys, uint32_t _size);
+	void sortRadix(float* _keys, float* _tempKeys, uint32_t _size);
 
 	/// Sorts an array using radix sort
 	///
@@ -29,115 +35,818 @@ namespace rtm {
 	/// @param[in] _tempKeys	: Temporary buffer for key sorting
 	/// @param[in] _size		: Number of values to sort
 	void sortRadix64(uint64_t* _keys, uint64_t* _tempKeys, uint32_t _size);
+	void sortRadix64(int64_t* _keys, int64_t* _tempKeys, uint32_t _size);
+	void sortRadix64(double* _keys, double* _tempKeys, uint32_t _size);
 
-	/// Sorts a value array using radix sort
+	/// Sorts a value array using radix sort, keys can be uint32_t, int32_t or float
 	///
 	/// @param[in,out] _keys	: Keys for sorting
 	/// @param[in] _tempKeys	: Temporary buffer for key sorting
 	/// @param[in,out] _values	: Values to sort
 	/// @param[in] _tempValues	: Temporary buffer for values
 	/// @param[in] _size		: Number of values to sort
-	template <typename Ty>
-	static inline void sortRadix(uint32_t* _keys, uint32_t* _tempKeys, Ty* _values, Ty* _tempValues, uint32_t _size)
+	template <typename Key, typename Ty>
+	static inline void sortRadix(Key* _keys, Key* _tempKeys, Ty* _values, Ty* _tempValues, uint32_t _size);
+
+	/// Sorts a value array using radix sort, keys can be uint64_t, int64_t or double
+	///
+	/// @param[in,out] _keys	: Keys for sorting
+	/// @param[out] _tempKeys	: Temporary buffer for key sorting
+	/// @param[in] _values		: Values to sort
+	/// @param[in] _tempValues	: Temporary buffer for values
+	/// @param[in] _size		: Number of values to sort
+	template <typename Key, typename Ty>
+	static inline void sortRadix64(Key* _keys, Key* _tempKeys, Ty* _values, Ty* _tempValues, uint32_t _size);
+
+	/// Sorts an array using radix sort on multiple threads, result is the same as with sortRadix
+	/// Threads come from a shared pool started by the first parallel sort.
+	///
+	/// @param[in,out] _keys	: Keys for sorting
+	/// @param[in] _tempKeys	: Temporary buffer for key sorting
+	/// @param[in] _size		: Number of values to sort
+	/// @param[in] _numThreads	: Maximum number of threads to use, including calling thread
+	void sortRadixParallel(uint32_t* _keys, uint32_t* _tempKeys, uint32_t _size, uint32_t _numThreads);
+	void sortRadixParallel(int32_t* _keys, int32_t* _tempKeys, uint32_t _size, uint32_t _numThreads);
+	void sortRadixParallel(float* _keys, float* _tempKeys, uint32_t _size, uint32_t _numThreads);
+
+	/// Sorts an array using radix sort on job system threads, result is the same as with sortRadix.
+	/// Use instead of the variant taking thread count when sorting often, no threads are created.
+	///
+	/// @param[in,out] _keys	: Keys for sorting
+	/// @param[in] _tempKeys	: Temporary buffer for key sorting
+	/// @param[in] _size		: Number of values to sort
+	/// @param[in] _jobs		: Initialized job system, calling thread helps executing jobs
+	void sortRadixParallel(uint32_t* _keys, uint32_t* _tempKeys, uint32_t _size, JobSystem* _jobs);
+	void sortRadixParallel(int32_t* _keys, int32_t* _tempKeys, uint32_t _size, JobSystem* _jobs);
+	void sortRadixParallel(float* _keys, float* _tempKeys, uint32_t _size, JobSystem* _jobs);
+
+	/// Sorts an array using radix sort on multiple threads, result is the same as with sortRadix64
+	/// Threads come from a shared pool started by the first parallel sort.
+	///
+	/// @param[in,out] _keys	: Keys for sorting
+	/// @param[in] _tempKeys	: Temporary buffer for key sorting
+	/// @param[in] _size		: Number of values to sort
+	/// @param[in] _numThreads	: Maximum number of threads to use, including calling thread
+	void sortRadix64Parallel(uint64_t* _keys, uint64_t* _tempKeys, uint32_t _size, uint32_t _numThreads);
+	void sortRadix64Parallel(int64_t* _keys, int64_t* _tempKeys, uint32_t _size, uint32_t _numThreads);
+	void sortRadix64Parallel(double* _keys, double* _tempKeys, uint32_t _size, uint32_t _numThreads);
+
+	/// Sorts an array using radix sort on job system threads, result is the same as with sortRadix64
+	///
+	/// @param[in,out] _keys	: Keys for sorting
+	/// @param[in] _tempKeys	: Temporary buffer for key sorting
+	/// @param[in] _size		: Number of values to sort
+	/// @param[in] _jobs		: Initialized job system, calling thread helps executing jobs
+	void sortRadix64Parallel(uint64_t* _keys, uint64_t* _tempKeys, uint32_t _size, JobSystem* _jobs);
+	void sortRadix64Parallel(int64_t* _keys, int64_t* _tempKeys, uint32_t _size, JobSystem* _jobs);
+	void sortRadix64Parallel(double* _keys, double* _tempKeys, uint32_t _size, JobSystem* _jobs);
+
+	/// Sorts a value array using radix sort on multiple threads, keys can be uint32_t, int32_t or float
+	/// Threads come from a shared pool started by the first parallel sort.
+	///
+	/// @param[in,out] _keys	: Keys for sorting
+	/// @param[in] _tempKeys	: Temporary buffer for key sorting
+	/// @param[in,out] _values	: Values to sort
+	/// @param[in] _tempValues	: Temporary buffer for values
+	/// @param[in] _size		: Number of values to sort
+	/// @param[in] _numThreads	: Maximum number of threads to use, including calling thread
+	template <typename Key, typename Ty>
+	static inline void sortRadixParallel(Key* _keys, Key* _tempKeys, Ty* _values, Ty* _tempValues, uint32_t _size, uint32_t _numThreads);
+
+	/// Sorts a value array using radix sort on multiple threads, keys can be uint64_t, int64_t or double
+	/// Threads come from a shared pool started by the first parallel sort.
+	///
+	/// @param[in,out] _keys	: Keys for sorting
+	/// @param[in] _tempKeys	: Temporary buffer for key sorting
+	/// @param[in,out] _values	: Values to sort
+	/// @param[in] _tempValues	: Temporary buffer for values
+	/// @param[in] _size		: Number of values to sort
+	/// @param[in] _numThreads	: Maximum number of threads to use, including calling thread
+	template <typename Key, typename Ty>
+	static inline void sortRadix64Parallel(Key* _keys, Key* _tempKeys, Ty* _values, Ty* _tempValues, uint32_t _size, uint32_t _numThreads);
+
+	/// Sorts a value array using radix sort on job system threads, keys can be uint32_t, int32_t or float
+	///
+	/// @param[in,out] _keys	: Keys for sorting
+	/// @param[in] _tempKeys	: Temporary buffer for key sorting
+	/// @param[in,out] _values	: Values to sort
+	/// @param[in] _tempValues	: Temporary buffer for values
+	/// @param[in] _size		: Number of values to sort
+	/// @param[in] _jobs		: Initialized job system, calling thread helps executing jobs
+	template <typename Key, typename Ty>
+	static inline void sortRadixParallel(Key* _keys, Key* _tempKeys, Ty* _values, Ty* _tempValues, uint32_t _size, JobSystem* _jobs);
+
+	/// Sorts a value array using radix sort on job system threads, keys can be uint64_t, int64_t or double
+	///
+	/// @param[in,out] _keys	: Keys for sorting
+	/// @param[in] _tempKeys	: Temporary buffer for key sorting
+	/// @param[in,out] _values	: Values to sort
+	/// @param[in] _tempValues	: Temporary buffer for values
+	/// @param[in] _size		: Number of values to sort
+	/// @param[in] _jobs		: Initialized job system, calling thread helps executing jobs
+	template <typename Key, typename Ty>
+	static inline void sortRadix64Parallel(Key* _keys, Key* _tempKeys, Ty* _values, Ty* _tempValues, uint32_t _size, JobSystem* _jobs);
+
+	/// Sorts keys and computes the permutation, values can then be reordered in one pass.
+	/// Keys can be any type supported by radixKey.
+	///
+	/// @param[in,out] _keys		: Keys for sorting
+	/// @param[in] _tempKeys		: Temporary buffer for key sorting
+	/// @param[out] _indices		: Receives original index of each sorted key
+	/// @param[in] _tempIndices	: Temporary buffer for indices
+	/// @param[in] _size			: Number of keys to sort
+	template <typename Key>
+	static inline void sortRadixIndices(Key* _keys, Key* _tempKeys, uint32_t* _indices, uint32_t* _tempIndices, uint32_t _size);
+
+	/// Sorts a value array using radix sort, values are moved only once. Use instead of
+	/// sortRadix/sortRadix64 when values are much larger than keys.
+	///
+	/// @param[in,out] _keys		: Keys for sorting
+	/// @param[in] _tempKeys		: Temporary buffer for key sorting
+	/// @param[in,out] _values		: Values to sort
+	/// @param[in] _tempValues		: Temporary buffer for values
+	/// @param[in] _indices		: Temporary buffer for indices
+	/// @param[in] _tempIndices	: Temporary buffer for indices
+	/// @param[in] _size			: Number of values to sort
+	template <typename Key, typename Ty>
+	static inline void sortRadixIndirect(Key* _keys, Key* _tempKeys, Ty* _values, Ty* _tempValues, uint32_t* _indices, uint32_t* _tempIndices, uint32_t _size);
+
+	/// Sorts zero terminated strings using MSD radix sort. Sort is stable and orders
+	/// strings by unsigned byte values, shorter strings first on equal prefix.
+	///
+	/// @param[in,out] _strings	: Strings to sort
+	/// @param[in] _tempStrings	: Temporary buffer for sorting
+	/// @param[in] _size			: Number of strings to sort
+	void sortRadixStrings(const char** _strings, const char** _tempStrings, uint32_t _size);
+
+	/// Sorts string views using MSD radix sort. Sort is stable and orders
+	/// strings by unsigned byte values, shorter strings first on equal prefix.
+	///
+	/// @param[in,out] _strings	: Strings to sort
+	/// @param[in] _tempStrings	: Temporary buffer for sorting
+	/// @param[in] _size			: Number of strings to sort
+	void sortRadixStrings(StringView* _strings, StringView* _tempStrings, uint32_t _size);
+
+	/// Converts a key to unsigned integer with the same sort order.
+	/// Negative zero sorts before positive zero, NaNs sort after infinities (or before if sign bit is set).
+	///
+	/// @param[in] _key			: Key to convert
+	///
+	/// @returns unsigned key.
+	static inline uint32_t radixKey(uint32_t _key);
+	static inline uint32_t radixKey(int32_t _key);
+	static inline uint32_t radixKey(float _key);
+	static inline uint64_t radixKey(uint64_t _key);
+	static inline uint64_t radixKey(int64_t _key);
+	static inline uint64_t radixKey(double _key);
+
+} // namespace rtm
+
+/// ---------------------------------------------------------------------- ///
+///  Implementation                                                        ///
+/// ---------------------------------------------------------------------- ///
+
+namespace rtm {
+
+	static inline uint32_t radixKey(uint32_t _key)
+	{
+		return _key;
+	}
+
+	static inline uint32_t radixKey(int32_t _key)
+	{
+		return uint32_t(_key) ^ UINT32_C(0x80000000);
+	}
+
+	static inline uint32_t radixKey(float _key)
 	{
-		uint32_t* originalKeys = _keys;
-		Ty* originalValues = _values;
-		uint32_t histogram[RTM_RADIXSORT_HISTOGRAM_SIZE];
-		uint16_t shift = 0;
-		for (uint32_t pass=0; pass<3; ++pass)
+		union { float flt; uint32_t ui; } ftou;
+		ftou.flt = _key;
+		// negative values have all bits flipped, positive ones only the sign bit
+		const uint32_t mask = uint32_t(int32_t(ftou.ui) >> 31) | UINT32_C(0x80000000);
+		return ftou.ui ^ mask;
+	}
+
+	static inline uint64_t radixKey(uint64_t _key)
+	{
+		return _key;
+	}
+
+	static inline uint64_t radixKey(int64_t _key)
+	{
+		return uint64_t(_key) ^ UINT64_C(0x8000000000000000);
+	}
+
+	static inline uint64_t radixKey(double _key)
+	{
+		union { double dbl; uint64_t ui; } dtou;
+		dtou.dbl = _key;
+		const uint64_t mask = uint64_t(int64_t(dtou.ui) >> 63) | UINT64_C(0x8000000000000000);
+		return dtou.ui ^ mask;
+	}
+
+	namespace radixsort_private {
+
+		/// Placeholder value type for key only sorts
+		struct NoValue {};
+
+		/// Temporary buffers come from the library's memory manager, not from
+		/// rtm_alloc, so the header does not depend on libhandler.
+		void* tempAlloc(size_t _size);
+		void  tempFree(void* _ptr);
+
+		/// Returns job system used by sorts given a thread count, workers
+		/// for all hardware threads are started on first call.
+		JobSystem* parallelJobs();
+
+		/// Below this size keys are insertion sorted
+		constexpr uint32_t SMALL_SORT_SIZE			= 64;
+
+		/// Below this size 8bit digits are used, histogram setup would dominate with wider ones
+		constexpr uint32_t NARROW_DIGITS_MAX_SIZE	= 512;
+
+		/// From this size on scatter goes through write combining buffers
+		constexpr uint32_t WRITE_COMBINE_MIN_SIZE	= 256 * 1024;
+
+		constexpr uint32_t WRITE_COMBINE_LINE_SIZE	= 64;
+
+		/// Stable insertion sort of an index permutation, then gathers through temporary buffers.
+		template <typename Key, typename Ty, bool HAS_VALUES>
+		static inline void sortSmall(Key* _keys, Key* _tempKeys, Ty* _values, Ty* _tempValues, uint32_t _size)
 		{
-			memSet(histogram, 0, sizeof(uint32_t)*RTM_RADIXSORT_HISTOGRAM_SIZE);
+			RTM_ASSERT(_size <= SMALL_SORT_SIZE, "Too many keys for small sort!");
+
+			uint8_t order[SMALL_SORT_SIZE];
+			bool sorted = true;
 			for (uint32_t i=0; i<_size; ++i)
 			{
-				uint32_t key = _keys[i];
-				uint16_t index = (key >> shift) & RTM_RADIXSORT_BIT_MASK;
-				++histogram[index];
+				const auto key = radixKey(_keys[i]);
+				uint32_t j = i;
+				while ((j > 0) && (radixKey(_keys[order[j - 1]]) > key))
+				{
+					order[j] = order[j - 1];
+					--j;
+				}
+				order[j] = uint8_t(i);
+				sorted = sorted && (j == i);
 			}
 
-			uint32_t offset = 0;
-			for (uint32_t i=0; i<RTM_RADIXSORT_HISTOGRAM_SIZE; ++i)
+			if (sorted)
+				return;
+
+			for (uint32_t i=0; i<_size; ++i)
 			{
-				uint32_t count = histogram[i];
-				histogram[i] = offset;
-				offset += count;
+				_tempKeys[i] = _keys[order[i]];
+				if (HAS_VALUES)
+					_tempValues[i] = _values[order[i]];
+			}
+
+			memCopy(_keys, _size * sizeof(Key), _tempKeys, _size * sizeof(Key));
+			if (HAS_VALUES)
+				memCopy(_values, _size * sizeof(Ty), _tempValues, _size * sizeof(Ty));
+		}
+
+		/// Copies a cache line without polluting the cache, both pointers must be aligned to line size.
+		static inline void streamLine(void* _dst, const void* _src)
+		{
+#if RTM_SIMD_AVX2
+			const __m256i* src = (const __m256i*)_src;
+			__m256i* dst = (__m256i*)_dst;
+			_mm256_stream_si256(dst + 0, _mm256_load_si256(src + 0));
+			_mm256_stream_si256(dst + 1, _mm256_load_si256(src + 1));
+#elif RTM_SIMD_SSE2
+			const __m128i* src = (const __m128i*)_src;
+			__m128i* dst = (__m128i*)_dst;
+			_mm_stream_si128(dst + 0, _mm_load_si128(src + 0));
+			_mm_stream_si128(dst + 1, _mm_load_si128(src + 1));
+			_mm_stream_si128(dst + 2, _mm_load_si128(src + 2));
+			_mm_stream_si128(dst + 3, _mm_load_si128(src + 3));
+#else
+			memCopy(_dst, WRITE_COMBINE_LINE_SIZE, _src, WRITE_COMBINE_LINE_SIZE);
+#endif
+		}
+
+		/// Orders streaming stores before following loads and stores.
+		static inline void streamFence()
+		{
+#if RTM_SIMD_AVX2 || RTM_SIMD_SSE2
+			_mm_sfence();
+#endif
+		}
+
+		/// Software write combining, items for a bucket are gathered in a cache line
+		/// sized buffer and written to destination a full line at a time. Buffer slot
+		/// matches position of the item within its destination cache line.
+		template <typename T>
+		struct WriteCombiner
+		{
+			static constexpr uint32_t ItemsPerLine	= WRITE_COMBINE_LINE_SIZE / sizeof(T);
+			static constexpr bool Supported			= (sizeof(T) <= WRITE_COMBINE_LINE_SIZE) && (WRITE_COMBINE_LINE_SIZE % sizeof(T) == 0);
+
+			T*			m_dst;
+			T*			m_lines;
+			uint32_t	m_phase;
+
+			/// Returns false if destination alignment does not allow write combining.
+			inline bool init(T* _dst, void* _lines)
+			{
+				m_dst	= _dst;
+				m_lines	= (T*)_lines;
+				m_phase	= uint32_t((uintptr_t)_dst & (WRITE_COMBINE_LINE_SIZE - 1)) / sizeof(T);
+				return ((uintptr_t)_dst % sizeof(T)) == 0;
+			}
+
+			inline void write(uint32_t _bucket, uint32_t _start, uint32_t _pos, const T& _item)
+			{
+				const uint32_t slot = (_pos + m_phase) & (ItemsPerLine - 1);
+				T* line = m_lines + _bucket * ItemsPerLine;
+				line[slot] = _item;
+
+				if (slot != ItemsPerLine - 1)
+					return;
+
+				if (_pos + 1 >= _start + ItemsPerLine)
+					streamLine(m_dst + _pos + 1 - ItemsPerLine, line);
+				else
+					// line is shared with the previous bucket
+					memCopy(m_dst + _start, (_pos + 1 - _start) * sizeof(T), line + ((_start + m_phase) & (ItemsPerLine - 1)), (_pos + 1 - _start) * sizeof(T));
+			}
+
+			/// Writes out a partially filled line, _end is one past the last item of the bucket.
+			inline void flush(uint32_t _bucket, uint32_t _start, uint32_t _end)
+			{
+				const uint32_t count = (_end + m_phase) & (ItemsPerLine - 1);
+				const uint32_t first = _end >= _start + count ? _end - count : _start;
+				if (first == _end)
+					return;
+
+				const T* line = m_lines + _bucket * ItemsPerLine;
+				memCopy(m_dst + first, (_end - first) * sizeof(T), line + ((first + m_phase) & (ItemsPerLine - 1)), (_end - first) * sizeof(T));
 			}
+		};
+
+		/// LSD radix sort with BITS wide digits. Histograms of all digits are gathered in
+		/// a single read pass, then passes whose digit is the same for every key are skipped.
+		template <typename Key, typename Ty, bool HAS_VALUES, uint32_t BITS>
+		static inline void sortDigits(Key* _keys, Key* _tempKeys, Ty* _values, Ty* _tempValues, uint32_t _size, bool _writeCombine)
+		{
+			constexpr uint32_t NumPasses		= (sizeof(Key) * 8 + BITS - 1) / BITS;
+			constexpr uint32_t HistogramSize	= 1 << BITS;
+			constexpr uint32_t BitMask			= HistogramSize - 1;
+			constexpr bool CombineValues		= HAS_VALUES && WriteCombiner<Ty>::Supported;
+
+			uint32_t histogram[NumPasses][HistogramSize];
+			memSet(histogram, 0, sizeof(histogram));
 
 			for (uint32_t i=0; i<_size; ++i)
 			{
-				uint32_t key = _keys[i];
-				uint32_t index = (key>>shift)&RTM_RADIXSORT_BIT_MASK;
-				uint32_t dest = histogram[index]++;
-				_tempKeys[dest] = key;
-				_tempValues[dest] = _values[i];
+				const auto key = radixKey(_keys[i]);
+				for (uint32_t pass=0; pass<NumPasses; ++pass)
+					++histogram[pass][(key >> (pass * BITS)) & BitMask];
 			}
 
-			uint32_t* swapKeys = _tempKeys;
-			_tempKeys = _keys;
-			_keys = swapKeys;
+			// line buffer is aligned by hand, streamLine uses aligned loads and
+			// the default allocator does not honor alignment
+			uint8_t* linesMemory = 0;
+			uint8_t* lines = 0;
+			if (_writeCombine)
+			{
+				const uint32_t linesSize = HistogramSize * WRITE_COMBINE_LINE_SIZE;
+				linesMemory = (uint8_t*)tempAlloc((CombineValues ? linesSize * 2 : linesSize) + WRITE_COMBINE_LINE_SIZE - 1);
+				lines = (uint8_t*)(((uintptr_t)linesMemory + WRITE_COMBINE_LINE_SIZE - 1) & ~uintptr_t(WRITE_COMBINE_LINE_SIZE - 1));
+				_writeCombine = linesMemory != 0;
+			}
+
+			Key* originalKeys	= _keys;
+			Ty* originalValues	= _values;
+			const auto firstKey	= radixKey(_keys[0]);
+
+			for (uint32_t pass=0; pass<NumPasses; ++pass)
+			{
+				const uint32_t shift = pass * BITS;
+				uint32_t* passHistogram = histogram[pass];
+
+				// all keys share this digit, scatter would not move anything
+				if (passHistogram[(firstKey >> shift) & BitMask] == _size)
+					continue;
+
+				uint32_t offset = 0;
+				for (uint32_t i=0; i<HistogramSize; ++i)
+				{
+					uint32_t count = passHistogram[i];
+					passHistogram[i] = offset;
+					offset += count;
+				}
+
+				WriteCombiner<Key>	keyCombiner;
+				WriteCombiner<Ty>	valueCombiner;
+
+				bool combineKeys	= _writeCombine && keyCombiner.init(_tempKeys, lines);
+				bool combineValues	= combineKeys && CombineValues && valueCombiner.init(_tempValues, lines + HistogramSize * WRITE_COMBINE_LINE_SIZE);
+
+				if (combineKeys)
+				{
+					uint32_t bucketStart[HistogramSize];
+					memCopy(bucketStart, sizeof(bucketStart), passHistogram, sizeof(bucketStart));
+
+					for (uint32_t i=0; i<_size; ++i)
+					{
+						const Key key = _keys[i];
+						const uint32_t index = uint32_t(radixKey(key) >> shift) & BitMask;
+						const uint32_t dest = passHistogram[index]++;
+						keyCombiner.write(index, bucketStart[index], dest, key);
+						if (combineValues)
+							valueCombiner.write(index, bucketStart[index], dest, _values[i]);
+						else if (HAS_VALUES)
+							_tempValues[dest] = _values[i];
+					}
+
+					for (uint32_t i=0; i<HistogramSize; ++i)
+					{
+						keyCombiner.flush(i, bucketStart[i], passHistogram[i]);
+						if (combineValues)
+							valueCombiner.flush(i, bucketStart[i], passHistogram[i]);
+					}
 
-			Ty* swapValues = _tempValues;
-			_tempValues = _values;
-			_values = swapValues;
+					streamFence();
+				}
+				else
+				{
+					for (uint32_t i=0; i<_size; ++i)
+					{
+						const Key key = _keys[i];
+						const uint32_t index = uint32_t(radixKey(key) >> shift) & BitMask;
+						const uint32_t dest = passHistogram[index]++;
+						_tempKeys[dest] = key;
+						if (HAS_VALUES)
+							_tempValues[dest] = _values[i];
+					}
+				}
 
-			shift += RTM_RADIXSORT_BITS;
+				Key* swapKeys = _tempKeys;
+				_tempKeys = _keys;
+				_keys = swapKeys;
+
+				Ty* swapValues = _tempValues;
+				_tempValues = _values;
+				_values = swapValues;
+			}
+
+			if (linesMemory)
+				tempFree(linesMemory);
+
+			if (_keys != originalKeys)
+			{
+				memCopy(originalKeys, _size * sizeof(Key), _keys, _size * sizeof(Key));
+				if (HAS_VALUES)
+					memCopy(originalValues, _size * sizeof(Ty), _values, _size * sizeof(Ty));
+			}
 		}
 
-		if (_keys != originalKeys)
+		/// Picks sorting method and digit width by number of keys.
+		template <typename Key, typename Ty, bool HAS_VALUES>
+		static inline void sort(Key* _keys, Key* _tempKeys, Ty* _values, Ty* _tempValues, uint32_t _size)
 		{
-			memCopy(originalKeys, _size * sizeof(uint32_t), _keys, _size * sizeof(uint32_t));
-			memCopy(originalValues, _size * sizeof(Ty), _values, _size * sizeof(Ty));
+			if (_size < 2)
+				return;
+
+			if (_size <= SMALL_SORT_SIZE)
+				sortSmall<Key, Ty, HAS_VALUES>(_keys, _tempKeys, _values, _tempValues, _size);
+			else if (_size < NARROW_DIGITS_MAX_SIZE)
+				sortDigits<Key, Ty, HAS_VALUES, 8>(_keys, _tempKeys, _values, _tempValues, _size, false);
+			else
+				sortDigits<Key, Ty, HAS_VALUES, RTM_RADIXSORT_BITS>(_keys, _tempKeys, _values, _tempValues, _size, _size >= WRITE_COMBINE_MIN_SIZE);
 		}
-	}
 
-	/// Sorts a value array using radix sort
-	///
-	/// @param[in,out] _keys	: Keys for sorting
-	/// @param[out] _tempKeys	: Temporary buffer for key sorting
-	/// @param[in] _values		: Values to sort
-	/// @param[in] _tempValues	: Temporary buffer for values
-	/// @param[in] _size		: Number of values to sort
-	template <typename Ty>
-	static inline void sortRadix64(uint64_t* _keys, uint64_t* _tempKeys, Ty* _values, Ty* _tempValues, uint32_t _size)
-	{
-		uint32_t histogram[RTM_RADIXSORT_HISTOGRAM_SIZE];
-		uint16_t shift = 0;
-		for (uint32_t pass=0; pass<6; ++pass)
+		constexpr uint32_t PARALLEL_MAX_THREADS			= 64;
+		constexpr uint32_t PARALLEL_MIN_KEYS_PER_THREAD	= 64 * 1024;
+		constexpr uint32_t PARALLEL_ALL_PASSES			= 0xffffffff;
+
+		/// Parallel LSD radix sort, each thread owns a contiguous range of the input.
+		/// Threads build local digit histograms, scatter offsets are prefix sums over
+		/// digits first and threads second, so the sort stays stable. Sort runs in
+		/// phases, every phase has to finish on all threads before the next starts.
+		template <typename Key, typename Ty>
+		struct ParallelSort
 		{
-			memSet(histogram, 0, sizeof(uint32_t)*RTM_RADIXSORT_HISTOGRAM_SIZE);
-			for (uint32_t i=0; i<_size; ++i)
+			Key*		m_keys;
+			Key*		m_tempKeys;
+			Ty*			m_values;
+			Ty*			m_tempValues;
+			uint32_t*	m_histograms;
+			uint32_t	m_size;
+			uint32_t	m_numThreads;
+		};
+
+		template <typename Key>
+		constexpr uint32_t parallelNumPasses()
+		{
+			return (sizeof(Key) * 8 + RTM_RADIXSORT_BITS - 1) / RTM_RADIXSORT_BITS;
+		}
+
+		template <typename Key, typename Ty>
+		static inline void parallelRange(const ParallelSort<Key, Ty>& _sort, uint32_t _index, uint32_t& _begin, uint32_t& _end)
+		{
+			_begin	= uint32_t(uint64_t(_sort.m_size) * _index / _sort.m_numThreads);
+			_end	= uint32_t(uint64_t(_sort.m_size) * (_index + 1) / _sort.m_numThreads);
+		}
+
+		/// Builds digit histogram of a thread's range for a single pass or for all of them.
+		template <typename Key, typename Ty>
+		static inline void parallelHistogram(ParallelSort<Key, Ty>& _sort, uint32_t _index, const Key* _keys, uint32_t _pass)
+		{
+			constexpr uint32_t NumPasses	= parallelNumPasses<Key>();
+			constexpr uint32_t PassStride	= RTM_RADIXSORT_HISTOGRAM_SIZE;
+
+			uint32_t begin, end;
+			parallelRange(_sort, _index, begin, end);
+
+			uint32_t* histogram = _sort.m_histograms + _index * NumPasses * PassStride;
+
+			if (_pass == PARALLEL_ALL_PASSES)
 			{
-				uint64_t key = _keys[i];
-				uint16_t index = (key>>shift)&RTM_RADIXSORT_BIT_MASK;
-				++histogram[index];
+				memSet(histogram, 0, NumPasses * PassStride * sizeof(uint32_t));
+				for (uint32_t i=begin; i<end; ++i)
+				{
+					const auto key = radixKey(_keys[i]);
+					for (uint32_t pass=0; pass<NumPasses; ++pass)
+						++histogram[pass * PassStride + ((key >> (pass * RTM_RADIXSORT_BITS)) & RTM_RADIXSORT_BIT_MASK)];
+				}
+				return;
 			}
 
+			// histograms gathered up front only match the input order
+			const uint32_t shift = _pass * RTM_RADIXSORT_BITS;
+			uint32_t* passHistogram = histogram + _pass * PassStride;
+			memSet(passHistogram, 0, PassStride * sizeof(uint32_t));
+			for (uint32_t i=begin; i<end; ++i)
+				++passHistogram[uint32_t(radixKey(_keys[i]) >> shift) & RTM_RADIXSORT_BIT_MASK];
+		}
+
+		/// Returns mask of passes in which all keys have the same digit, decided before any histogram is rebuilt.
+		template <typename Key, typename Ty>
+		static inline uint32_t parallelSkipPasses(const ParallelSort<Key, Ty>& _sort)
+		{
+			constexpr uint32_t NumPasses	= parallelNumPasses<Key>();
+			constexpr uint32_t PassStride	= RTM_RADIXSORT_HISTOGRAM_SIZE;
+			constexpr uint32_t ThreadStride	= NumPasses * PassStride;
+
+			const auto firstKey = radixKey(_sort.m_keys[0]);
+			uint32_t skipPasses = 0;
+			for (uint32_t pass=0; pass<NumPasses; ++pass)
+			{
+				const uint32_t digit = uint32_t(firstKey >> (pass * RTM_RADIXSORT_BITS)) & RTM_RADIXSORT_BIT_MASK;
+				uint32_t total = 0;
+				for (uint32_t t=0; t<_sort.m_numThreads; ++t)
+					total += _sort.m_histograms[t * ThreadStride + pass * PassStride + digit];
+				if (total == _sort.m_size)
+					skipPasses |= 1 << pass;
+			}
+			return skipPasses;
+		}
+
+		/// Moves a thread's range of keys to their place for the given pass.
+		template <typename Key, typename Ty, bool HAS_VALUES>
+		static inline void parallelScatter(ParallelSort<Key, Ty>& _sort, uint32_t _index, uint32_t _pass, const Key* _keys, Key* _tempKeys, const Ty* _values, Ty* _tempValues)
+		{
+			constexpr uint32_t NumPasses	= parallelNumPasses<Key>();
+			constexpr uint32_t PassStride	= RTM_RADIXSORT_HISTOGRAM_SIZE;
+			constexpr uint32_t ThreadStride	= NumPasses * PassStride;
+
+			uint32_t begin, end;
+			parallelRange(_sort, _index, begin, end);
+
+			uint32_t offsets[RTM_RADIXSORT_HISTOGRAM_SIZE];
 			uint32_t offset = 0;
-			for (uint32_t i=0; i<RTM_RADIXSORT_HISTOGRAM_SIZE; ++i)
+			for (uint32_t digit=0; digit<RTM_RADIXSORT_HISTOGRAM_SIZE; ++digit)
 			{
-				uint32_t count = histogram[i];
-				histogram[i] = offset;
-				offset += count;
+				const uint32_t* digitCounts = _sort.m_histograms + _pass * PassStride + digit;
+				for (uint32_t t=0; t<_index; ++t)
+					offset += digitCounts[t * ThreadStride];
+				offsets[digit] = offset;
+				for (uint32_t t=_index; t<_sort.m_numThreads; ++t)
+					offset += digitCounts[t * ThreadStride];
 			}
 
-			for (uint32_t i=0; i<_size; ++i)
+			const uint32_t shift = _pass * RTM_RADIXSORT_BITS;
+			for (uint32_t i=begin; i<end; ++i)
 			{
-				uint64_t key = _keys[i];
-				uint32_t index = (key >> shift) & RTM_RADIXSORT_BIT_MASK;
-				uint32_t dest = histogram[index]++;
+				const Key key = _keys[i];
+				const uint32_t dest = offsets[uint32_t(radixKey(key) >> shift) & RTM_RADIXSORT_BIT_MASK]++;
 				_tempKeys[dest] = key;
-				_tempValues[dest] = _values[i];
+				if (HAS_VALUES)
+					_tempValues[dest] = _values[i];
+			}
+		}
+
+		/// Copies a thread's range back to the caller's arrays after an odd number of passes.
+		template <typename Key, typename Ty, bool HAS_VALUES>
+		static inline void parallelCopyBack(ParallelSort<Key, Ty>& _sort, uint32_t _index, const Key* _keys, const Ty* _values)
+		{
+			uint32_t begin, end;
+			parallelRange(_sort, _index, begin, end);
+
+			memCopy(_sort.m_keys + begin, (end - begin) * sizeof(Key), _keys + begin, (end - begin) * sizeof(Key));
+			if (HAS_VALUES)
+				memCopy(_sort.m_values + begin, (end - begin) * sizeof(Ty), _values + begin, (end - begin) * sizeof(Ty));
+		}
+
+		/// Runs one phase for a range of thread indices, executed through JobSystem::parallelFor.
+		template <typename Key, typename Ty, bool HAS_VALUES>
+		struct ParallelPhase
+		{
+			enum Enum
+			{
+				Histogram,
+				PassHistogram,
+				Scatter,
+				CopyBack
+			};
+
+			ParallelSort<Key, Ty>*	m_sort;
+			Key*					m_keys;
+			Key*					m_tempKeys;
+			Ty*						m_values;
+			Ty*						m_tempValues;
+			uint32_t				m_phase;
+			uint32_t				m_pass;
+
+			void operator()(uint32_t _begin, uint32_t _end) const
+			{
+				for (uint32_t index=_begin; index<_end; ++index)
+				{
+					switch (m_phase)
+					{
+					case Histogram:		parallelHistogram(*m_sort, index, m_keys, PARALLEL_ALL_PASSES); break;
+					case PassHistogram:	parallelHistogram(*m_sort, index, m_keys, m_pass); break;
+					case Scatter:		parallelScatter<Key, Ty, HAS_VALUES>(*m_sort, index, m_pass, m_keys, m_tempKeys, m_values, m_tempValues); break;
+					case CopyBack:		parallelCopyBack<Key, Ty, HAS_VALUES>(*m_sort, index, m_keys, m_values); break;
+					}
+				}
 			}
+		};
+
+		/// Returns number of threads to split the sort over, less than 2 means sorting on the calling thread.
+		static inline uint32_t parallelNumThreads(uint32_t _size, uint32_t _numThreads)
+		{
+			uint32_t numThreads = _size / PARALLEL_MIN_KEYS_PER_THREAD;
+			numThreads = numThreads < _numThreads ? numThreads : _numThreads;
+			numThreads = numThreads < PARALLEL_MAX_THREADS ? numThreads : PARALLEL_MAX_THREADS;
+			return numThreads;
+		}
+
+		template <typename Key, typename Ty>
+		static inline void parallelInit(ParallelSort<Key, Ty>& _sort, Key* _keys, Key* _tempKeys, Ty* _values, Ty* _tempValues, uint32_t _size, uint32_t _numThreads)
+		{
+			_sort.m_keys		= _keys;
+			_sort.m_tempKeys	= _tempKeys;
+			_sort.m_values		= _values;
+			_sort.m_tempValues	= _tempValues;
+			_sort.m_histograms	= (uint32_t*)tempAlloc(_numThreads * parallelNumPasses<Key>() * RTM_RADIXSORT_HISTOGRAM_SIZE * sizeof(uint32_t));
+			_sort.m_size		= _size;
+			_sort.m_numThreads	= _numThreads;
+		}
 
-			uint64_t* swapKeys = _tempKeys;
-			_tempKeys = _keys;
-			_keys = swapKeys;
+		/// Sorts on job system workers, each phase is a parallelFor over per thread ranges
+		/// so no thread ever waits in a barrier.
+		template <typename Key, typename Ty, bool HAS_VALUES>
+		static inline void sortParallel(Key* _keys, Key* _tempKeys, Ty* _values, Ty* _tempValues, uint32_t _size, JobSystem* _jobs, uint32_t _numThreads)
+		{
+			constexpr uint32_t NumPasses = parallelNumPasses<Key>();
+
+			const uint32_t numThreads = parallelNumThreads(_size, _numThreads);
+			if (numThreads < 2)
+			{
+				sort<Key, Ty, HAS_VALUES>(_keys, _tempKeys, _values, _tempValues, _size);
+				return;
+			}
+
+			ParallelSort<Key, Ty> parallelSort;
+			parallelInit(parallelSort, _keys, _tempKeys, _values, _tempValues, _size, numThreads);
+
+			ParallelPhase<Key, Ty, HAS_VALUES> phase;
+			phase.m_sort		= &parallelSort;
+			phase.m_keys		= _keys;
+			phase.m_tempKeys	= _tempKeys;
+			phase.m_values		= _values;
+			phase.m_tempValues	= _tempValues;
+			phase.m_phase		= phase.Histogram;
+			phase.m_pass		= 0;
+			_jobs->parallelFor(0, numThreads, phase, 1);
+
+			const uint32_t skipPasses = parallelSkipPasses(parallelSort);
+			bool firstPass = true;
+
+			for (uint32_t pass=0; pass<NumPasses; ++pass)
+			{
+				if (skipPasses & (1 << pass))
+					continue;
+
+				phase.m_pass = pass;
+				if (!firstPass)
+				{
+					phase.m_phase = phase.PassHistogram;
+					_jobs->parallelFor(0, numThreads, phase, 1);
+				}
+				firstPass = false;
+
+				phase.m_phase = phase.Scatter;
+				_jobs->parallelFor(0, numThreads, phase, 1);
+
+				Key* swapKeys = phase.m_tempKeys;
+				phase.m_tempKeys = phase.m_keys;
+				phase.m_keys = swapKeys;
+
+				Ty* swapValues = phase.m_tempValues;
+				phase.m_tempValues = phase.m_values;
+				phase.m_values = swapValues;
+			}
+
+			if (phase.m_keys != _keys)
+			{
+				phase.m_phase = phase.CopyBack;
+				_jobs->parallelFor(0, numThreads, phase, 1);
+			}
+
+			tempFree(parallelSort.m_histograms);
+		}
 
-			Ty* swapValues = _tempValues;
-			_tempValues = _values;
-			_values = swapValues;
+		template <typename Key, typename Ty, bool HAS_VALUES>
+		static inline void sortParallel(Key* _keys, Key* _tempKeys, Ty* _values, Ty* _tempValues, uint32_t _size, uint32_t _numThreads)
+		{
+			sortParallel<Key, Ty, HAS_VALUES>(_keys, _tempKeys, _values, _tempValues, _size, parallelJobs(), _numThreads);
+		}
 
-			shift += RTM_RADIXSORT_BITS;
+		template <typename Key, typename Ty, bool HAS_VALUES>
+		static inline void sortParallel(Key* _keys, Key* _tempKeys, Ty* _values, Ty* _tempValues, uint32_t _size, JobSystem* _jobs)
+		{
+			sortParallel<Key, Ty, HAS_VALUES>(_keys, _tempKeys, _values, _tempValues, _size, _jobs, _jobs->getNumThreads());
 		}
+
+	} // namespace radixsort_private
+
+	template <typename Key, typename Ty>
+	static inline void sortRadix(Key* _keys, Key* _tempKeys, Ty* _values, Ty* _tempValues, uint32_t _size)
+	{
+		RTM_STATIC_ASSERT(sizeof(Key) == 4, "32bit keys expected!");
+		radixsort_private::sort<Key, Ty, true>(_keys, _tempKeys, _values, _tempValues, _size);
+	}
+
+	template <typename Key, typename Ty>
+	static inline void sortRadix64(Key* _keys, Key* _tempKeys, Ty* _values, Ty* _tempValues, uint32_t _size)
+	{
+		RTM_STATIC_ASSERT(sizeof(Key) == 8, "64bit keys expected!");
+		radixsort_private::sort<Key, Ty, true>(_keys, _tempKeys, _values, _tempValues, _size);
+	}
+
+	template <typename Key, typename Ty>
+	static inline void sortRadixParallel(Key* _keys, Key* _tempKeys, Ty* _values, Ty* _tempValues, uint32_t _size, uint32_t _numThreads)
+	{
+		RTM_STATIC_ASSERT(sizeof(Key) == 4, "32bit keys expected!");
+		radixsort_private::sortParallel<Key, Ty, true>(_keys, _tempKeys, _values, _tempValues, _size, _numThreads);
+	}
+
+	template <typename Key, typename Ty>
+	static inline void sortRadix64Parallel(Key* _keys, Key* _tempKeys, Ty* _values, Ty* _tempValues, uint32_t _size, uint32_t _numThreads)
+	{
+		RTM_STATIC_ASSERT(sizeof(Key) == 8, "64bit keys expected!");
+		radixsort_private::sortParallel<Key, Ty, true>(_keys, _tempKeys, _values, _tempValues, _size, _numThreads);
+	}
+
+	template <typename Key, typename Ty>
+	static inline void sortRadixParallel(Key* _keys, Key* _tempKeys, Ty* _values, Ty* _tempValues, uint32_t _size, JobSystem* _jobs)
+	{
+		RTM_STATIC_ASSERT(sizeof(Key) == 4, "32bit keys expected!");
+		radixsort_private::sortParallel<Key, Ty, true>(_keys, _tempKeys, _values, _tempValues, _size, _jobs);
+	}
+
+	template <typename Key, typename Ty>
+	static inline void sortRadix64Parallel(Key* _keys, Key* _tempKeys, Ty* _values, Ty* _tempValues, uint32_t _size, JobSystem* _jobs)
+	{
+		RTM_STATIC_ASSERT(sizeof(Key) == 8, "64bit keys expected!");
+		radixsort_private::sortParallel<Key, Ty, true>(_keys, _tempKeys, _values, _tempValues, _size, _jobs);
+	}
+
+	template <typename Key>
+	static inline void sortRadixIndices(Key* _keys, Key* _tempKeys, uint32_t* _indices, uint32_t* _tempIndices, uint32_t _size)
+	{
+		RTM_STATIC_ASSERT((sizeof(Key) == 4) || (sizeof(Key) == 8), "32bit or 64bit keys expected!");
+
+		for (uint32_t i=0; i<_size; ++i)
+			_indices[i] = i;
+
+		radixsort_private::sort<Key, uint32_t, true>(_keys, _tempKeys, _indices, _tempIndices, _size);
+	}
+
+	template <typename Key, typename Ty>
+	static inline void sortRadixIndirect(Key* _keys, Key* _tempKeys, Ty* _values, Ty* _tempValues, uint32_t* _indices, uint32_t* _tempIndices, uint32_t _size)
+	{
+		sortRadixIndices(_keys, _tempKeys, _indices, _tempIndices, _size);
+
+		for (uint32_t i=0; i<_size; ++i)
+			_tempValues[i] = _values[_indices[i]];
+
+		memCopy(_values, _size * sizeof(Ty), _tempValues, _size * sizeof(Ty));
 	}
 
 } // namespace rtm
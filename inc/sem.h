@@ -7,6 +7,7 @@
 #define RTM_RBASE_SEMAPHORE_H
 
 #include <rbase/inc/platform.h>
+#include <atomic>
 
 #if RTM_PLATFORM_WINDOWS || RTM_PLATFORM_XBOXONE || RTM_PLATFORM_WINRT
 	#define WIN32_LEAN_AND_MEAN
@@ -135,31 +136,35 @@ namespace rtm {
 	{
 		int result = pthread_mutex_lock(&_sem->m_mutex);
 
-	#if RTM_PLATFORM_ANDROID
-		if (_ms != -1)
+		if (_ms >= 0)
 		{
+			// pthread_cond_timedwait takes an absolute time
 			timespec ts;
-			rtm::memSet(&ts, 0, sizeof(timespec));
-			ts.tv_nsec = _ms * 1000000;
+			clock_gettime(CLOCK_REALTIME, &ts);
+			ts.tv_sec	+= _ms / 1000;
+			ts.tv_nsec	+= (_ms % 1000) * 1000000;
+			if (ts.tv_nsec >= 1000000000)
+			{
+				ts.tv_sec	+= 1;
+				ts.tv_nsec	-= 1000000000;
+			}
+
 			while (result == 0 && 0 >= _sem->m_count)
 				result = pthread_cond_timedwait(&_sem->m_cv, &_sem->m_mutex, &ts);
 		}
 		else
-	#endif
 		{
-			RTM_ASSERT(-1 == _ms, "NaCl, iOS and OSX don't support pthread_cond_timedwait at this moment.");
 			while (result == 0 && 0 >= _sem->m_count)
 				result = pthread_cond_wait(&_sem->m_cv, &_sem->m_mutex);
 		}
 
-
 		bool ok = result == 0;
 
 		if (ok)
 			--_sem->m_count;
 
 		result = pthread_mutex_unlock(&_sem->m_mutex);
-		return result == 0;
+		return ok && (result == 0);
 	}
 	
 #else
@@ -194,6 +199,76 @@ namespace rtm {
 		}
 	};
 
+	//--------------------------------------------------------------------------
+	/// Event count, lets a thread sleep until a lock free condition changes.
+	/// Waiter calls prepareWait, re-checks the condition and then either calls
+	/// cancelWait or commitWait. Signaling side changes the condition and calls
+	/// notify, which only touches the semaphore if a thread is waiting.
+	/// Waiters can wake up spuriously and must re-check the condition.
+	//--------------------------------------------------------------------------
+	class EventCount
+	{
+		RTM_CLASS_NO_COPY(EventCount)
+
+		std::atomic<int32_t>	m_numWaiters;
+		Semaphore				m_semaphore;
+
+	public:
+		inline EventCount()
+			: m_numWaiters(0)
+		{
+		}
+
+		/// Announces intent to wait, condition has to be checked again after this call.
+		inline void prepareWait()
+		{
+			m_numWaiters.fetch_add(1, std::memory_order_seq_cst);
+		}
+
+		/// Called instead of commitWait if the condition was met after prepareWait.
+		inline void cancelWait()
+		{
+			m_numWaiters.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		/// Sleeps until notified or timed out.
+		///
+		/// @param[in] _ms    : Milliseconds to wait for, -1 to wait forever
+		///
+		/// @returns true if notified, false on timeout.
+		inline bool commitWait(int32_t _ms = -1)
+		{
+			const bool notified = m_semaphore.wait(_ms);
+			m_numWaiters.fetch_sub(1, std::memory_order_relaxed);
+			return notified;
+		}
+
+		/// Wakes up one waiting thread, if any. Call after the condition has changed.
+		inline void notify()
+		{
+			wake(1);
+		}
+
+		/// Wakes up all waiting threads. Call after the condition has changed.
+		inline void notifyAll()
+		{
+			wake(-1);
+		}
+
+	private:
+		inline void wake(int32_t _count)
+		{
+			// orders condition change before the waiter count load, pairs with prepareWait
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			const int32_t numWaiters = m_numWaiters.load(std::memory_order_relaxed);
+			if (numWaiters <= 0)
+				return;
+
+			const int32_t count = (_count < 0) || (_count > numWaiters) ? numWaiters : _count;
+			m_semaphore.post(uint32_t(count));
+		}
+	};
+
 } // namespace rtm
 
 #endif // RTM_RBASE_SEMAPHORE_H
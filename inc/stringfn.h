@@ -252,14 +252,432 @@ namespace rtm {
 ///  Implementation                                                        ///
 /// ---------------------------------------------------------------------- ///
 
+#if RTM_SIMD_AVX2
+	#include <immintrin.h>
+#elif RTM_SIMD_SSE2
+	#include <emmintrin.h>
+#elif RTM_SIMD_NEON
+	#include <arm_neon.h>
+#endif
+
+#if RTM_COMPILER_MSVC
+	#include <intrin.h>
+#endif
+
 namespace rtm {
 
+	namespace mem_private {
+
+		static inline uint64_t load64(const void* _src)
+		{
+			uint64_t result;
+#if RTM_COMPILER_GCC || RTM_COMPILER_CLANG
+			__builtin_memcpy(&result, _src, sizeof(result));
+#elif RTM_CPU_X86 || RTM_64BIT
+			result = *(const uint64_t*)_src;
+#else
+			const uint8_t* src = (const uint8_t*)_src;
+			result = 0;
+			for (int i=7; i>=0; --i)
+				result = (result << 8) | src[i];
+#endif
+			return result;
+		}
+
+		static inline void store64(void* _dst, uint64_t _val)
+		{
+#if RTM_COMPILER_GCC || RTM_COMPILER_CLANG
+			__builtin_memcpy(_dst, &_val, sizeof(_val));
+#elif RTM_CPU_X86 || RTM_64BIT
+			*(uint64_t*)_dst = _val;
+#else
+			uint8_t* dst = (uint8_t*)_dst;
+			for (int i=0; i<8; ++i, _val >>= 8)
+				dst[i] = (uint8_t)_val;
+#endif
+		}
+
+		static inline uint32_t load32(const void* _src)
+		{
+			uint32_t result;
+#if RTM_COMPILER_GCC || RTM_COMPILER_CLANG
+			__builtin_memcpy(&result, _src, sizeof(result));
+#elif RTM_CPU_X86 || RTM_64BIT
+			result = *(const uint32_t*)_src;
+#else
+			const uint8_t* src = (const uint8_t*)_src;
+			result = src[0] | (src[1] << 8) | (src[2] << 16) | ((uint32_t)src[3] << 24);
+#endif
+			return result;
+		}
+
+		static inline void store32(void* _dst, uint32_t _val)
+		{
+#if RTM_COMPILER_GCC || RTM_COMPILER_CLANG
+			__builtin_memcpy(_dst, &_val, sizeof(_val));
+#elif RTM_CPU_X86 || RTM_64BIT
+			*(uint32_t*)_dst = _val;
+#else
+			uint8_t* dst = (uint8_t*)_dst;
+			for (int i=0; i<4; ++i, _val >>= 8)
+				dst[i] = (uint8_t)_val;
+#endif
+		}
+
+		//--------------------------------------------------------------------------
+		/// Widest register available for bulk memory operations, a 64bit word is
+		/// used when no SIMD instruction set is enabled.
+		//--------------------------------------------------------------------------
+#if RTM_SIMD_AVX2
+		typedef __m256i Vec;
+		constexpr uint32_t VEC_SIZE = 32;
+
+		static inline Vec  vecLoad(const void* _src)			{ return _mm256_loadu_si256((const __m256i*)_src); }
+		static inline void vecStore(void* _dst, Vec _v)			{ _mm256_storeu_si256((__m256i*)_dst, _v); }
+		static inline void vecStoreAligned(void* _dst, Vec _v)	{ _mm256_store_si256((__m256i*)_dst, _v); }
+		static inline Vec  vecSplat(uint8_t _val)				{ return _mm256_set1_epi8((char)_val); }
+		static inline bool vecEqual(Vec _a, Vec _b)				{ return -1 == _mm256_movemask_epi8(_mm256_cmpeq_epi8(_a, _b)); }
+
+		constexpr uint32_t MASK_BITS = 1;
+
+		static inline Vec  vecLoadAligned(const void* _src)		{ return _mm256_load_si256((const __m256i*)_src); }
+		static inline Vec  vecCmpEq(Vec _a, Vec _b)				{ return _mm256_cmpeq_epi8(_a, _b); }
+		static inline Vec  vecAnd(Vec _a, Vec _b)				{ return _mm256_and_si256(_a, _b); }
+		static inline Vec  vecOr(Vec _a, Vec _b)				{ return _mm256_or_si256(_a, _b); }
+		static inline uint64_t vecMask(Vec _v)					{ return (uint32_t)_mm256_movemask_epi8(_v); }
+		static inline Vec  vecToLower(Vec _v)
+		{
+			const Vec biased  = _mm256_add_epi8(_v, _mm256_set1_epi8((char)(0x80 - 'A')));
+			const Vec isUpper = _mm256_cmpgt_epi8(_mm256_set1_epi8((char)(-128 + 26)), biased);
+			return _mm256_or_si256(_v, _mm256_and_si256(isUpper, _mm256_set1_epi8(0x20)));
+		}
+#elif RTM_SIMD_SSE2
+		typedef __m128i Vec;
+		constexpr uint32_t VEC_SIZE = 16;
+
+		static inline Vec  vecLoad(const void* _src)			{ return _mm_loadu_si128((const __m128i*)_src); }
+		static inline void vecStore(void* _dst, Vec _v)			{ _mm_storeu_si128((__m128i*)_dst, _v); }
+		static inline void vecStoreAligned(void* _dst, Vec _v)	{ _mm_store_si128((__m128i*)_dst, _v); }
+		static inline Vec  vecSplat(uint8_t _val)				{ return _mm_set1_epi8((char)_val); }
+		static inline bool vecEqual(Vec _a, Vec _b)				{ return 0xffff == _mm_movemask_epi8(_mm_cmpeq_epi8(_a, _b)); }
+
+		constexpr uint32_t MASK_BITS = 1;
+
+		static inline Vec  vecLoadAligned(const void* _src)		{ return _mm_load_si128((const __m128i*)_src); }
+		static inline Vec  vecCmpEq(Vec _a, Vec _b)				{ return _mm_cmpeq_epi8(_a, _b); }
+		static inline Vec  vecAnd(Vec _a, Vec _b)				{ return _mm_and_si128(_a, _b); }
+		static inline Vec  vecOr(Vec _a, Vec _b)				{ return _mm_or_si128(_a, _b); }
+		static inline uint64_t vecMask(Vec _v)					{ return (uint32_t)_mm_movemask_epi8(_v); }
+		static inline Vec  vecToLower(Vec _v)
+		{
+			// signed compare after biasing 'A' to -128 tests for 'A'..'Z'
+			const Vec biased  = _mm_add_epi8(_v, _mm_set1_epi8((char)(0x80 - 'A')));
+			const Vec isUpper = _mm_cmplt_epi8(biased, _mm_set1_epi8((char)(-128 + 26)));
+			return _mm_or_si128(_v, _mm_and_si128(isUpper, _mm_set1_epi8(0x20)));
+		}
+#elif RTM_SIMD_NEON
+		typedef uint8x16_t Vec;
+		constexpr uint32_t VEC_SIZE = 16;
+
+		static inline Vec  vecLoad(const void* _src)			{ return vld1q_u8((const uint8_t*)_src); }
+		static inline void vecStore(void* _dst, Vec _v)			{ vst1q_u8((uint8_t*)_dst, _v); }
+		static inline void vecStoreAligned(void* _dst, Vec _v)	{ vst1q_u8((uint8_t*)_dst, _v); }
+		static inline Vec  vecSplat(uint8_t _val)				{ return vdupq_n_u8(_val); }
+		static inline bool vecEqual(Vec _a, Vec _b)
+		{
+			const uint64x2_t eq = vreinterpretq_u64_u8(vceqq_u8(_a, _b));
+			return UINT64_MAX == (vgetq_lane_u64(eq, 0) & vgetq_lane_u64(eq, 1));
+		}
+
+		constexpr uint32_t MASK_BITS = 4;
+
+		static inline Vec  vecLoadAligned(const void* _src)		{ return vld1q_u8((const uint8_t*)_src); }
+		static inline Vec  vecCmpEq(Vec _a, Vec _b)				{ return vceqq_u8(_a, _b); }
+		static inline Vec  vecAnd(Vec _a, Vec _b)				{ return vandq_u8(_a, _b); }
+		static inline Vec  vecOr(Vec _a, Vec _b)				{ return vorrq_u8(_a, _b); }
+		static inline uint64_t vecMask(Vec _v)
+		{
+			// narrowing shift packs each byte lane to a nibble
+			return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(_v), 4)), 0);
+		}
+		static inline Vec  vecToLower(Vec _v)
+		{
+			const Vec isUpper = vcleq_u8(vsubq_u8(_v, vdupq_n_u8('A')), vdupq_n_u8(25));
+			return vorrq_u8(_v, vandq_u8(isUpper, vdupq_n_u8(0x20)));
+		}
+#else
+		typedef uint64_t Vec;
+		constexpr uint32_t VEC_SIZE = 8;
+
+		static inline Vec  vecLoad(const void* _src)			{ return load64(_src); }
+		static inline void vecStore(void* _dst, Vec _v)			{ store64(_dst, _v); }
+		static inline void vecStoreAligned(void* _dst, Vec _v)	{ store64(_dst, _v); }
+		static inline Vec  vecSplat(uint8_t _val)				{ return UINT64_C(0x0101010101010101) * _val; }
+		static inline bool vecEqual(Vec _a, Vec _b)				{ return _a == _b; }
+
+		constexpr uint32_t MASK_BITS = 8;
+
+		static inline Vec  vecLoadAligned(const void* _src)		{ return load64(_src); }
+		static inline Vec  vecAnd(Vec _a, Vec _b)				{ return _a & _b; }
+		static inline Vec  vecOr(Vec _a, Vec _b)				{ return _a | _b; }
+		static inline Vec  vecCmpEq(Vec _a, Vec _b)
+		{
+			// exact per byte zero test, sets high bit of each equal byte
+			const uint64_t diff = _a ^ _b;
+			const uint64_t low7 = UINT64_C(0x7f7f7f7f7f7f7f7f);
+			return ~(((diff & low7) + low7) | diff | low7);
+		}
+		static inline uint64_t vecMask(Vec _v)
+		{
+#if RTM_BIG_ENDIAN
+			return __builtin_bswap64(_v);
+#else
+			return _v;
+#endif
+		}
+		static inline Vec  vecToLower(Vec _v)
+		{
+			const uint64_t low7  = _v & UINT64_C(0x7f7f7f7f7f7f7f7f);
+			const uint64_t geA   = low7 + UINT64_C(0x3f3f3f3f3f3f3f3f);	// high bit set if >= 'A'
+			const uint64_t gtZ   = low7 + UINT64_C(0x2525252525252525);	// high bit set if >  'Z'
+			const uint64_t upper = geA & ~gtZ & ~_v & UINT64_C(0x8080808080808080);
+			return _v | (upper >> 2);
+		}
+#endif
+
+		static inline uint8_t* alignUp(uint8_t* _ptr)
+		{
+			return (uint8_t*)(((uintptr_t)_ptr + VEC_SIZE - 1) & ~(uintptr_t)(VEC_SIZE - 1));
+		}
+
+		static inline uint8_t* alignDown(uint8_t* _ptr)
+		{
+			return (uint8_t*)((uintptr_t)_ptr & ~(uintptr_t)(VEC_SIZE - 1));
+		}
+
+		/// Returns the index of the first byte lane set in a vecMask result.
+		static inline uint32_t maskFirst(uint64_t _mask)
+		{
+#if RTM_COMPILER_GCC || RTM_COMPILER_CLANG
+			const uint32_t bit = (uint32_t)__builtin_ctzll(_mask);
+#elif RTM_COMPILER_MSVC && RTM_64BIT
+			unsigned long bit;
+			_BitScanForward64(&bit, _mask);
+#else
+			uint32_t bit = 0;
+			while (0 == (_mask & 1)) { _mask >>= 1; ++bit; }
+#endif
+			return (uint32_t)bit / MASK_BITS;
+		}
+
+		/// Clears the first byte lane set in a vecMask result.
+		static inline uint64_t maskClearFirst(uint64_t _mask)
+		{
+			const uint64_t laneBits = (UINT64_C(1) << MASK_BITS) - 1;
+			return _mask & ~(laneBits << (maskFirst(_mask) * MASK_BITS));
+		}
+
+// Word loads are only issued once the size is known to be large enough,
+// GCC still follows the other paths when the source is a small array.
+#if RTM_COMPILER_GCC
+	#pragma GCC diagnostic push
+	#pragma GCC diagnostic ignored "-Warray-bounds"
+	#if __GNUC__ >= 11
+	#pragma GCC diagnostic ignored "-Wstringop-overread"
+	#endif
+#endif
+		/// Copies less than 32 bytes, all source bytes are loaded before the first
+		/// store so it is safe to use with overlapping buffers.
+		static inline void copySmall(uint8_t* _dst, const uint8_t* _src, size_t _size)
+		{
+			if (_size >= 16)
+			{
+				const uint64_t a = load64(_src);
+				const uint64_t b = load64(_src + 8);
+				const uint64_t c = load64(_src + _size - 16);
+				const uint64_t d = load64(_src + _size - 8);
+				store64(_dst, a);
+				store64(_dst + 8, b);
+				store64(_dst + _size - 16, c);
+				store64(_dst + _size - 8, d);
+			}
+			else
+			if (_size >= 8)
+			{
+				const uint64_t a = load64(_src);
+				const uint64_t b = load64(_src + _size - 8);
+				store64(_dst, a);
+				store64(_dst + _size - 8, b);
+			}
+			else
+			if (_size >= 4)
+			{
+				const uint32_t a = load32(_src);
+				const uint32_t b = load32(_src + _size - 4);
+				store32(_dst, a);
+				store32(_dst + _size - 4, b);
+			}
+			else
+			if (_size > 0)
+			{
+				const uint8_t a = _src[0];
+				const uint8_t b = _src[_size >> 1];
+				const uint8_t c = _src[_size - 1];
+				_dst[0]				= a;
+				_dst[_size >> 1]	= b;
+				_dst[_size - 1]		= c;
+			}
+		}
+#if RTM_COMPILER_GCC
+	#pragma GCC diagnostic pop
+#endif
+
+		/// Forward copy of at least VEC_SIZE bytes. Kept out of line so callers
+		/// copying from small fixed size arrays don't see vector wide loads.
+		static inline RNOINLINE void copyForwardBlocks(uint8_t* _dst, const uint8_t* _src, size_t _size)
+		{
+			// Unaligned head and tail are loaded up front and stored last, loop writes
+			// only aligned blocks in between.
+			const Vec head = vecLoad(_src);
+			const Vec tail = vecLoad(_src + _size - VEC_SIZE);
+
+			uint8_t* const end = _dst + _size;
+			uint8_t* dst = alignUp(_dst + 1);
+			const uint8_t* src = _src + (dst - _dst);
+
+			for (; dst + 4*VEC_SIZE <= end; dst += 4*VEC_SIZE, src += 4*VEC_SIZE)
+			{
+				const Vec v0 = vecLoad(src);
+				const Vec v1 = vecLoad(src + VEC_SIZE);
+				const Vec v2 = vecLoad(src + VEC_SIZE*2);
+				const Vec v3 = vecLoad(src + VEC_SIZE*3);
+				vecStoreAligned(dst,				v0);
+				vecStoreAligned(dst + VEC_SIZE,		v1);
+				vecStoreAligned(dst + VEC_SIZE*2,	v2);
+				vecStoreAligned(dst + VEC_SIZE*3,	v3);
+			}
+
+			for (; dst + VEC_SIZE <= end; dst += VEC_SIZE, src += VEC_SIZE)
+			{
+				vecStoreAligned(dst, vecLoad(src));
+			}
+
+			vecStore(end - VEC_SIZE, tail);
+			vecStore(_dst, head);
+		}
+
+		/// Backward copy of at least VEC_SIZE bytes.
+		static inline RNOINLINE void copyBackwardBlocks(uint8_t* _dst, const uint8_t* _src, size_t _size)
+		{
+			const Vec head = vecLoad(_src);
+			const Vec tail = vecLoad(_src + _size - VEC_SIZE);
+
+			uint8_t* const begin = _dst + VEC_SIZE;
+			uint8_t* dst = alignDown(_dst + _size);
+			const uint8_t* src = _src + (dst - _dst);
+
+			while (dst >= begin + 3*VEC_SIZE)
+			{
+				dst -= 4*VEC_SIZE;
+				src -= 4*VEC_SIZE;
+				const Vec v0 = vecLoad(src);
+				const Vec v1 = vecLoad(src + VEC_SIZE);
+				const Vec v2 = vecLoad(src + VEC_SIZE*2);
+				const Vec v3 = vecLoad(src + VEC_SIZE*3);
+				vecStoreAligned(dst + VEC_SIZE*3,	v3);
+				vecStoreAligned(dst + VEC_SIZE*2,	v2);
+				vecStoreAligned(dst + VEC_SIZE,		v1);
+				vecStoreAligned(dst,				v0);
+			}
+
+			while (dst >= begin)
+			{
+				dst -= VEC_SIZE;
+				src -= VEC_SIZE;
+				vecStoreAligned(dst, vecLoad(src));
+			}
+
+			vecStore(_dst, head);
+			vecStore(_dst + _size - VEC_SIZE, tail);
+		}
+
+		/// Forward copy, safe for overlapping buffers when _dst < _src.
+		static inline void copyForward(uint8_t* _dst, const uint8_t* _src, size_t _size)
+		{
+			if (_size < VEC_SIZE)
+				copySmall(_dst, _src, _size);
+			else
+				copyForwardBlocks(_dst, _src, _size);
+		}
+
+		/// Backward copy, safe for overlapping buffers when _dst > _src.
+		static inline void copyBackward(uint8_t* _dst, const uint8_t* _src, size_t _size)
+		{
+			if (_size < VEC_SIZE)
+				copySmall(_dst, _src, _size);
+			else
+				copyBackwardBlocks(_dst, _src, _size);
+		}
+
+		static inline int32_t compareBytes(const uint8_t* _lhs, const uint8_t* _rhs, size_t _size)
+		{
+			for (size_t i=0; i<_size; ++i)
+			{
+				if (_lhs[i] != _rhs[i])
+				{
+					return _lhs[i] - _rhs[i];
+				}
+			}
+			return 0;
+		}
+
+	} // namespace mem_private
+
 	static inline void memSet(void* _dst, uint8_t _val, uint64_t _numBytes)
 	{
+		using namespace mem_private;
+
 		uint8_t* dst = (uint8_t*)_dst;
-		while (_numBytes--)
+		const size_t size = (size_t)_numBytes;
+
+		if (size < VEC_SIZE)
+		{
+			if (size >= 8)
+			{
+				const uint64_t val = UINT64_C(0x0101010101010101) * _val;
+				for (size_t i=0; i+8<=size; i+=8)
+				{
+					store64(dst + i, val);
+				}
+				store64(dst + size - 8, val);
+				return;
+			}
+
+			for (size_t i=0; i<size; ++i)
+			{
+				dst[i] = _val;
+			}
+			return;
+		}
+
+		const Vec val = vecSplat(_val);
+		uint8_t* const end = dst + size;
+
+		vecStore(dst, val);
+		vecStore(end - VEC_SIZE, val);
+
+		dst = alignUp(dst + 1);
+		for (; dst + 4*VEC_SIZE <= end; dst += 4*VEC_SIZE)
 		{
-			*dst++ = _val;
+			vecStoreAligned(dst,				val);
+			vecStoreAligned(dst + VEC_SIZE,		val);
+			vecStoreAligned(dst + VEC_SIZE*2,	val);
+			vecStoreAligned(dst + VEC_SIZE*3,	val);
+		}
+
+		for (; dst + VEC_SIZE <= end; dst += VEC_SIZE)
+		{
+			vecStoreAligned(dst, val);
 		}
 	}
 
@@ -267,13 +685,7 @@ namespace rtm {
 	{
 		RTM_ASSERT(_dstSize >= _numBytes, "");
 		_numBytes = _numBytes > _dstSize ? _dstSize : _numBytes;
-		uint8_t* dst = (uint8_t*)_dst;
-		const uint8_t* end = dst + _numBytes;
-		const uint8_t* src = (const uint8_t*)_src;
-		while (dst != end)
-		{
-			*dst++ = *src++;
-		}
+		mem_private::copyForward((uint8_t*)_dst, (const uint8_t*)_src, (size_t)_numBytes);
 	}
 
 	static inline void memMove(void* _dst, const void* _src, uint64_t _size)
@@ -286,34 +698,69 @@ namespace rtm {
 			return;
 		}
 
-		if (dst < src)
+		if ((dst < src) || (dst >= src + _size))
 		{
-			memCopy(_dst, _size, _src, _size);
+			mem_private::copyForward(dst, src, (size_t)_size);
 			return;
 		}
 
-		for (int64_t i = (int64_t)_size-1; i >= 0; --i)
-		{
-			dst[i] = src[i];
-		}
+		mem_private::copyBackward(dst, src, (size_t)_size);
 	}
 
+// Vector loads are only issued once the size is known to be large enough,
+// GCC still follows the other paths when the source is a small array.
+#if RTM_COMPILER_GCC
+	#pragma GCC diagnostic push
+	#pragma GCC diagnostic ignored "-Warray-bounds"
+	#if __GNUC__ >= 11
+	#pragma GCC diagnostic ignored "-Wstringop-overread"
+	#endif
+#endif
 	static inline int32_t memCompare(const void* _tgt, const void* _src, uint64_t _numBytes)
 	{
-		uint8_t* tgt = (uint8_t*)_tgt;
-		uint8_t* src = (uint8_t*)_src;
-		while (_numBytes > 0)
+		using namespace mem_private;
+
+		const uint8_t* tgt = (const uint8_t*)_tgt;
+		const uint8_t* src = (const uint8_t*)_src;
+		const size_t size = (size_t)_numBytes;
+
+		if (size < VEC_SIZE)
+		{
+			size_t i = 0;
+			for (; i+8<=size; i+=8)
+			{
+				if (load64(tgt + i) != load64(src + i))
+				{
+					return compareBytes(tgt + i, src + i, 8);
+				}
+			}
+			return compareBytes(tgt + i, src + i, size - i);
+		}
+
+		size_t i = 0;
+		for (; i+VEC_SIZE<=size; i+=VEC_SIZE)
+		{
+			if (!vecEqual(vecLoad(tgt + i), vecLoad(src + i)))
+			{
+				return compareBytes(tgt + i, src + i, VEC_SIZE);
+			}
+		}
+
+		if (i != size)
 		{
-			if (*tgt != *src)
+			// overlapping tail, bytes before 'i' are already known to be equal
+			const size_t last = size - VEC_SIZE;
+			if (!vecEqual(vecLoad(tgt + last), vecLoad(src + last)))
 			{
-				return *tgt - *src;
+				return compareBytes(tgt + i, src + i, size - i);
 			}
-			++tgt;
-			++src;
-			--_numBytes;
 		}
+
 		return 0;
 	}
+#if RTM_COMPILER_GCC
+	#pragma GCC diagnostic pop
+#endif
 
 	static inline bool charIsInRange(char _ch, int _from, int _to)
 	{
@@ -386,14 +833,264 @@ namespace rtm {
 		return _ch + (charIsUpper(_ch) ? 0x20 : 0);
 	}
 
+	namespace string_private {
+
+		/// Sets lanes of bytes equal to zero, _c0 or _c1.
+		static inline mem_private::Vec scanMatch(mem_private::Vec _v, mem_private::Vec _zero, mem_private::Vec _c0, mem_private::Vec _c1)
+		{
+			using namespace mem_private;
+			return vecOr(vecCmpEq(_v, _zero), vecOr(vecCmpEq(_v, _c0), vecCmpEq(_v, _c1)));
+		}
+
+		/// Returns index of the first byte equal to zero, _c0 or _c1, or _max if none
+		/// is found. Blocks are loaded aligned so reads past the terminator or _max
+		/// never cross into the next page. Address sanitizer still reports those
+		/// reads, so sanitized builds scan per byte.
+		static inline uint32_t scan(const char* _str, uint32_t _max, uint8_t _c0, uint8_t _c1)
+		{
+#if RTM_ADDRESS_SANITIZER
+			for (uint32_t i=0; i<_max; ++i)
+			{
+				const uint8_t ch = (uint8_t)_str[i];
+				if ((0 == ch) || (_c0 == ch) || (_c1 == ch))
+				{
+					return i;
+				}
+			}
+			return _max;
+#else
+			using namespace mem_private;
+
+			const Vec zero	= vecSplat(0);
+			const Vec c0	= vecSplat(_c0);
+			const Vec c1	= vecSplat(_c1);
+
+			const uint8_t* block = alignDown((uint8_t*)_str);
+			const uint32_t skip  = uint32_t((const uint8_t*)_str - block);
+
+			uint64_t mask = vecMask(scanMatch(vecLoadAligned(block), zero, c0, c1));
+			mask >>= skip * MASK_BITS;
+			if (mask)
+			{
+				const uint32_t idx = maskFirst(mask);
+				return idx < _max ? idx : _max;
+			}
+
+			// single blocks up to a group of four that is aligned to its size, a group
+			// then never crosses a page as long as its first byte can be read
+			uint32_t len = VEC_SIZE - skip;
+			block += VEC_SIZE;
+			while ((uintptr_t)block & (4*VEC_SIZE - 1))
+			{
+				if (len >= _max)
+				{
+					return _max;
+				}
+
+				mask = vecMask(scanMatch(vecLoadAligned(block), zero, c0, c1));
+				if (mask)
+				{
+					len += maskFirst(mask);
+					return len < _max ? len : _max;
+				}
+
+				len   += VEC_SIZE;
+				block += VEC_SIZE;
+			}
+
+			for (;;)
+			{
+				if (len >= _max)
+				{
+					return _max;
+				}
+
+				const Vec m0 = scanMatch(vecLoadAligned(block),				zero, c0, c1);
+				const Vec m1 = scanMatch(vecLoadAligned(block + VEC_SIZE),		zero, c0, c1);
+				const Vec m2 = scanMatch(vecLoadAligned(block + VEC_SIZE*2),	zero, c0, c1);
+				const Vec m3 = scanMatch(vecLoadAligned(block + VEC_SIZE*3),	zero, c0, c1);
+
+				if (vecMask(vecOr(vecOr(m0, m1), vecOr(m2, m3))))
+				{
+					break;
+				}
+
+				len   += 4*VEC_SIZE;
+				block += 4*VEC_SIZE;
+			}
+
+			// match is in the current group
+			while (0 == (mask = vecMask(scanMatch(vecLoadAligned(block), zero, c0, c1))))
+			{
+				len   += VEC_SIZE;
+				block += VEC_SIZE;
+			}
+
+			len += maskFirst(mask);
+			return len < _max ? len : _max;
+#endif
+		}
+
+		template <bool IGNORE_CASE>
+		static inline uint8_t fold(uint8_t _ch)
+		{
+			return IGNORE_CASE ? (uint8_t)charToLower((char)_ch) : _ch;
+		}
+
+		template <bool IGNORE_CASE>
+		static inline mem_private::Vec fold(mem_private::Vec _v)
+		{
+			return IGNORE_CASE ? mem_private::vecToLower(_v) : _v;
+		}
+
+		template <bool IGNORE_CASE>
+		static inline bool equal(const uint8_t* _lhs, const uint8_t* _rhs, uint32_t _len)
+		{
+			if (!IGNORE_CASE)
+			{
+				return 0 == memCompare(_lhs, _rhs, _len);
+			}
+
+			for (uint32_t i=0; i<_len; ++i)
+			{
+				if (fold<true>(_lhs[i]) != fold<true>(_rhs[i]))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+// Blocks are only searched in strings longer than a vector, GCC still
+// follows this path when the string is a small array.
+#if RTM_COMPILER_GCC
+	#pragma GCC diagnostic push
+	#pragma GCC diagnostic ignored "-Warray-bounds"
+	#if __GNUC__ >= 11
+	#pragma GCC diagnostic ignored "-Wstringop-overread"
+	#endif
+#endif
+		/// Checks pattern candidates starting in the block at _pos. Loads read up
+		/// to str[_pos + VEC_SIZE].
+		///
+		/// @returns index of the match or UINT32_MAX if there is none.
+		template <bool IGNORE_CASE>
+		static inline uint32_t findInBlock(const uint8_t* _str, uint32_t _pos, uint32_t _last, mem_private::Vec _v0, mem_private::Vec _v1, const uint8_t* _find, uint32_t _findLen)
+		{
+			using namespace mem_private;
+
+			const Vec a = fold<IGNORE_CASE>(vecLoad(_str + _pos));
+			const Vec b = fold<IGNORE_CASE>(vecLoad(_str + _pos + 1));
+
+			uint64_t mask = vecMask(vecAnd(vecCmpEq(a, _v0), vecCmpEq(b, _v1)));
+			while (mask)
+			{
+				const uint32_t idx = _pos + maskFirst(mask);
+				if (idx > _last)
+				{
+					return UINT32_MAX;
+				}
+
+				if (equal<IGNORE_CASE>(_str + idx + 2, _find + 2, _findLen - 2))
+				{
+					return idx;
+				}
+
+				mask = maskClearFirst(mask);
+			}
+
+			return UINT32_MAX;
+		}
+#if RTM_COMPILER_GCC
+	#pragma GCC diagnostic pop
+#endif
+
+		/// Substring search over strings of known length. Candidates are found by
+		/// comparing the first two characters of the pattern against two shifted
+		/// loads at once, only candidate positions are fully compared.
+		/// Strings are not required to be terminated, nothing past _strLen is read.
+		template <bool IGNORE_CASE>
+		static inline const char* find(const char* _str, uint32_t _strLen, const char* _find, uint32_t _findLen)
+		{
+			using namespace mem_private;
+
+			if (0 == _findLen)
+			{
+				return _str;
+			}
+
+			if (_findLen > _strLen)
+			{
+				return 0;
+			}
+
+			const uint8_t* str  = (const uint8_t*)_str;
+			const uint8_t* pat  = (const uint8_t*)_find;
+			const uint32_t last = _strLen - _findLen;
+			const uint8_t  f0   = fold<IGNORE_CASE>(pat[0]);
+
+			if (1 == _findLen)
+			{
+				for (uint32_t pos=0; pos<=last; ++pos)
+				{
+					if (fold<IGNORE_CASE>(str[pos]) == f0)
+					{
+						return _str + pos;
+					}
+				}
+				return 0;
+			}
+
+			const uint8_t f1 = fold<IGNORE_CASE>(pat[1]);
+
+			// too short for a block, second load would read past the string
+			if (_strLen <= VEC_SIZE)
+			{
+				for (uint32_t pos=0; pos<=last; ++pos)
+				{
+					if ((fold<IGNORE_CASE>(str[pos]) == f0) && (fold<IGNORE_CASE>(str[pos + 1]) == f1) &&
+						equal<IGNORE_CASE>(str + pos + 2, pat + 2, _findLen - 2))
+					{
+						return _str + pos;
+					}
+				}
+				return 0;
+			}
+
+			const Vec v0 = vecSplat(f0);
+			const Vec v1 = vecSplat(f1);
+
+			uint32_t pos = 0;
+			for (; (pos <= last) && (pos + VEC_SIZE < _strLen); pos += VEC_SIZE)
+			{
+				const uint32_t idx = findInBlock<IGNORE_CASE>(str, pos, last, v0, v1, pat, _findLen);
+				if (idx != UINT32_MAX)
+				{
+					return _str + idx;
+				}
+			}
+
+			// last block overlaps the previous one and ends with the last character
+			if (pos <= last)
+			{
+				const uint32_t idx = findInBlock<IGNORE_CASE>(str, _strLen - VEC_SIZE - 1, last, v0, v1, pat, _findLen);
+				if (idx != UINT32_MAX)
+				{
+					return _str + idx;
+				}
+			}
+
+			return 0;
+		}
+
+	} // namespace string_private
+
 	static inline uint32_t strLen(const char* _str, uint32_t _max)
 	{
 		if (0 == _str)
 			return 0;
 
-		const char* ptr = _str;
-		for (; 0 < _max && *ptr != '\0'; ++ptr, --_max) {};
-		return uint32_t(ptr - _str);
+		return string_private::scan(_str, _max, 0, 0);
 	}
 
 	static inline uint32_t strLen(const wchar_t* _str, uint32_t _max)
@@ -443,6 +1140,16 @@ namespace rtm {
 	template<fnChar fn>
 	static inline const char* strStr(const char* _str, uint32_t _strMax, const char* _find, uint32_t _findMax)
 	{
+		if (fn == charNoop)
+		{
+			return string_private::find<false>(_str, strLen(_str, _strMax), _find, strLen(_find, _findMax));
+		}
+
+		if (fn == charToLower)
+		{
+			return string_private::find<true>(_str, strLen(_str, _strMax), _find, strLen(_find, _findMax));
+		}
+
 		const char* ptr = _str;
 
 		uint32_t       stringLen = strLen(_str,  _strMax);
@@ -484,6 +1191,19 @@ namespace rtm {
 	template<fnChar fn>
 	static inline const char* strChr(const char* _str, uint32_t _strMax, char _find)
 	{
+		if ((fn == charNoop) || (fn == charToLower))
+		{
+			// folded characters are never upper case, so such _find can't match
+			if ((fn == charToLower) && charIsUpper(_find))
+			{
+				return 0;
+			}
+
+			const uint8_t alt = (fn == charToLower) ? (uint8_t)charToUpper(_find) : (uint8_t)_find;
+			const uint32_t idx = string_private::scan(_str, _strMax, (uint8_t)_find, alt);
+			return ((idx < _strMax) && ('\0' != _str[idx])) ? &_str[idx] : 0;
+		}
+
 		uint32_t stringLen = strLen(_str, _strMax);
 		for (uint32_t i=0; i<stringLen; ++i)
 		{
@@ -0,0 +1,328 @@
+//--------------------------------------------------------------------------//
+/// Copyright 2025 Milos Tosic. All Rights Reserved.                       ///
+/// License: http://www.opensource.org/licenses/BSD-2-Clause               ///
+//--------------------------------------------------------------------------//
+
+#ifndef RTM_RBASE_STRINGPOOL_H
+#define RTM_RBASE_STRINGPOOL_H
+
+#include <rbase/inc/platform.h>
+#include <rbase/inc/chunkallocator.h>
+#include <rbase/inc/hashmap.h>
+#include <rbase/inc/mutex.h>
+#include <rbase/inc/stringview.h>
+
+namespace rtm {
+
+	/// Interned string identifier, compare IDs instead of strings. Zero is never a valid ID.
+	typedef uint32_t StringID;
+
+	enum : StringID { StringIDInvalid = 0 };
+
+	/// Hashes a string for use with string pool functions taking a precomputed hash.
+	///
+	/// @param[in] _str      : String to hash
+	///
+	/// @returns 64bit hash of the string.
+	static inline uint64_t stringPoolHash(const StringView& _str);
+
+	namespace stringpool_private {
+
+		/// Interned string, also used as a lookup key with a borrowed string.
+		struct Key
+		{
+			const char*	m_str;
+			uint32_t	m_length;
+			uint64_t	m_hash;
+		};
+
+		struct KeyHasher
+		{
+			static inline uint64_t hash(const Key& _key)
+			{
+				return _key.m_hash;
+			}
+
+			static inline bool equal(const Key& _lhs, const Key& _rhs)
+			{
+				return	(_lhs.m_hash	== _rhs.m_hash)		&&
+						(_lhs.m_length	== _rhs.m_length)	&&
+						(0 == memCompare(_lhs.m_str, _rhs.m_str, _lhs.m_length));
+			}
+		};
+
+	} // namespace stringpool_private
+
+	//--------------------------------------------------------------------------
+	/// String intern pool. Each unique string is stored once, zero terminated,
+	/// in StackAllocator arenas and identified by a 32bit ID. Strings are never
+	/// removed so returned views stay valid for the lifetime of the pool.
+	/// Not thread safe, see StringPoolConcurrent.
+	//--------------------------------------------------------------------------
+	class StringPool
+	{
+		typedef stringpool_private::Key Key;
+
+		typedef HashMap<Key, StringID, stringpool_private::KeyHasher> Lookup;
+
+		StackAllocator	m_arena;
+		Lookup			m_lookup;
+		Key*			m_strings;
+		uint32_t		m_numStrings;
+		uint32_t		m_maxStrings;
+
+	public:
+		inline StringPool()
+			: m_strings(0)
+			, m_numStrings(0)
+			, m_maxStrings(0)
+		{
+		}
+
+		StringPool(const StringPool&) = delete;
+		StringPool& operator=(const StringPool&) = delete;
+
+		inline ~StringPool()
+		{
+			if (m_strings)
+				RBASE_NAMESPACE::rtm_free(m_strings);
+		}
+
+		/// Interns a string, storing it if not already in the pool.
+		///
+		/// @param[in] _str      : String to intern
+		///
+		/// @returns ID of the string.
+		inline StringID intern(const StringView& _str)
+		{
+			return intern(_str, stringPoolHash(_str));
+		}
+
+		/// Interns a string, storing it if not already in the pool.
+		///
+		/// @param[in] _str      : String to intern
+		/// @param[in] _hash     : Hash of the string, as returned by stringPoolHash
+		///
+		/// @returns ID of the string.
+		inline StringID intern(const StringView& _str, uint64_t _hash)
+		{
+			const Key key = { _str.data(), _str.length(), _hash };
+			const StringID* found = m_lookup.find(key);
+			if (found)
+				return *found;
+
+			if (m_numStrings == m_maxStrings)
+				grow();
+
+			char* str = (char*)m_arena.alloc(key.m_length + 1, 1);
+			memCopy(str, key.m_length, key.m_str, key.m_length);
+			str[key.m_length] = '\0';
+
+			Key& stored		= m_strings[m_numStrings++];
+			stored			= key;
+			stored.m_str	= str;
+
+			const StringID id = m_numStrings;
+			m_lookup.insert(stored, id);
+			return id;
+		}
+
+		/// Finds ID of a string without interning it.
+		///
+		/// @param[in] _str      : String to find
+		///
+		/// @returns ID of the string or StringIDInvalid if not in the pool.
+		inline StringID find(const StringView& _str) const
+		{
+			return find(_str, stringPoolHash(_str));
+		}
+
+		/// Finds ID of a string without interning it.
+		///
+		/// @param[in] _str      : String to find
+		/// @param[in] _hash     : Hash of the string, as returned by stringPoolHash
+		///
+		/// @returns ID of the string or StringIDInvalid if not in the pool.
+		inline StringID find(const StringView& _str, uint64_t _hash) const
+		{
+			const Key key = { _str.data(), _str.length(), _hash };
+			const StringID* found = m_lookup.find(key);
+			return found ? *found : StringIDInvalid;
+		}
+
+		/// Returns interned string.
+		///
+		/// @param[in] _id       : String ID
+		///
+		/// @returns view of the zero terminated string.
+		inline StringView get(StringID _id) const
+		{
+			RTM_ASSERT((_id != StringIDInvalid) && (_id <= m_numStrings), "Invalid string ID!");
+			const Key& key = m_strings[_id - 1];
+			return StringView(key.m_str, key.m_length);
+		}
+
+		/// Returns hash of an interned string.
+		///
+		/// @param[in] _id       : String ID
+		///
+		/// @returns hash of the string, same as stringPoolHash.
+		inline uint64_t getHash(StringID _id) const
+		{
+			RTM_ASSERT((_id != StringIDInvalid) && (_id <= m_numStrings), "Invalid string ID!");
+			return m_strings[_id - 1].m_hash;
+		}
+
+		/// Returns number of strings in the pool.
+		inline uint32_t size() const
+		{
+			return m_numStrings;
+		}
+
+	private:
+		inline void grow()
+		{
+			const uint32_t maxStrings = m_maxStrings ? m_maxStrings * 2 : 256;
+			Key* strings = (Key*)RBASE_NAMESPACE::rtm_alloc(sizeof(Key) * maxStrings);
+			RTM_ASSERT(strings != 0, "Failed to allocate memory!");
+
+			if (m_strings)
+			{
+				memCopy(strings, sizeof(Key) * maxStrings, m_strings, sizeof(Key) * m_numStrings);
+				RBASE_NAMESPACE::rtm_free(m_strings);
+			}
+
+			m_strings		= strings;
+			m_maxStrings	= maxStrings;
+		}
+	};
+
+	//--------------------------------------------------------------------------
+	/// Thread safe string intern pool. Strings are distributed over independently
+	/// locked stripes by hash so concurrent interning rarely contends. The stripe
+	/// index is kept in the low bits of the ID.
+	//--------------------------------------------------------------------------
+	class StringPoolConcurrent
+	{
+		enum
+		{
+			STRIPE_BITS	= 4,
+			NUM_STRIPES	= 1 << STRIPE_BITS
+		};
+
+		struct Stripe
+		{
+			Mutex		m_mutex;
+			StringPool	m_pool;
+		};
+
+		Stripe	m_stripes[NUM_STRIPES];
+
+		static inline uint32_t stripeIndex(uint64_t _hash)
+		{
+			return uint32_t(_hash >> (64 - STRIPE_BITS));
+		}
+
+	public:
+		inline StringPoolConcurrent()
+		{
+		}
+
+		StringPoolConcurrent(const StringPoolConcurrent&) = delete;
+		StringPoolConcurrent& operator=(const StringPoolConcurrent&) = delete;
+
+		/// Interns a string, storing it if not already in the pool.
+		///
+		/// @param[in] _str      : String to intern
+		///
+		/// @returns ID of the string.
+		inline StringID intern(const StringView& _str)
+		{
+			return intern(_str, stringPoolHash(_str));
+		}
+
+		/// Interns a string, storing it if not already in the pool.
+		///
+		/// @param[in] _str      : String to intern
+		/// @param[in] _hash     : Hash of the string, as returned by stringPoolHash
+		///
+		/// @returns ID of the string.
+		inline StringID intern(const StringView& _str, uint64_t _hash)
+		{
+			const uint32_t index = stripeIndex(_hash);
+			Stripe& stripe = m_stripes[index];
+
+			ScopedMutexLocker lock(stripe.m_mutex);
+			const StringID id = stripe.m_pool.intern(_str, _hash);
+			RTM_ASSERT(id < (1u << (32 - STRIPE_BITS)), "Too many strings!");
+			return (id << STRIPE_BITS) | index;
+		}
+
+		/// Finds ID of a string without interning it.
+		///
+		/// @param[in] _str      : String to find
+		///
+		/// @returns ID of the string or StringIDInvalid if not in the pool.
+		inline StringID find(const StringView& _str)
+		{
+			return find(_str, stringPoolHash(_str));
+		}
+
+		/// Finds ID of a string without interning it.
+		///
+		/// @param[in] _str      : String to find
+		/// @param[in] _hash     : Hash of the string, as returned by stringPoolHash
+		///
+		/// @returns ID of the string or StringIDInvalid if not in the pool.
+		inline StringID find(const StringView& _str, uint64_t _hash)
+		{
+			const uint32_t index = stripeIndex(_hash);
+			Stripe& stripe = m_stripes[index];
+
+			ScopedMutexLocker lock(stripe.m_mutex);
+			const StringID id = stripe.m_pool.find(_str, _hash);
+			return id == StringIDInvalid ? StringIDInvalid : (id << STRIPE_BITS) | index;
+		}
+
+		/// Returns interned string.
+		///
+		/// @param[in] _id       : String ID
+		///
+		/// @returns view of the zero terminated string, valid for the lifetime of the pool.
+		inline StringView get(StringID _id)
+		{
+			Stripe& stripe = m_stripes[_id & (NUM_STRIPES - 1)];
+
+			ScopedMutexLocker lock(stripe.m_mutex);
+			return stripe.m_pool.get(_id >> STRIPE_BITS);
+		}
+
+		/// Returns number of strings in the pool.
+		inline uint32_t size()
+		{
+			uint32_t size = 0;
+			for (uint32_t i=0; i<NUM_STRIPES; ++i)
+			{
+				ScopedMutexLocker lock(m_stripes[i].m_mutex);
+				size += m_stripes[i].m_pool.size();
+			}
+			return size;
+		}
+	};
+
+} // namespace rtm
+
+/// ---------------------------------------------------------------------- ///
+///  Implementation                                                        ///
+/// ---------------------------------------------------------------------- ///
+
+namespace rtm {
+
+	static inline uint64_t stringPoolHash(const StringView& _str)
+	{
+		return hashFast64(_str.data(), _str.length());
+	}
+
+} // namespace rtm
+
+#endif // RTM_RBASE_STRINGPOOL_H
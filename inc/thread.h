@@ -43,6 +43,18 @@ namespace rtm {
 	/// Yields thread execution.
 	static inline void threadYield();
 
+	/// Returns number of hardware threads available to the process.
+	///
+	/// @returns number of hardware threads, at least 1.
+	static inline uint32_t threadGetNumHardwareThreads();
+
+	/// Pins current thread to a hardware thread.
+	///
+	/// @param[in] _hwThread : Hardware thread index, wrapped to number of hardware threads.
+	///
+	/// @returns true if affinity was set, false on failure or if not supported.
+	static inline bool threadSetAffinity(uint32_t _hwThread);
+
 } // namespace rtm
 
 /// ---------------------------------------------------------------------- ///
@@ -259,6 +271,35 @@ namespace rtm {
 #endif
 	}
 
+	static inline uint32_t threadGetNumHardwareThreads()
+	{
+#if RTM_PLATFORM_WINDOWS || RTM_PLATFORM_XBOXONE || RTM_PLATFORM_WINRT
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		return info.dwNumberOfProcessors ? (uint32_t)info.dwNumberOfProcessors : 1;
+#elif RTM_PLATFORM_LINUX || RTM_PLATFORM_ANDROID || RTM_PLATFORM_OSX || RTM_PLATFORM_IOS
+		const long count = sysconf(_SC_NPROCESSORS_ONLN);
+		return count > 0 ? (uint32_t)count : 1;
+#else
+		return 1;
+#endif
+	}
+
+	static inline bool threadSetAffinity(uint32_t _hwThread)
+	{
+		_hwThread %= threadGetNumHardwareThreads();
+#if RTM_PLATFORM_WINDOWS || RTM_PLATFORM_XBOXONE
+		return 0 != SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << (_hwThread % (sizeof(DWORD_PTR) * 8)));
+#elif (RTM_PLATFORM_LINUX || RTM_PLATFORM_ANDROID) && defined(CPU_SET)
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(_hwThread, &set);
+		return 0 == sched_setaffinity(0, sizeof(set), &set);
+#else
+		return false;
+#endif
+	}
+
 } // namespace rtm
 
 #endif // RTM_RBASE_THREAD_H
@@ -0,0 +1,215 @@
+//--------------------------------------------------------------------------//
+/// Copyright 2025 Milos Tosic. All Rights Reserved.                       ///
+/// License: http://www.opensource.org/licenses/BSD-2-Clause               ///
+//--------------------------------------------------------------------------//
+
+#ifndef RTM_RBASE_VIRTUALMEM_H
+#define RTM_RBASE_VIRTUALMEM_H
+
+#include <rbase/inc/platform.h>
+
+#if RTM_PLATFORM_WINDOWS
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+	#define RTM_VIRTUAL_MEMORY	1
+#elif RTM_PLATFORM_LINUX || RTM_PLATFORM_OSX || RTM_PLATFORM_ANDROID || RTM_PLATFORM_IOS
+	#include <sys/mman.h>
+	#include <unistd.h>
+	#define RTM_VIRTUAL_MEMORY	1
+#else
+	#define RTM_VIRTUAL_MEMORY	0
+#endif
+
+namespace rtm {
+
+	/// Returns granularity of commit and decommit operations.
+	///
+	/// @returns page size in bytes.
+	static inline size_t virtualMemPageSize();
+
+	/// Reserves a range of address space without backing it with memory.
+	///
+	/// @param[in] _size   : Size of the range in bytes
+	///
+	/// @returns start of the reserved range or 0 if reserving is not supported or failed.
+	static inline void* virtualMemReserve(size_t _size);
+
+	/// Backs part of a reserved range with read/write memory. Range is extended
+	/// to page boundaries. Newly committed memory is zero initialized.
+	///
+	/// @param[in] _ptr    : Start of the range to commit
+	/// @param[in] _size   : Size of the range in bytes
+	///
+	/// @returns true on success.
+	static inline bool virtualMemCommit(void* _ptr, size_t _size);
+
+	/// Returns memory backing part of a reserved range to the system, address
+	/// space stays reserved. Only whole pages inside the range are decommitted.
+	/// Huge page advice given for the range is dropped.
+	///
+	/// @param[in] _ptr    : Start of the range to decommit
+	/// @param[in] _size   : Size of the range in bytes
+	static inline void virtualMemDecommit(void* _ptr, size_t _size);
+
+	/// Releases a reserved range.
+	///
+	/// @param[in] _ptr    : Start of the range, as returned by virtualMemReserve
+	/// @param[in] _size   : Size of the range, as passed to virtualMemReserve
+	static inline void virtualMemRelease(void* _ptr, size_t _size);
+
+	/// Asks the system to back a reserved range with huge pages where possible.
+	///
+	/// @param[in] _ptr    : Start of the range
+	/// @param[in] _size   : Size of the range in bytes
+	///
+	/// @returns true if the request was accepted.
+	static inline bool virtualMemAdviseHugePages(void* _ptr, size_t _size);
+
+} // namespace rtm
+
+/// ---------------------------------------------------------------------- ///
+///  Implementation                                                        ///
+/// ---------------------------------------------------------------------- ///
+
+namespace rtm {
+
+	namespace virtualmem_private {
+
+		static inline uintptr_t pageFloor(uintptr_t _address)
+		{
+			return _address & ~uintptr_t(virtualMemPageSize() - 1);
+		}
+
+		static inline uintptr_t pageCeil(uintptr_t _address)
+		{
+			return pageFloor(_address + virtualMemPageSize() - 1);
+		}
+
+	} // namespace virtualmem_private
+
+#if RTM_PLATFORM_WINDOWS
+
+	static inline size_t virtualMemPageSize()
+	{
+		static size_t pageSize = 0;
+		if (!pageSize)
+		{
+			SYSTEM_INFO info;
+			GetSystemInfo(&info);
+			pageSize = info.dwPageSize;
+		}
+		return pageSize;
+	}
+
+	static inline void* virtualMemReserve(size_t _size)
+	{
+		return VirtualAlloc(0, _size, MEM_RESERVE, PAGE_NOACCESS);
+	}
+
+	static inline bool virtualMemCommit(void* _ptr, size_t _size)
+	{
+		const uintptr_t start	= virtualmem_private::pageFloor((uintptr_t)_ptr);
+		const uintptr_t end		= virtualmem_private::pageCeil((uintptr_t)_ptr + _size);
+		return VirtualAlloc((void*)start, end - start, MEM_COMMIT, PAGE_READWRITE) != 0;
+	}
+
+	static inline void virtualMemDecommit(void* _ptr, size_t _size)
+	{
+		const uintptr_t start	= virtualmem_private::pageCeil((uintptr_t)_ptr);
+		const uintptr_t end		= virtualmem_private::pageFloor((uintptr_t)_ptr + _size);
+		if (start < end)
+			VirtualFree((void*)start, end - start, MEM_DECOMMIT);
+	}
+
+	static inline void virtualMemRelease(void* _ptr, size_t /*_size*/)
+	{
+		VirtualFree(_ptr, 0, MEM_RELEASE);
+	}
+
+	static inline bool virtualMemAdviseHugePages(void* /*_ptr*/, size_t /*_size*/)
+	{
+		// large pages need SeLockMemoryPrivilege and have to be requested when committing
+		return false;
+	}
+
+#elif RTM_VIRTUAL_MEMORY
+
+	static inline size_t virtualMemPageSize()
+	{
+		static const size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+		return pageSize;
+	}
+
+	static inline void* virtualMemReserve(size_t _size)
+	{
+		void* ptr = mmap(0, _size, PROT_NONE, MAP_PRIVATE | MAP_ANON | MAP_NORESERVE, -1, 0);
+		return ptr == MAP_FAILED ? 0 : ptr;
+	}
+
+	static inline bool virtualMemCommit(void* _ptr, size_t _size)
+	{
+		const uintptr_t start	= virtualmem_private::pageFloor((uintptr_t)_ptr);
+		const uintptr_t end		= virtualmem_private::pageCeil((uintptr_t)_ptr + _size);
+		return 0 == mprotect((void*)start, end - start, PROT_READ | PROT_WRITE);
+	}
+
+	static inline void virtualMemDecommit(void* _ptr, size_t _size)
+	{
+		const uintptr_t start	= virtualmem_private::pageCeil((uintptr_t)_ptr);
+		const uintptr_t end		= virtualmem_private::pageFloor((uintptr_t)_ptr + _size);
+
+		// mapping over the range drops its pages and keeps address space reserved
+		if (start < end)
+			mmap((void*)start, end - start, PROT_NONE, MAP_FIXED | MAP_PRIVATE | MAP_ANON | MAP_NORESERVE, -1, 0);
+	}
+
+	static inline void virtualMemRelease(void* _ptr, size_t _size)
+	{
+		munmap(_ptr, _size);
+	}
+
+	static inline bool virtualMemAdviseHugePages(void* _ptr, size_t _size)
+	{
+#if defined(MADV_HUGEPAGE)
+		return 0 == madvise(_ptr, _size, MADV_HUGEPAGE);
+#else
+		RTM_UNUSED_2(_ptr, _size);
+		return false;
+#endif
+	}
+
+#else
+
+	static inline size_t virtualMemPageSize()
+	{
+		return 4096;
+	}
+
+	static inline void* virtualMemReserve(size_t /*_size*/)
+	{
+		return 0;
+	}
+
+	static inline bool virtualMemCommit(void* /*_ptr*/, size_t /*_size*/)
+	{
+		return false;
+	}
+
+	static inline void virtualMemDecommit(void* /*_ptr*/, size_t /*_size*/)
+	{
+	}
+
+	static inline void virtualMemRelease(void* /*_ptr*/, size_t /*_size*/)
+	{
+	}
+
+	static inline bool virtualMemAdviseHugePages(void* /*_ptr*/, size_t /*_size*/)
+	{
+		return false;
+	}
+
+#endif
+
+} // namespace rtm
+
+#endif // RTM_RBASE_VIRTUALMEM_H
@@ -859,4 +859,92 @@ int64_t fileWriteIfDifferent(FileStorage _type, const char* _path, const void* _
 	return (int64_t)_dataSize;
 }
 
+int64_t fileHash(FileStorage _type, const char* _path, HashAlgorithm::Enum _algorithm, void* _hash)
+{
+	const int64_t BufferSize = 16 * 1024;
+
+	int64_t ret = -1;
+	FileReaderHandle frh = fileReaderCreate(_type);
+	if (fileHandleIsValid(frh))
+	{
+		if (FileStatus::FAIL != fileReaderOpen(frh, _path))
+		{
+			const int64_t size = fileReaderGetSize(frh);
+			uint8_t buffer[BufferSize];
+
+			HasherMurmur3	murmur3;
+			HasherCity64	city64;
+			HasherMD5		md5;
+
+			bool valid = size >= 0;
+			switch (_algorithm)
+			{
+			case HashAlgorithm::Murmur3:
+				murmur3.init();
+				break;
+
+			case HashAlgorithm::City64:
+				{
+					// City hash needs the tail of the file before the rest of the data
+					const int64_t tailSize = size < 64 ? size : 64;
+					valid = valid && (fileReaderSeek(frh, size - tailSize, FileSeek::SET) == size - tailSize);
+					valid = valid && (fileReaderRead(frh, buffer, tailSize) == tailSize);
+					valid = valid && (fileReaderSeek(frh, 0, FileSeek::SET) == 0);
+					if (valid)
+						city64.init(uint64_t(size), buffer);
+				}
+				break;
+
+			case HashAlgorithm::MD5:
+				md5.init();
+				break;
+
+			default:
+				valid = false;
+			};
+
+			int64_t hashed = 0;
+			while (valid && (hashed < size))
+			{
+				const int64_t toRead = size - hashed < BufferSize ? size - hashed : BufferSize;
+				const int64_t read = fileReaderRead(frh, buffer, toRead);
+				if (read <= 0)
+				{
+					valid = false;
+					break;
+				}
+
+				switch (_algorithm)
+				{
+				case HashAlgorithm::Murmur3:	murmur3.update(buffer, (uint32_t)read);	break;
+				case HashAlgorithm::City64:		city64.update(buffer, (uint32_t)read);	break;
+				case HashAlgorithm::MD5:		md5.update(buffer, (uint32_t)read);		break;
+				default:						break;
+				};
+
+				hashed += read;
+			}
+
+			if (valid)
+			{
+				switch (_algorithm)
+				{
+				case HashAlgorithm::Murmur3:	*(uint32_t*)_hash = murmur3.finalize();	break;
+				case HashAlgorithm::City64:		*(uint64_t*)_hash = city64.finalize();	break;
+				case HashAlgorithm::MD5:		md5.finalize((uint8_t*)_hash);			break;
+				default:						break;
+				};
+
+				ret = hashed;
+			}
+
+			fileReaderClose(frh);
+		}
+
+		fileReaderDestroy(frh);
+	}
+
+	return ret;
+}
+
 } // namespace rtm
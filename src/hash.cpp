@@ -7,6 +7,7 @@
 
 #include <rbase/inc/hash.h>
 #include <rbase/inc/stringfn.h>
+#include <rbase/src/hash_lanes.h>
 
 static uint64_t UNALIGNED_LOAD64(const char* p)
 {
@@ -448,4 +449,619 @@ uint64_t hashCity64(const void* _key, uint32_t _len, uint64_t seed)
 	return CityHash64WithSeeds(s, _len, k2, seed);
 }
 
+enum CityState
+{
+	CityX,
+	CityY,
+	CityZ,
+	CityV0,
+	CityV1,
+	CityW0,
+	CityW1
+};
+
+// Number of leading bytes consumed by the main loop of hashCity64, the rest is covered by the tail.
+static inline uint64_t cityBodyLength(uint64_t _len)
+{
+	return _len > 64 ? (_len - 1) & ~uint64_t(63) : 0;
+}
+
+static inline void cityChunk(uint64_t* _state, const char* s, bool _first)
+{
+	uint64_t x = _state[CityX];
+	uint64_t y = _state[CityY];
+	uint64_t z = _state[CityZ];
+	uint128_t v(_state[CityV0], _state[CityV1]);
+	uint128_t w(_state[CityW0], _state[CityW1]);
+
+	if (_first)
+		x = x * k1 + Fetch64(s);
+
+	x = Rotate(x + y + v.first + Fetch64(s + 8), 37) * k1;
+	y = Rotate(y + v.second + Fetch64(s + 48), 42) * k1;
+	x ^= w.second;
+	y += v.first + Fetch64(s + 40);
+	z = Rotate(z + w.first, 33) * k1;
+	v = WeakHashLen32WithSeeds(s, v.second * k1, x + w.first);
+	w = WeakHashLen32WithSeeds(s + 32, z + w.second, y + Fetch64(s + 16));
+	SwapValues(z, x);
+
+	_state[CityX]	= x;
+	_state[CityY]	= y;
+	_state[CityZ]	= z;
+	_state[CityV0]	= v.first;
+	_state[CityV1]	= v.second;
+	_state[CityW0]	= w.first;
+	_state[CityW1]	= w.second;
+}
+
+void HasherCity64::init(uint64_t _length, const void* _tail)
+{
+	m_length		= _length;
+	m_fed			= 0;
+	m_bufferSize	= 0;
+
+	if (_length <= 64)
+	{
+		// short inputs are hashed in one go from the tail, updates only advance the count
+		m_state[0] = hashCity64(_tail, (uint32_t)_length);
+		return;
+	}
+
+	// same setup as in hashCity64, with s pointing to the last 64 bytes of input
+	const char* s = (const char*)_tail;
+	uint64_t x = Fetch64(s + 24);
+	uint64_t y = Fetch64(s + 48) + Fetch64(s + 8);
+	uint64_t z = HashLen16(Fetch64(s + 16) + _length, Fetch64(s + 40));
+	uint128_t v = WeakHashLen32WithSeeds(s, _length, z);
+	uint128_t w = WeakHashLen32WithSeeds(s + 32, y + k1, x);
+
+	m_state[CityX]	= x;
+	m_state[CityY]	= y;
+	m_state[CityZ]	= z;
+	m_state[CityV0]	= v.first;
+	m_state[CityV1]	= v.second;
+	m_state[CityW0]	= w.first;
+	m_state[CityW1]	= w.second;
+}
+
+void HasherCity64::update(const void* _data, uint32_t _size)
+{
+	const char* data = (const char*)_data;
+
+	const uint64_t body = cityBodyLength(m_length);
+	uint64_t size = m_fed < body ? body - m_fed : 0;
+	size = _size < size ? _size : size;
+
+	// offset of the next chunk to be processed, the first one needs extra mixing
+	uint64_t offset = m_fed - m_bufferSize;
+	m_fed += _size;
+
+	if (m_bufferSize && size)
+	{
+		const uint32_t copy = uint32_t(size < 64 - m_bufferSize ? size : 64 - m_bufferSize);
+		memCopy(m_buffer + m_bufferSize, sizeof(m_buffer) - m_bufferSize, data, copy);
+		m_bufferSize	+= copy;
+		data			+= copy;
+		size			-= copy;
+
+		if (m_bufferSize < 64)
+			return;
+
+		cityChunk(m_state, (const char*)m_buffer, offset == 0);
+		offset		+= 64;
+		m_bufferSize = 0;
+	}
+
+	while (size >= 64)
+	{
+		cityChunk(m_state, data, offset == 0);
+		offset	+= 64;
+		data	+= 64;
+		size	-= 64;
+	}
+
+	if (size)
+	{
+		memCopy(m_buffer, sizeof(m_buffer), data, (uint32_t)size);
+		m_bufferSize = (uint32_t)size;
+	}
+}
+
+uint64_t HasherCity64::finalize()
+{
+	RTM_ASSERT(m_fed == m_length, "Number of bytes hashed does not match the length passed to init!");
+
+	if (m_length <= 64)
+		return m_state[0];
+
+	const uint64_t x = m_state[CityX];
+	const uint64_t y = m_state[CityY];
+	const uint64_t z = m_state[CityZ];
+
+	return HashLen16(HashLen16(m_state[CityV0], m_state[CityW0]) + ShiftMix(y) * k1 + z,
+		HashLen16(m_state[CityV1], m_state[CityW1]) + x);
+}
+
+uint64_t HasherCity64::finalize(uint64_t _seed)
+{
+	return HashLen16(finalize() - k2, _seed);
+}
+
+//--------------------------------------------------------------------------
+/// Fast hash, XXH3 style. Long inputs are consumed in 64 byte stripes by 8
+/// independent 64bit accumulators, which map directly to SIMD registers.
+/// Output is not compatible with XXH3.
+//--------------------------------------------------------------------------
+
+static const uint64_t s_fastPrime64_1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t s_fastPrime64_2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t s_fastPrime64_3 = 0x165667B19E3779F9ULL;
+static const uint64_t s_fastPrime64_4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64_t s_fastPrime64_5 = 0x27D4EB2F165667C5ULL;
+static const uint32_t s_fastPrime32_1 = 0x9E3779B1U;
+static const uint32_t s_fastPrime32_2 = 0x85EBCA77U;
+static const uint32_t s_fastPrime32_3 = 0xC2B2AE3DU;
+
+// Key material is read at byte offsets, the last stripe and the merge step use
+// offsets that are not multiples of 8 so that their keys differ from stripe keys.
+enum
+{
+	FastSecretSize			= 192,
+	FastStripeSize			= 64,
+	FastStripesPerBlock		= (FastSecretSize - FastStripeSize) / 8,
+	FastBlockSize			= FastStripesPerBlock * FastStripeSize,
+	FastScrambleOffset		= FastSecretSize - FastStripeSize,
+	FastLastStripeOffset	= FastSecretSize - FastStripeSize - 7,
+	FastMergeOffsetLow		= 11,
+	FastMergeOffsetHigh		= FastSecretSize - FastStripeSize - 11
+};
+
+RTM_ALIGN(64) static const uint64_t s_fastSecret[FastSecretSize / 8] =
+{
+	0x8c9ff21eb4943e94ULL, 0x529bcfd80991254cULL, 0x12b8eb6d931b5e6eULL, 0xcec50c5d0c1fcc21ULL,
+	0x31f5796e26ef1ca1ULL, 0x6fad0e5ad91dff82ULL, 0x061c22c6f5405433ULL, 0xacebed3be37886a1ULL,
+	0x0d81e8485a2713a6ULL, 0xa3e600f8f1fd238cULL, 0xef1382c779e55f8eULL, 0xfe2c41ff60885d40ULL,
+	0x94cbb826dac34bb2ULL, 0xb502428724a731f6ULL, 0xd0bec29520b72715ULL, 0x81335f7cacfebd80ULL,
+	0xe34be0aababd1d08ULL, 0x25c86b4d7ef8431aULL, 0x889c2b2a461ffb7eULL, 0x6a810fe6190b977eULL,
+	0xa24c7ba4f2058340ULL, 0xba5c108702350f86ULL, 0x73b2efd68e1c6856ULL, 0xc539d9c263ee450aULL
+};
+
+static inline uint64_t fastMul128(uint64_t _a, uint64_t _b, uint64_t* _high)
+{
+#if RTM_COMPILER_MSVC && RTM_CPU_X86 && RTM_64BIT
+	return _umul128(_a, _b, _high);
+#elif (RTM_COMPILER_GCC || RTM_COMPILER_CLANG) && RTM_64BIT
+	const unsigned __int128 r = (unsigned __int128)_a * _b;
+	*_high = (uint64_t)(r >> 64);
+	return (uint64_t)r;
+#else
+	const uint64_t ll = (_a & 0xffffffff) * (_b & 0xffffffff);
+	const uint64_t hl = (_a >> 32) * (_b & 0xffffffff);
+	const uint64_t lh = (_a & 0xffffffff) * (_b >> 32);
+	const uint64_t hh = (_a >> 32) * (_b >> 32);
+	const uint64_t cross = (ll >> 32) + (hl & 0xffffffff) + lh;
+	*_high = (hl >> 32) + (cross >> 32) + hh;
+	return (cross << 32) | (ll & 0xffffffff);
+#endif
+}
+
+static inline uint64_t fastFold64(uint64_t _a, uint64_t _b)
+{
+	uint64_t high;
+	const uint64_t low = fastMul128(_a, _b, &high);
+	return low ^ high;
+}
+
+static inline uint64_t fastAvalanche(uint64_t _h)
+{
+	_h ^= _h >> 37;
+	_h *= 0x165667919E3779F9ULL;
+	_h ^= _h >> 32;
+	return _h;
+}
+
+// Returns key for the given 64bit lane, seed is added to even and subtracted from odd lanes.
+static inline uint64_t fastKey(uint32_t _offset, uint32_t _lane, uint64_t _seed)
+{
+	return mem_private::load64((const uint8_t*)s_fastSecret + _offset + _lane * 8) + ((_lane & 1) ? 0 - _seed : _seed);
+}
+
+static inline uint64_t fastMix16(const uint8_t* _data, uint32_t _offset, uint64_t _seed)
+{
+	return fastFold64(mem_private::load64(_data)     ^ fastKey(_offset, 0, _seed),
+	                  mem_private::load64(_data + 8) ^ fastKey(_offset, 1, _seed));
+}
+
+// Packs up to 16 bytes into two words, every input byte and the length affect the result.
+static inline void fastLoadShort(const uint8_t* _data, uint32_t _len, uint64_t& _a, uint64_t& _b)
+{
+	if (_len > 8)
+	{
+		_a = mem_private::load64(_data);
+		_b = mem_private::load64(_data + _len - 8);
+	}
+	else
+	if (_len >= 4)
+	{
+		const uint64_t first = mem_private::load32(_data);
+		const uint64_t last  = mem_private::load32(_data + _len - 4);
+		_a = (first << 32) | last;
+		_b = (last << 32) | first;
+	}
+	else
+	if (_len)
+	{
+		const uint32_t c = (uint32_t(_data[0]) << 16) | (uint32_t(_data[_len >> 1]) << 24) | uint32_t(_data[_len - 1]) | (_len << 8);
+		_a = c;
+		_b = rotl32(bswap_32(c), 13);
+	}
+	else
+	{
+		_a = 0;
+		_b = 0;
+	}
+}
+
+static inline uint64_t fastShort(uint64_t _a, uint64_t _b, uint32_t _len, uint32_t _offset, uint64_t _seed)
+{
+	const uint64_t lo = _a ^ fastKey(_offset, 0, _seed);
+	const uint64_t hi = _b ^ fastKey(_offset, 1, _seed);
+	return fastAvalanche(_len + bswap_64(lo) + hi + fastFold64(lo, hi));
+}
+
+#if RTM_SIMD_AVX2
+
+static inline void fastAccumulate(uint64_t* _acc, const uint8_t* _data, uint32_t _offset, uint64_t _seed)
+{
+	const __m256i seed = _mm256_set_epi64x(int64_t(0 - _seed), int64_t(_seed), int64_t(0 - _seed), int64_t(_seed));
+	for (uint32_t i=0; i<2; ++i)
+	{
+		__m256i*      acc  = (__m256i*)_acc + i;
+		const __m256i data = _mm256_loadu_si256((const __m256i*)_data + i);
+		const __m256i key  = _mm256_add_epi64(_mm256_loadu_si256((const __m256i*)((const uint8_t*)s_fastSecret + _offset) + i), seed);
+		const __m256i dk   = _mm256_xor_si256(data, key);
+		const __m256i prod = _mm256_mul_epu32(dk, _mm256_srli_epi64(dk, 32));
+		const __m256i swap = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+		_mm256_store_si256(acc, _mm256_add_epi64(_mm256_load_si256(acc), _mm256_add_epi64(prod, swap)));
+	}
+}
+
+static inline void fastScramble(uint64_t* _acc, uint64_t _seed)
+{
+	const __m256i seed  = _mm256_set_epi64x(int64_t(0 - _seed), int64_t(_seed), int64_t(0 - _seed), int64_t(_seed));
+	const __m256i prime = _mm256_set1_epi32(int32_t(s_fastPrime32_1));
+	for (uint32_t i=0; i<2; ++i)
+	{
+		__m256i* acc = (__m256i*)_acc + i;
+		__m256i  a   = _mm256_load_si256(acc);
+		a = _mm256_xor_si256(a, _mm256_srli_epi64(a, 47));
+		a = _mm256_xor_si256(a, _mm256_add_epi64(_mm256_loadu_si256((const __m256i*)((const uint8_t*)s_fastSecret + FastScrambleOffset) + i), seed));
+		const __m256i lo = _mm256_mul_epu32(a, prime);
+		const __m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), prime);
+		_mm256_store_si256(acc, _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32)));
+	}
+}
+
+#elif RTM_SIMD_SSE2
+
+static inline void fastAccumulate(uint64_t* _acc, const uint8_t* _data, uint32_t _offset, uint64_t _seed)
+{
+	const __m128i seed = _mm_set_epi64x(int64_t(0 - _seed), int64_t(_seed));
+	for (uint32_t i=0; i<4; ++i)
+	{
+		__m128i*      acc  = (__m128i*)_acc + i;
+		const __m128i data = _mm_loadu_si128((const __m128i*)_data + i);
+		const __m128i key  = _mm_add_epi64(_mm_loadu_si128((const __m128i*)((const uint8_t*)s_fastSecret + _offset) + i), seed);
+		const __m128i dk   = _mm_xor_si128(data, key);
+		const __m128i prod = _mm_mul_epu32(dk, _mm_srli_epi64(dk, 32));
+		const __m128i swap = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+		_mm_store_si128(acc, _mm_add_epi64(_mm_load_si128(acc), _mm_add_epi64(prod, swap)));
+	}
+}
+
+static inline void fastScramble(uint64_t* _acc, uint64_t _seed)
+{
+	const __m128i seed  = _mm_set_epi64x(int64_t(0 - _seed), int64_t(_seed));
+	const __m128i prime = _mm_set1_epi32(int32_t(s_fastPrime32_1));
+	for (uint32_t i=0; i<4; ++i)
+	{
+		__m128i* acc = (__m128i*)_acc + i;
+		__m128i  a   = _mm_load_si128(acc);
+		a = _mm_xor_si128(a, _mm_srli_epi64(a, 47));
+		a = _mm_xor_si128(a, _mm_add_epi64(_mm_loadu_si128((const __m128i*)((const uint8_t*)s_fastSecret + FastScrambleOffset) + i), seed));
+		const __m128i lo = _mm_mul_epu32(a, prime);
+		const __m128i hi = _mm_mul_epu32(_mm_srli_epi64(a, 32), prime);
+		_mm_store_si128(acc, _mm_add_epi64(lo, _mm_slli_epi64(hi, 32)));
+	}
+}
+
+#elif RTM_SIMD_NEON
+
+static inline void fastAccumulate(uint64_t* _acc, const uint8_t* _data, uint32_t _offset, uint64_t _seed)
+{
+	const uint64_t seedPair[2] = { _seed, 0 - _seed };
+	const uint64x2_t seed = vld1q_u64(seedPair);
+	for (uint32_t i=0; i<4; ++i)
+	{
+		const uint64x2_t data = vreinterpretq_u64_u8(vld1q_u8(_data + i * 16));
+		const uint64x2_t key  = vaddq_u64(vreinterpretq_u64_u8(vld1q_u8((const uint8_t*)s_fastSecret + _offset + i * 16)), seed);
+		const uint64x2_t dk   = veorq_u64(data, key);
+		const uint64x2_t prod = vmull_u32(vmovn_u64(dk), vshrn_n_u64(dk, 32));
+		const uint64x2_t swap = vextq_u64(data, data, 1);
+		vst1q_u64(_acc + i * 2, vaddq_u64(vld1q_u64(_acc + i * 2), vaddq_u64(prod, swap)));
+	}
+}
+
+static inline void fastScramble(uint64_t* _acc, uint64_t _seed)
+{
+	const uint64_t seedPair[2] = { _seed, 0 - _seed };
+	const uint64x2_t seed  = vld1q_u64(seedPair);
+	const uint32x2_t prime = vdup_n_u32(s_fastPrime32_1);
+	for (uint32_t i=0; i<4; ++i)
+	{
+		uint64x2_t a = vld1q_u64(_acc + i * 2);
+		a = veorq_u64(a, vshrq_n_u64(a, 47));
+		a = veorq_u64(a, vaddq_u64(vld1q_u64(s_fastSecret + FastScrambleOffset / 8 + i * 2), seed));
+		const uint64x2_t hi = vshlq_n_u64(vmull_u32(vshrn_n_u64(a, 32), prime), 32);
+		vst1q_u64(_acc + i * 2, vmlal_u32(hi, vmovn_u64(a), prime));
+	}
+}
+
+#else
+
+static inline void fastAccumulate(uint64_t* _acc, const uint8_t* _data, uint32_t _offset, uint64_t _seed)
+{
+	for (uint32_t i=0; i<8; ++i)
+	{
+		const uint64_t data = mem_private::load64(_data + i * 8);
+		const uint64_t dk   = data ^ fastKey(_offset, i, _seed);
+		_acc[i ^ 1] += data;
+		_acc[i]     += (dk & 0xffffffff) * (dk >> 32);
+	}
+}
+
+static inline void fastScramble(uint64_t* _acc, uint64_t _seed)
+{
+	for (uint32_t i=0; i<8; ++i)
+	{
+		uint64_t a = _acc[i];
+		a ^= a >> 47;
+		a ^= fastKey(FastScrambleOffset, i, _seed);
+		_acc[i] = a * s_fastPrime32_1;
+	}
+}
+
+#endif // RTM_SIMD_AVX2
+
+static inline void fastLong(uint64_t* _acc, const uint8_t* _data, uint32_t _len, uint64_t _seed)
+{
+	_acc[0] = s_fastPrime32_3;
+	_acc[1] = s_fastPrime64_1;
+	_acc[2] = s_fastPrime64_2;
+	_acc[3] = s_fastPrime64_3;
+	_acc[4] = s_fastPrime64_4;
+	_acc[5] = s_fastPrime32_2;
+	_acc[6] = s_fastPrime64_5;
+	_acc[7] = s_fastPrime32_1;
+
+	const uint32_t numBlocks = (_len - 1) / FastBlockSize;
+	for (uint32_t b=0; b<numBlocks; ++b)
+	{
+		const uint8_t* block = _data + b * FastBlockSize;
+		for (uint32_t s=0; s<FastStripesPerBlock; ++s)
+			fastAccumulate(_acc, block + s * FastStripeSize, s * 8, _seed);
+		fastScramble(_acc, _seed);
+	}
+
+	// last partial block, the final stripe always covers the last 64 bytes of input
+	const uint8_t* block = _data + numBlocks * FastBlockSize;
+	const uint32_t numStripes = ((_len - 1) - numBlocks * FastBlockSize) / FastStripeSize;
+	for (uint32_t s=0; s<numStripes; ++s)
+		fastAccumulate(_acc, block + s * FastStripeSize, s * 8, _seed);
+
+	fastAccumulate(_acc, _data + _len - FastStripeSize, FastLastStripeOffset, _seed);
+}
+
+static inline uint64_t fastMerge(const uint64_t* _acc, uint32_t _offset, uint64_t _start, uint64_t _seed)
+{
+	uint64_t result = _start;
+	for (uint32_t i=0; i<4; ++i)
+		result += fastFold64(_acc[i * 2] ^ fastKey(_offset, i * 2, _seed), _acc[i * 2 + 1] ^ fastKey(_offset, i * 2 + 1, _seed));
+	return fastAvalanche(result);
+}
+
+uint64_t hashFast64(const void* _key, uint32_t _len, uint64_t _seed)
+{
+	const uint8_t* data = (const uint8_t*)_key;
+
+	if (_len <= 16)
+	{
+		uint64_t a, b;
+		fastLoadShort(data, _len, a, b);
+		return fastShort(a, b, _len, 24, _seed);
+	}
+
+	if (_len <= 128)
+	{
+		uint64_t acc = _len * s_fastPrime64_1;
+		const uint32_t numPairs = (_len - 1) / 32 + 1;
+		for (uint32_t i=0; i<numPairs; ++i)
+		{
+			acc += fastMix16(data + i * 16, i * 32, _seed);
+			acc += fastMix16(data + _len - 16 - i * 16, i * 32 + 16, _seed);
+		}
+		return fastAvalanche(acc);
+	}
+
+	RTM_ALIGN(64) uint64_t acc[8];
+	fastLong(acc, data, _len, _seed);
+	return fastMerge(acc, FastMergeOffsetLow, _len * s_fastPrime64_1, _seed);
+}
+
+void hashFast128(const void* _key, uint32_t _len, uint64_t _hash[2], uint64_t _seed)
+{
+	const uint8_t* data = (const uint8_t*)_key;
+
+	if (_len <= 16)
+	{
+		uint64_t a, b;
+		fastLoadShort(data, _len, a, b);
+		_hash[0] = fastShort(a, b, _len, 8, _seed);
+		_hash[1] = fastShort(b, a, _len, 40, _seed);
+		return;
+	}
+
+	if (_len <= 128)
+	{
+		uint64_t low  = _len * s_fastPrime64_1;
+		uint64_t high = 0;
+		const uint32_t numPairs = (_len - 1) / 32 + 1;
+		for (uint32_t i=0; i<numPairs; ++i)
+		{
+			const uint8_t* front = data + i * 16;
+			const uint8_t* back  = data + _len - 16 - i * 16;
+			low  += fastMix16(front, i * 32, _seed);
+			low  ^= mem_private::load64(back) + mem_private::load64(back + 8);
+			high += fastMix16(back, i * 32 + 16, _seed);
+			high ^= mem_private::load64(front) + mem_private::load64(front + 8);
+		}
+
+		_hash[0] = fastAvalanche(low + high);
+		_hash[1] = 0 - fastAvalanche(low * s_fastPrime64_1 + high * s_fastPrime64_4 + (_len - _seed) * s_fastPrime64_2);
+		return;
+	}
+
+	RTM_ALIGN(64) uint64_t acc[8];
+	fastLong(acc, data, _len, _seed);
+	_hash[0] = fastMerge(acc, FastMergeOffsetLow, _len * s_fastPrime64_1, _seed);
+	_hash[1] = fastMerge(acc, FastMergeOffsetHigh, ~(_len * s_fastPrime64_2), _seed);
+}
+
+//--------------------------------------------------------------------------
+/// Batched hashing, each SIMD lane hashes an independent key
+//--------------------------------------------------------------------------
+
+namespace hash_private {
+
+	static inline Lanes murmur3Key(Lanes _k)
+	{
+		_k = lanesMul(_k, lanesSplat(0xcc9e2d51));
+		_k = lanesRotl(_k, 15);
+		return lanesMul(_k, lanesSplat(0x1b873593));
+	}
+
+	static inline void hashMurmur3Lanes(const uint8_t* const* _keys, const uint32_t* _lens, uint32_t* _hashes, uint32_t _seed)
+	{
+		uint32_t numBlocks[NumLanes];
+		uint32_t maxBlocks = 0;
+		for (uint32_t l=0; l<NumLanes; ++l)
+		{
+			numBlocks[l] = _lens[l] / 4;
+			maxBlocks = maxBlocks > numBlocks[l] ? maxBlocks : numBlocks[l];
+		}
+
+		const Lanes blocks = lanesLoad(numBlocks);
+		Lanes h1 = lanesSplat(_seed);
+
+		uint32_t k[NumLanes];
+		for (uint32_t b=0; b<maxBlocks; ++b)
+		{
+			for (uint32_t l=0; l<NumLanes; ++l)
+				k[l] = b < numBlocks[l] ? mem_private::load32(_keys[l] + b * 4) : 0;
+
+			Lanes h = lanesXor(h1, murmur3Key(lanesLoad(k)));
+			h = lanesRotl(h, 13);
+			h = lanesAdd(lanesMul(h, lanesSplat(5)), lanesSplat(0xe6546b64));
+
+			h1 = lanesSelect(lanesGreater(blocks, lanesSplat(b)), h, h1);
+		}
+
+		uint32_t tailSize[NumLanes];
+		for (uint32_t l=0; l<NumLanes; ++l)
+		{
+			const uint8_t* tail = _keys[l] + numBlocks[l] * 4;
+			tailSize[l] = _lens[l] & 3;
+			k[l] = 0;
+			switch (tailSize[l])
+			{
+			case 3: k[l] ^= tail[2] << 16;
+			        /* fall through */
+			case 2: k[l] ^= tail[1] << 8;
+			        /* fall through */
+			case 1: k[l] ^= tail[0];
+			};
+		}
+
+		const Lanes hasTail = lanesGreater(lanesLoad(tailSize), lanesSplat(0));
+		h1 = lanesSelect(hasTail, lanesXor(h1, murmur3Key(lanesLoad(k))), h1);
+
+		h1 = lanesXor(h1, lanesLoad(_lens));
+		h1 = lanesXor(h1, lanesShr(h1, 16));
+		h1 = lanesMul(h1, lanesSplat(0x85ebca6b));
+		h1 = lanesXor(h1, lanesShr(h1, 13));
+		h1 = lanesMul(h1, lanesSplat(0xc2b2ae35));
+		h1 = lanesXor(h1, lanesShr(h1, 16));
+
+		lanesStore(_hashes, h1);
+	}
+
+	static inline void hashStrLanes(const uint8_t* const* _strings, uint32_t* _hashes, uint32_t _maxChars)
+	{
+		const uint8_t* str[NumLanes];
+		uint32_t numAlive = 0;
+		for (uint32_t l=0; l<NumLanes; ++l)
+		{
+			str[l] = _strings[l];
+			numAlive += str[l] ? 1 : 0;
+		}
+
+		Lanes h = lanesSplat(0);
+
+		uint32_t c[NumLanes];
+		for (uint32_t i=0; numAlive && (i<_maxChars); ++i)
+		{
+			for (uint32_t l=0; l<NumLanes; ++l)
+			{
+				c[l] = str[l] ? str[l][i] : 0;
+				if (str[l] && !c[l])
+				{
+					str[l] = 0;
+					--numAlive;
+				}
+			}
+
+			const Lanes chars = lanesLoad(c);
+			h = lanesSelect(lanesGreater(chars, lanesSplat(0)), lanesAdd(lanesMul(h, lanesSplat(37)), chars), h);
+		}
+
+		lanesStore(_hashes, h);
+	}
+
+} // namespace hash_private
+
+void hashMurmur3Batch(const void* const* _keys, const uint32_t* _lens, uint32_t _count, uint32_t* _hashes, uint32_t _seed)
+{
+	using namespace hash_private;
+
+	uint32_t i = 0;
+	for (; i + NumLanes <= _count; i += NumLanes)
+		hashMurmur3Lanes((const uint8_t* const*)(_keys + i), _lens + i, _hashes + i, _seed);
+
+	for (; i < _count; ++i)
+		_hashes[i] = hashMurmur3(_keys[i], _lens[i], _seed);
+}
+
+void hashStrBatch(const char* const* _strings, uint32_t _count, uint32_t* _hashes, uint32_t _maxChars)
+{
+	using namespace hash_private;
+
+	uint32_t i = 0;
+	for (; i + NumLanes <= _count; i += NumLanes)
+		hashStrLanes((const uint8_t* const*)(_strings + i), _hashes + i, _maxChars);
+
+	for (; i < _count; ++i)
+		_hashes[i] = hashStr(_strings[i], _maxChars);
+}
+
 } // namespace rtm
@@ -0,0 +1,113 @@
+//--------------------------------------------------------------------------//
+/// Copyright 2025 Milos Tosic. All Rights Reserved.                       ///
+/// License: http://www.opensource.org/licenses/BSD-2-Clause               ///
+//--------------------------------------------------------------------------//
+/// File: hash_lanes.h                                                     ///
+/// Desc:                                                                  ///
+/// 32bit SIMD lane helpers used to hash several independent streams at    ///
+/// once, one stream per lane.                                             ///
+//--------------------------------------------------------------------------//
+
+#ifndef RTM_RBASE_HASH_LANES_H
+#define RTM_RBASE_HASH_LANES_H
+
+#include <rbase/inc/stringfn.h>
+
+namespace rtm {
+namespace hash_private {
+
+#if RTM_SIMD_AVX2
+
+	typedef __m256i Lanes;
+	enum { NumLanes = 8 };
+
+	static inline Lanes lanesLoad(const uint32_t* _src)				{ return _mm256_loadu_si256((const __m256i*)_src); }
+	static inline void  lanesStore(uint32_t* _dst, Lanes _v)			{ _mm256_storeu_si256((__m256i*)_dst, _v); }
+	static inline Lanes lanesSplat(uint32_t _v)						{ return _mm256_set1_epi32(int32_t(_v)); }
+	static inline Lanes lanesAdd(Lanes _a, Lanes _b)				{ return _mm256_add_epi32(_a, _b); }
+	static inline Lanes lanesXor(Lanes _a, Lanes _b)				{ return _mm256_xor_si256(_a, _b); }
+	static inline Lanes lanesAnd(Lanes _a, Lanes _b)				{ return _mm256_and_si256(_a, _b); }
+	static inline Lanes lanesOr(Lanes _a, Lanes _b)					{ return _mm256_or_si256(_a, _b); }
+	static inline Lanes lanesNot(Lanes _a)							{ return _mm256_xor_si256(_a, _mm256_set1_epi32(-1)); }
+	static inline Lanes lanesMul(Lanes _a, Lanes _b)				{ return _mm256_mullo_epi32(_a, _b); }
+	static inline Lanes lanesShl(Lanes _a, int _n)					{ return _mm256_sll_epi32(_a, _mm_cvtsi32_si128(_n)); }
+	static inline Lanes lanesShr(Lanes _a, int _n)					{ return _mm256_srl_epi32(_a, _mm_cvtsi32_si128(_n)); }
+	static inline Lanes lanesGreater(Lanes _a, Lanes _b)			{ return _mm256_cmpgt_epi32(_a, _b); }
+	static inline Lanes lanesSelect(Lanes _mask, Lanes _a, Lanes _b)	{ return _mm256_blendv_epi8(_b, _a, _mask); }
+
+#elif RTM_SIMD_SSE2
+
+	typedef __m128i Lanes;
+	enum { NumLanes = 4 };
+
+	static inline Lanes lanesLoad(const uint32_t* _src)				{ return _mm_loadu_si128((const __m128i*)_src); }
+	static inline void  lanesStore(uint32_t* _dst, Lanes _v)			{ _mm_storeu_si128((__m128i*)_dst, _v); }
+	static inline Lanes lanesSplat(uint32_t _v)						{ return _mm_set1_epi32(int32_t(_v)); }
+	static inline Lanes lanesAdd(Lanes _a, Lanes _b)				{ return _mm_add_epi32(_a, _b); }
+	static inline Lanes lanesXor(Lanes _a, Lanes _b)				{ return _mm_xor_si128(_a, _b); }
+	static inline Lanes lanesAnd(Lanes _a, Lanes _b)				{ return _mm_and_si128(_a, _b); }
+	static inline Lanes lanesOr(Lanes _a, Lanes _b)					{ return _mm_or_si128(_a, _b); }
+	static inline Lanes lanesNot(Lanes _a)							{ return _mm_xor_si128(_a, _mm_set1_epi32(-1)); }
+	static inline Lanes lanesShl(Lanes _a, int _n)					{ return _mm_sll_epi32(_a, _mm_cvtsi32_si128(_n)); }
+	static inline Lanes lanesShr(Lanes _a, int _n)					{ return _mm_srl_epi32(_a, _mm_cvtsi32_si128(_n)); }
+	static inline Lanes lanesGreater(Lanes _a, Lanes _b)			{ return _mm_cmpgt_epi32(_a, _b); }
+	static inline Lanes lanesSelect(Lanes _mask, Lanes _a, Lanes _b)	{ return _mm_or_si128(_mm_and_si128(_mask, _a), _mm_andnot_si128(_mask, _b)); }
+
+	static inline Lanes lanesMul(Lanes _a, Lanes _b)
+	{
+		// no 32bit multiply in SSE2, multiply even and odd lanes separately
+		const __m128i even	= _mm_mul_epu32(_a, _b);
+		const __m128i odd	= _mm_mul_epu32(_mm_srli_epi64(_a, 32), _mm_srli_epi64(_b, 32));
+		return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+	}
+
+#elif RTM_SIMD_NEON
+
+	typedef uint32x4_t Lanes;
+	enum { NumLanes = 4 };
+
+	static inline Lanes lanesLoad(const uint32_t* _src)				{ return vld1q_u32(_src); }
+	static inline void  lanesStore(uint32_t* _dst, Lanes _v)			{ vst1q_u32(_dst, _v); }
+	static inline Lanes lanesSplat(uint32_t _v)						{ return vdupq_n_u32(_v); }
+	static inline Lanes lanesAdd(Lanes _a, Lanes _b)				{ return vaddq_u32(_a, _b); }
+	static inline Lanes lanesXor(Lanes _a, Lanes _b)				{ return veorq_u32(_a, _b); }
+	static inline Lanes lanesAnd(Lanes _a, Lanes _b)				{ return vandq_u32(_a, _b); }
+	static inline Lanes lanesOr(Lanes _a, Lanes _b)					{ return vorrq_u32(_a, _b); }
+	static inline Lanes lanesNot(Lanes _a)							{ return vmvnq_u32(_a); }
+	static inline Lanes lanesMul(Lanes _a, Lanes _b)				{ return vmulq_u32(_a, _b); }
+	static inline Lanes lanesShl(Lanes _a, int _n)					{ return vshlq_u32(_a, vdupq_n_s32(_n)); }
+	static inline Lanes lanesShr(Lanes _a, int _n)					{ return vshlq_u32(_a, vdupq_n_s32(-_n)); }
+	static inline Lanes lanesGreater(Lanes _a, Lanes _b)			{ return vreinterpretq_u32_s32(vreinterpretq_s32_u32(vcgtq_s32(vreinterpretq_s32_u32(_a), vreinterpretq_s32_u32(_b)))); }
+	static inline Lanes lanesSelect(Lanes _mask, Lanes _a, Lanes _b)	{ return vbslq_u32(_mask, _a, _b); }
+
+#else
+
+	// no SIMD, interleaving independent streams still hides instruction latency
+	struct Lanes { uint32_t v[4]; };
+	enum { NumLanes = 4 };
+
+	static inline Lanes lanesLoad(const uint32_t* _src)				{ Lanes r; for (int i=0; i<4; ++i) r.v[i] = _src[i]; return r; }
+	static inline void  lanesStore(uint32_t* _dst, Lanes _v)			{ for (int i=0; i<4; ++i) _dst[i] = _v.v[i]; }
+	static inline Lanes lanesSplat(uint32_t _v)						{ Lanes r; for (int i=0; i<4; ++i) r.v[i] = _v; return r; }
+	static inline Lanes lanesAdd(Lanes _a, Lanes _b)				{ for (int i=0; i<4; ++i) _a.v[i] += _b.v[i]; return _a; }
+	static inline Lanes lanesXor(Lanes _a, Lanes _b)				{ for (int i=0; i<4; ++i) _a.v[i] ^= _b.v[i]; return _a; }
+	static inline Lanes lanesAnd(Lanes _a, Lanes _b)				{ for (int i=0; i<4; ++i) _a.v[i] &= _b.v[i]; return _a; }
+	static inline Lanes lanesOr(Lanes _a, Lanes _b)					{ for (int i=0; i<4; ++i) _a.v[i] |= _b.v[i]; return _a; }
+	static inline Lanes lanesNot(Lanes _a)							{ for (int i=0; i<4; ++i) _a.v[i] = ~_a.v[i]; return _a; }
+	static inline Lanes lanesMul(Lanes _a, Lanes _b)				{ for (int i=0; i<4; ++i) _a.v[i] *= _b.v[i]; return _a; }
+	static inline Lanes lanesShl(Lanes _a, int _n)					{ for (int i=0; i<4; ++i) _a.v[i] <<= _n; return _a; }
+	static inline Lanes lanesShr(Lanes _a, int _n)					{ for (int i=0; i<4; ++i) _a.v[i] >>= _n; return _a; }
+	static inline Lanes lanesGreater(Lanes _a, Lanes _b)			{ for (int i=0; i<4; ++i) _a.v[i] = int32_t(_a.v[i]) > int32_t(_b.v[i]) ? UINT32_MAX : 0; return _a; }
+	static inline Lanes lanesSelect(Lanes _mask, Lanes _a, Lanes _b)	{ for (int i=0; i<4; ++i) _a.v[i] = (_a.v[i] & _mask.v[i]) | (_b.v[i] & ~_mask.v[i]); return _a; }
+
+#endif // RTM_SIMD_AVX2
+
+	static inline Lanes lanesRotl(Lanes _a, int _n)
+	{
+		return lanesOr(lanesShl(_a, _n), lanesShr(_a, 32 - _n));
+	}
+
+} // namespace hash_private
+} // namespace rtm
+
+#endif // RTM_RBASE_HASH_LANES_H
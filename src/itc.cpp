@@ -8,28 +8,62 @@
 
 namespace rtm {
 
-CommandBuffer::CommandBuffer(uint32_t _bufferSize)
+CommandBuffer::CommandBuffer(uint32_t _bufferSize, uint32_t _numBuffers)
 {
-	m_commandBuffers[0].setCapacity(_bufferSize);
-	m_commandBuffers[1].setCapacity(_bufferSize);
+	initBuffers(_numBuffers);
+	for (uint32_t i=0; i<m_numBuffers; ++i)
+		m_commandBuffers[i].setCapacity(_bufferSize);
+}
+
+CommandBuffer::CommandBuffer(RWBufferPool* _pool, uint32_t _numBuffers)
+{
+	initBuffers(_numBuffers);
+	for (uint32_t i=0; i<m_numBuffers; ++i)
+		m_commandBuffers[i].setPool(_pool);
 }
 
 CommandBuffer::~CommandBuffer()
 {
 	RTM_ASSERT(!m_runThread, "");
+	delete[] m_commandBuffers;
+}
+
+void CommandBuffer::initBuffers(uint32_t _numBuffers)
+{
+	RTM_ASSERT(_numBuffers >= 2, "At least two buffers are needed!");
+
+	m_commandBuffers	= new RWBuffer[_numBuffers];
+	m_numBuffers		= _numBuffers;
+	m_produceIndex		= 0;
+	m_consumeIndex		= 0;
+	m_cmdBufferProduce	= 0;
+	m_cmdBufferConsume	= 0;
+	m_runThread			= false;
+	m_consumerFunc		= 0;
+	m_queueDepth.store(0, std::memory_order_relaxed);
+	resetCounters();
+}
+
+void CommandBuffer::resetCounters()
+{
+	m_maxQueueDepth		= 0;
+	m_numStalls			= 0;
+	m_stallClock		= 0;
+	m_lastStallClock	= 0;
 }
 
 void CommandBuffer::init(rtm::ThreadEntry _consumerFunc)
 {
-	m_consumerFunc = _consumerFunc;
-	m_cmdBufferProduce = &m_commandBuffers[0];
-	m_cmdBufferConsume = &m_commandBuffers[1];
+	m_consumerFunc		= _consumerFunc;
+	m_produceIndex		= 0;
+	m_consumeIndex		= 0;
+	m_cmdBufferProduce	= &m_commandBuffers[0];
 
-	m_semConsume.post();
+	// producer owns the first buffer, the rest are free
+	m_semFree.post(m_numBuffers - 1);
 
 	m_cmdBufferProduce->start();
 
-	frame();
 	m_runThread = true;
 	m_appThread.start(consumerThread, this);
 }
@@ -38,33 +72,56 @@ void CommandBuffer::frame()
 {
 	m_cmdBufferProduce->finish();
 
-	m_semConsume.wait();
+	const int32_t depth = m_queueDepth.fetch_add(1, std::memory_order_relaxed) + 1;
+	m_maxQueueDepth = uint32_t(depth) > m_maxQueueDepth ? uint32_t(depth) : m_maxQueueDepth;
+	m_semFilled.post();
 
-	RWBuffer* tmp		= m_cmdBufferProduce;
-	m_cmdBufferProduce	= m_cmdBufferConsume;
-	m_cmdBufferConsume	= tmp;
+	// all other buffers are queued or being consumed
+	m_lastStallClock = 0;
+	if (!m_semFree.wait(0))
+	{
+		const uint64_t startClock = cpuClock();
+		m_semFree.wait();
+		m_lastStallClock = cpuClock() - startClock;
+		m_stallClock += m_lastStallClock;
+		++m_numStalls;
+	}
 
+	m_produceIndex		= (m_produceIndex + 1) % m_numBuffers;
+	m_cmdBufferProduce	= &m_commandBuffers[m_produceIndex];
 	m_cmdBufferProduce->start();
-
-	m_semProduce.post();
 }
 
 void CommandBuffer::shutDown()
 {
 	frame();
-	m_runThread = false;
+
+	// consumer drains queued frames before it sees the extra post
+	m_semFilled.post();
 	m_appThread.stop();
+	m_runThread = false;
+
+	// take back the free buffers so init can be called again
+	for (uint32_t i=1; i<m_numBuffers; ++i)
+		m_semFree.wait();
 }
 
 int32_t CommandBuffer::consumerThread(void* _userData)
 {
 	CommandBuffer* cc = (CommandBuffer*)_userData;
 
-	while (cc->m_runThread)
+	for (;;)
 	{
-		cc->m_semProduce.wait();
+		cc->m_semFilled.wait();
+		if (cc->m_queueDepth.load(std::memory_order_acquire) == 0)
+			break;
+
+		cc->m_cmdBufferConsume = &cc->m_commandBuffers[cc->m_consumeIndex];
 		cc->m_consumerFunc(cc);
-		cc->m_semConsume.post();
+		cc->m_consumeIndex = (cc->m_consumeIndex + 1) % cc->m_numBuffers;
+
+		cc->m_queueDepth.fetch_sub(1, std::memory_order_release);
+		cc->m_semFree.post();
 	}
 	return 0;
 }
@@ -0,0 +1,348 @@
+//--------------------------------------------------------------------------//
+/// Copyright 2025 Milos Tosic. All Rights Reserved.                       ///
+/// License: http://www.opensource.org/licenses/BSD-2-Clause               ///
+//--------------------------------------------------------------------------//
+
+#include <rbase_pch.h>
+#include <rbase/inc/jobs.h>
+#include <rbase/inc/tls.h>
+#include <rbase/inc/mutex.h>
+
+namespace rtm {
+
+	enum
+	{
+		JOB_DEQUE_SIZE		= 4096,		// power of 2
+		JOB_INJECT_SIZE		= 4096,		// power of 2
+		JOB_IDLE_SPINS		= 64		// failed job searches before worker goes to sleep
+	};
+
+	//--------------------------------------------------------------------------
+	/// Chase-Lev deque, see 'Correct and Efficient Work-Stealing for Weak Memory
+	/// Models' (Le et al). Owner pushes and pops at the bottom, thieves take from
+	/// the top. Jobs are stored by value, a slot is only reused once the deque
+	/// has wrapped around and a thief that raced with it fails its CAS.
+	//--------------------------------------------------------------------------
+	class JobDeque
+	{
+		typedef JobSystem::Job Job;
+		typedef char CachelinePad[64];
+
+		std::atomic<int64_t>	m_top;
+		CachelinePad			m_pad0;
+		std::atomic<int64_t>	m_bottom;
+		CachelinePad			m_pad1;
+		Job						m_jobs[JOB_DEQUE_SIZE];
+
+	public:
+		inline JobDeque()
+			: m_top(0)
+			, m_bottom(0)
+		{
+		}
+
+		inline bool push(const Job& _job)
+		{
+			const int64_t bottom	= m_bottom.load(std::memory_order_relaxed);
+			const int64_t top		= m_top.load(std::memory_order_acquire);
+			if (bottom - top >= JOB_DEQUE_SIZE)
+				return false;
+
+			m_jobs[bottom & (JOB_DEQUE_SIZE - 1)] = _job;
+			m_bottom.store(bottom + 1, std::memory_order_release);
+			return true;
+		}
+
+		inline bool pop(Job& _job)
+		{
+			const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+			m_bottom.store(bottom, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64_t top = m_top.load(std::memory_order_relaxed);
+
+			if (top > bottom)
+			{
+				m_bottom.store(bottom + 1, std::memory_order_relaxed);
+				return false;
+			}
+
+			_job = m_jobs[bottom & (JOB_DEQUE_SIZE - 1)];
+			if (top != bottom)
+				return true;
+
+			// last job, race against thieves
+			const bool won = m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+			m_bottom.store(bottom + 1, std::memory_order_relaxed);
+			return won;
+		}
+
+		inline bool steal(Job& _job)
+		{
+			int64_t top = m_top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+			if (top >= bottom)
+				return false;
+
+			_job = m_jobs[top & (JOB_DEQUE_SIZE - 1)];
+			return m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+		}
+	};
+
+	//--------------------------------------------------------------------------
+	/// Jobs submitted from threads that are not workers. Worker deques carry
+	/// most of the traffic, so a locked ring is enough. Count is checked before
+	/// taking the lock, idle workers polling an empty queue do not contend.
+	//--------------------------------------------------------------------------
+	struct JobSystem::InjectQueue
+	{
+		Mutex					m_mutex;
+		std::atomic<uint32_t>	m_count;
+		uint32_t				m_head;
+		Job						m_jobs[JOB_INJECT_SIZE];
+
+		inline InjectQueue()
+			: m_count(0)
+			, m_head(0)
+		{
+		}
+
+		inline bool push(const Job& _job)
+		{
+			ScopedMutexLocker lock(m_mutex);
+			const uint32_t count = m_count.load(std::memory_order_relaxed);
+			if (count == JOB_INJECT_SIZE)
+				return false;
+
+			m_jobs[(m_head + count) & (JOB_INJECT_SIZE - 1)] = _job;
+			m_count.store(count + 1, std::memory_order_release);
+			return true;
+		}
+
+		inline bool pop(Job& _job)
+		{
+			if (m_count.load(std::memory_order_acquire) == 0)
+				return false;
+
+			ScopedMutexLocker lock(m_mutex);
+			const uint32_t count = m_count.load(std::memory_order_relaxed);
+			if (count == 0)
+				return false;
+
+			_job = m_jobs[m_head & (JOB_INJECT_SIZE - 1)];
+			++m_head;
+			m_count.store(count - 1, std::memory_order_relaxed);
+			return true;
+		}
+	};
+
+	struct JobSystem::Worker
+	{
+		JobDeque	m_deque;
+		JobSystem*	m_system;
+		uint32_t	m_index;
+		uint32_t	m_random;
+
+		/// Picks a victim to steal from, xorshift
+		inline uint32_t nextVictim(uint32_t _numThreads)
+		{
+			m_random ^= m_random << 13;
+			m_random ^= m_random >> 17;
+			m_random ^= m_random << 5;
+			return m_random % _numThreads;
+		}
+	};
+
+	JobSystem::JobSystem()
+		: m_workers(0)
+		, m_threads(0)
+		, m_injectQueue(0)
+		, m_numSleeping(0)
+		, m_running(0)
+		, m_numThreads(0)
+		, m_tlsIndex(0)
+		, m_pinThreads(false)
+	{
+	}
+
+	JobSystem::~JobSystem()
+	{
+		shutdown();
+	}
+
+	bool JobSystem::init(uint32_t _numThreads, bool _pinThreads)
+	{
+		RTM_ASSERT(m_workers == 0, "Job system already initialized!");
+
+		m_numThreads	= _numThreads ? _numThreads : threadGetNumHardwareThreads();
+		m_pinThreads	= _pinThreads;
+		m_tlsIndex		= tlsAllocate();
+		m_injectQueue	= new InjectQueue;
+		m_workers		= new Worker[m_numThreads];
+		m_running.store(1, std::memory_order_relaxed);
+
+		for (uint32_t i=0; i<m_numThreads; ++i)
+		{
+			m_workers[i].m_system	= this;
+			m_workers[i].m_index	= i;
+			m_workers[i].m_random	= 0x9E3779B9u * (i + 1);
+		}
+
+		tlsSetValue(m_tlsIndex, &m_workers[0]);
+
+		if (m_numThreads > 1)
+		{
+			m_threads = new Thread[m_numThreads - 1];
+			for (uint32_t i=1; i<m_numThreads; ++i)
+				m_threads[i - 1].start(workerEntry, &m_workers[i]);
+		}
+
+		return true;
+	}
+
+	void JobSystem::shutdown()
+	{
+		if (!m_workers)
+			return;
+
+		m_running.store(0, std::memory_order_seq_cst);
+
+		if (m_threads)
+		{
+			m_wakeup.post(m_numThreads);
+			for (uint32_t i=1; i<m_numThreads; ++i)
+				m_threads[i - 1].stop();
+			delete[] m_threads;
+		}
+
+		tlsSetValue(m_tlsIndex, 0);
+		tlsFree(m_tlsIndex);
+
+		delete[] m_workers;
+		delete m_injectQueue;
+
+		m_workers		= 0;
+		m_threads		= 0;
+		m_injectQueue	= 0;
+		m_numThreads	= 0;
+	}
+
+	void JobSystem::run(JobFunction _function, void* _userData, JobCounter* _counter)
+	{
+		Job job = { _function, _userData, _counter };
+
+		if (_counter)
+			_counter->m_count.fetch_add(1, std::memory_order_relaxed);
+
+		Worker* worker = getWorker();
+		const bool queued = worker ? worker->m_deque.push(job) : m_injectQueue->push(job);
+
+		// no room, keep going by running the job here
+		if (!queued)
+		{
+			execute(job);
+			return;
+		}
+
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (m_numSleeping.load(std::memory_order_relaxed) > 0)
+			m_wakeup.post();
+	}
+
+	void JobSystem::wait(JobCounter* _counter)
+	{
+		Worker* worker = getWorker();
+
+		Job job;
+		while (!_counter->isDone())
+		{
+			if (getJob(worker, job))
+				execute(job);
+			else
+				threadYield();
+		}
+	}
+
+	JobSystem::Worker* JobSystem::getWorker() const
+	{
+		Worker* worker = (Worker*)tlsGetValue(m_tlsIndex);
+		// another job system could have stored a worker in a slot with the same index
+		return (worker && (worker->m_system == this)) ? worker : 0;
+	}
+
+	bool JobSystem::getJob(Worker* _worker, Job& _job)
+	{
+		if (_worker && _worker->m_deque.pop(_job))
+			return true;
+
+		if (m_injectQueue->pop(_job))
+			return true;
+
+		uint32_t random = _worker ? _worker->nextVictim(m_numThreads) : 0;
+		for (uint32_t i=0; i<m_numThreads; ++i)
+		{
+			Worker& victim = m_workers[(random + i) % m_numThreads];
+			if ((&victim != _worker) && victim.m_deque.steal(_job))
+				return true;
+		}
+
+		return false;
+	}
+
+	void JobSystem::execute(const Job& _job)
+	{
+		_job.m_function(_job.m_userData);
+		if (_job.m_counter)
+			_job.m_counter->m_count.fetch_sub(1, std::memory_order_release);
+	}
+
+	void JobSystem::workerLoop(Worker* _worker)
+	{
+		tlsSetValue(m_tlsIndex, _worker);
+
+		if (m_pinThreads)
+			threadSetAffinity(_worker->m_index);
+
+		Job job;
+		uint32_t idle = 0;
+		while (m_running.load(std::memory_order_relaxed))
+		{
+			if (getJob(_worker, job))
+			{
+				execute(job);
+				idle = 0;
+				continue;
+			}
+
+			if (++idle < JOB_IDLE_SPINS)
+			{
+				threadYield();
+				continue;
+			}
+
+			// announce sleeping before the last check so a concurrent run() will post
+			m_numSleeping.fetch_add(1, std::memory_order_seq_cst);
+			if (getJob(_worker, job))
+			{
+				m_numSleeping.fetch_sub(1, std::memory_order_relaxed);
+				execute(job);
+				idle = 0;
+				continue;
+			}
+
+			if (m_running.load(std::memory_order_relaxed))
+				m_wakeup.wait();
+			m_numSleeping.fetch_sub(1, std::memory_order_relaxed);
+			idle = 0;
+		}
+	}
+
+	int32_t JobSystem::workerEntry(void* _userData)
+	{
+		Worker* worker = (Worker*)_userData;
+		worker->m_system->workerLoop(worker);
+		return 0;
+	}
+
+} // namespace rtm
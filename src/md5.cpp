@@ -11,8 +11,12 @@
 //--------------------------------------------------------------------------//
 
 #include <rbase_pch.h>
+#include <rbase/inc/hash.h>
 #include <rbase/inc/stringfn.h>
 #include <rbase/src/md5.h>
+#include <rbase/src/hash_lanes.h>
+
+#include <new>
 
 namespace rtm {
 
@@ -43,6 +47,26 @@ void hashMD5toString(uint8_t _digest[16], char _hash[33])
 	_hash[32] = '\0';
 }
 
+RTM_STATIC_ASSERT(sizeof(MD5) <= sizeof(HasherMD5), "HasherMD5 storage too small!");
+
+#define MD5_STATE(_hasher) (*(MD5*)_hasher->m_data)
+
+void HasherMD5::init()
+{
+	new (m_data) MD5();
+}
+
+void HasherMD5::update(const void* _data, uint32_t _size)
+{
+	MD5_STATE(this).process(_data, _size);
+}
+
+void HasherMD5::finalize(uint8_t _digest[16])
+{
+	MD5_STATE(this).finalize();
+	MD5_STATE(this).getHash(_digest);
+}
+
 MD5::MD5()
 {
 	init();
@@ -157,7 +181,7 @@ enum eMD5Transform
 	S44_	= 21
 };
 
-void MD5::transform(uint8_t _block[64])
+void MD5::transform(const uint8_t _block[64])
 {
 	uint32_t a = m_state[0];
 	uint32_t b = m_state[1];
@@ -243,8 +267,178 @@ void MD5::transform(uint8_t _block[64])
 	m_state[1] += b;
 	m_state[2] += c;
 	m_state[3] += d;
+}
+
+namespace hash_private {
+
+	static const uint32_t s_md5Constants[64] =
+	{
+		0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee,
+		0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+		0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be,
+		0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+		0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa,
+		0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+		0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed,
+		0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+		0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c,
+		0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+		0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05,
+		0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+		0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039,
+		0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+		0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1,
+		0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+	};
+
+	static const int s_md5Shifts[4][4] =
+	{
+		{ S11_, S12_, S13_, S14_ },
+		{ S21_, S22_, S23_, S24_ },
+		{ S31_, S32_, S33_, S34_ },
+		{ S41_, S42_, S43_, S44_ }
+	};
+
+	struct MD5Lane
+	{
+		const uint8_t*	m_data;
+		uint32_t		m_fullBlocks;
+		uint32_t		m_numBlocks;
+		uint8_t			m_tail[128];
+	};
+
+	static inline void md5LaneInit(MD5Lane& _lane, const void* _data, uint32_t _size)
+	{
+		const uint32_t rem = _size & 63;
+
+		_lane.m_data		= (const uint8_t*)_data;
+		_lane.m_fullBlocks	= _size / 64;
+		_lane.m_numBlocks	= _lane.m_fullBlocks + (rem < 56 ? 1 : 2);
+
+		// padding and message length in bits, same as MD5::finalize
+		const uint32_t tailSize = (_lane.m_numBlocks - _lane.m_fullBlocks) * 64;
+		memCopy(_lane.m_tail, tailSize, _lane.m_data + _lane.m_fullBlocks * 64, rem);
+		memSet(_lane.m_tail + rem, 0, tailSize - rem);
+		_lane.m_tail[rem] = 0x80;
+
+		const uint64_t bits = uint64_t(_size) << 3;
+		for (uint32_t i=0; i<8; ++i)
+			_lane.m_tail[tailSize - 8 + i] = uint8_t(bits >> (i * 8));
+	}
+
+	static inline const uint8_t* md5LaneBlock(const MD5Lane& _lane, uint32_t _block)
+	{
+		if (_block < _lane.m_fullBlocks)
+			return _lane.m_data + _block * 64;
+		if (_block < _lane.m_numBlocks)
+			return _lane.m_tail + (_block - _lane.m_fullBlocks) * 64;
+		return _lane.m_tail;
+	}
+
+	static inline uint32_t md5Load32(const uint8_t* _src)
+	{
+#if RTM_LITTLE_ENDIAN
+		return mem_private::load32(_src);
+#else
+		return uint32_t(_src[0]) | (uint32_t(_src[1]) << 8) | (uint32_t(_src[2]) << 16) | (uint32_t(_src[3]) << 24);
+#endif
+	}
+
+	static inline Lanes md5Function(uint32_t _round, Lanes _b, Lanes _c, Lanes _d)
+	{
+		switch (_round)
+		{
+		case 0:		return lanesXor(lanesAnd(lanesXor(_c, _d), _b), _d);
+		case 1:		return lanesXor(lanesAnd(lanesXor(_b, _c), _d), _c);
+		case 2:		return lanesXor(lanesXor(_b, _c), _d);
+		default:	return lanesXor(_c, lanesOr(_b, lanesNot(_d)));
+		};
+	}
+
+	static inline void hashMD5Lanes(const void* const* _data, const uint32_t* _dataSizes, uint32_t _count, uint8_t _digests[][16])
+	{
+		MD5Lane lanes[NumLanes];
+		uint32_t numBlocks[NumLanes];
+		uint32_t maxBlocks = 0;
+
+		for (uint32_t l=0; l<NumLanes; ++l)
+		{
+			// unused lanes hash an empty buffer, results are discarded
+			md5LaneInit(lanes[l], l < _count ? _data[l] : 0, l < _count ? _dataSizes[l] : 0);
+			numBlocks[l] = lanes[l].m_numBlocks;
+			maxBlocks = maxBlocks > numBlocks[l] ? maxBlocks : numBlocks[l];
+		}
+
+		const Lanes blocks = lanesLoad(numBlocks);
+
+		Lanes state[4] =
+		{
+			lanesSplat(0x67452301),
+			lanesSplat(0xefcdab89),
+			lanesSplat(0x98badcfe),
+			lanesSplat(0x10325476)
+		};
+
+		uint32_t words[16][NumLanes];
+		for (uint32_t blk=0; blk<maxBlocks; ++blk)
+		{
+			for (uint32_t l=0; l<NumLanes; ++l)
+			{
+				const uint8_t* block = md5LaneBlock(lanes[l], blk);
+				for (uint32_t i=0; i<16; ++i)
+					words[i][l] = md5Load32(block + i * 4);
+			}
+
+			Lanes x[16];
+			for (uint32_t i=0; i<16; ++i)
+				x[i] = lanesLoad(words[i]);
+
+			Lanes a = state[0];
+			Lanes b = state[1];
+			Lanes c = state[2];
+			Lanes d = state[3];
+
+			for (uint32_t i=0; i<64; ++i)
+			{
+				static const uint32_t multiplier[4]	= { 1, 5, 3, 7 };
+				static const uint32_t offset[4]		= { 0, 1, 5, 0 };
+
+				const uint32_t round = i / 16;
+				const uint32_t index = (multiplier[round] * i + offset[round]) & 15;
+
+				Lanes f = lanesAdd(lanesAdd(a, md5Function(round, b, c, d)), lanesAdd(x[index], lanesSplat(s_md5Constants[i])));
+				f = lanesAdd(lanesRotl(f, s_md5Shifts[round][i & 3]), b);
+
+				a	= d;
+				d	= c;
+				c	= b;
+				b	= f;
+			}
+
+			const Lanes active = lanesGreater(blocks, lanesSplat(blk));
+			state[0] = lanesSelect(active, lanesAdd(state[0], a), state[0]);
+			state[1] = lanesSelect(active, lanesAdd(state[1], b), state[1]);
+			state[2] = lanesSelect(active, lanesAdd(state[2], c), state[2]);
+			state[3] = lanesSelect(active, lanesAdd(state[3], d), state[3]);
+		}
+
+		uint32_t digests[4][NumLanes];
+		for (uint32_t i=0; i<4; ++i)
+			lanesStore(digests[i], state[i]);
+
+		for (uint32_t l=0; l<NumLanes && l<_count; ++l)
+			for (uint32_t i=0; i<16; ++i)
+				_digests[l][i] = uint8_t(digests[i / 4][l] >> ((i & 3) * 8));
+	}
+
+} // namespace hash_private
+
+void hashMD5Batch(const void* const* _data, const uint32_t* _dataSizes, uint32_t _count, uint8_t _digests[][16])
+{
+	using namespace hash_private;
 
-	memSet((uint8_t*)x, 0, sizeof(x));
+	for (uint32_t i=0; i<_count; i += NumLanes)
+		hashMD5Lanes(_data + i, _dataSizes + i, _count - i, _digests + i);
 }
 
 void MD5::encode(uint8_t* _output, uint32_t* _input, uint32_t _length)
@@ -260,12 +454,16 @@ void MD5::encode(uint8_t* _output, uint32_t* _input, uint32_t _length)
 	}
 }
 
-void MD5::decode( uint32_t *_output, uint8_t* _input, uint32_t _length)
+void MD5::decode( uint32_t *_output, const uint8_t* _input, uint32_t _length)
 {
+#if RTM_LITTLE_ENDIAN
+	memCopy(_output, _length, _input, _length);
+#else
 	uint32_t i, j;
 	uint32_t len = _length;
 	for ( i=0, j=0; j<len; i++, j+=4)
 		_output[i] = ((uint32_t)_input[j]) | (((uint32_t)_input[j+1]) << 8) | (((uint32_t)_input[j+2]) << 16) | (((uint32_t)_input[j+3]) << 24);
+#endif
 }
 
 } // namespace rtm
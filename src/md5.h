@@ -26,9 +26,9 @@ class MD5
 		uint8_t		m_digest[16];
 
 		void		init();
-		void		transform(uint8_t* _buffer);
+		void		transform(const uint8_t* _buffer);
 		static void	encode(uint8_t* _dest, uint32_t* _src, uint32_t _length);
-		static void	decode(uint32_t* _dest, uint8_t* _src, uint32_t _length);
+		static void	decode(uint32_t* _dest, const uint8_t* _src, uint32_t _length);
 
 		static inline uint32_t	rotateLeft(uint32_t _x, uint32_t _n);
 		static inline uint32_t	F(uint32_t _x, uint32_t _y, uint32_t _z);
@@ -62,14 +62,15 @@ inline uint32_t MD5::rotateLeft(uint32_t _x, uint32_t _n)
 	return (_x << _n) | (_x >> (32-_n));
 }
 
+// F and G are bit selects, written with xor/and to shorten dependency chains
 inline uint32_t MD5::F(uint32_t _x, uint32_t _y, uint32_t _z)
 {
-	return (_x & _y) | (~_x & _z);
+	return ((_y ^ _z) & _x) ^ _z;
 }
 
 inline uint32_t MD5::G(uint32_t _x, uint32_t _y, uint32_t _z)
 {
-	return (_x & _z) | (_y & ~_z);
+	return ((_x ^ _y) & _z) ^ _y;
 }
 
 inline uint32_t MD5::H(uint32_t _x, uint32_t _y, uint32_t _z)
@@ -4,96 +4,278 @@
 //--------------------------------------------------------------------------//
 
 #include <rbase_pch.h>
-#include <rbase/inc/stringfn.h>
+#include <rbase/inc/radixsort.h>
+#include <rbase/inc/stringview.h>
 
 namespace rtm {
 
-#define RTM_RADIXSORT_BITS				11
-#define RTM_RADIXSORT_HISTOGRAM_SIZE	(1 << RTM_RADIXSORT_BITS)
-#define RTM_RADIXSORT_BIT_MASK			(RTM_RADIXSORT_HISTOGRAM_SIZE - 1)
+namespace radixsort_private {
 
-void sortRadix(uint32_t* _keys, uint32_t* _tempKeys, uint32_t _size)
-{
-	uint32_t* originalKeys = _keys;
-	uint32_t histogram[RTM_RADIXSORT_HISTOGRAM_SIZE];
-	uint16_t shift = 0;
-	for (uint32_t pass=0; pass<3; ++pass)
+	/// Keeps parallel sort workers alive between sorts.
+	struct ParallelPool
 	{
-		rtm::memSet(histogram, 0, sizeof(uint32_t)*RTM_RADIXSORT_HISTOGRAM_SIZE);
-		for (uint32_t i=0; i<_size; ++i)
-		{
-			uint32_t key = _keys[i];
-			uint16_t index = (key>>shift)&RTM_RADIXSORT_BIT_MASK;
-			++histogram[index];
-		}
+		JobSystem m_jobs;
 
-		uint32_t offset = 0;
-		for (uint32_t i=0; i<RTM_RADIXSORT_HISTOGRAM_SIZE; ++i)
+		ParallelPool()
 		{
-			uint32_t count = histogram[i];
-			histogram[i] = offset;
-			offset += count;
+			m_jobs.init(0, false);
 		}
+	};
 
-		for (uint32_t i=0; i<_size; ++i)
-		{
-			uint32_t key = _keys[i];
-			uint32_t index = (key >> shift) & RTM_RADIXSORT_BIT_MASK;
-			uint32_t dest = histogram[index]++;
-			_tempKeys[dest] = key;
-		}
+	void* tempAlloc(size_t _size)
+	{
+		return rbaseGetMemoryManager()->alloc(_size, RTM_DEFAULT_ALIGNMENT);
+	}
 
-		uint32_t* swapKeys = _tempKeys;
-		_tempKeys = _keys;
-		_keys = swapKeys;
+	void tempFree(void* _ptr)
+	{
+		rbaseGetMemoryManager()->free(_ptr, RTM_DEFAULT_ALIGNMENT);
+	}
 
-		shift += RTM_RADIXSORT_BITS;
+	JobSystem* parallelJobs()
+	{
+		static ParallelPool s_pool;
+		return &s_pool.m_jobs;
 	}
 
-	if (_keys != originalKeys)
-		rtm::memCopy(originalKeys, _size * sizeof(uint32_t), _keys, _size * sizeof(uint32_t));
-}
+	enum
+	{
+		STRING_BUCKETS		= 257,	// end of string + all byte values
+		STRING_SMALL_SORT	= 32
+	};
 
-void sortRadix64(uint64_t* _keys, uint64_t* _tempKeys, uint32_t _size)
-{
-	uint32_t histogram[RTM_RADIXSORT_HISTOGRAM_SIZE];
-	uint16_t shift = 0;
-	for (uint32_t pass=0; pass<6; ++pass)
+	/// Returns bucket of the character at given depth, 0 if string is shorter.
+	static inline uint32_t stringDigit(const char* _str, uint32_t _depth)
 	{
-		rtm::memSet(histogram, 0, sizeof(uint32_t)*RTM_RADIXSORT_HISTOGRAM_SIZE);
-		for (uint32_t i=0; i<_size; ++i)
+		const uint8_t c = uint8_t(_str[_depth]);
+		return c ? c + 1 : 0;
+	}
+
+	static inline uint32_t stringDigit(const StringView& _str, uint32_t _depth)
+	{
+		return _depth < _str.length() ? uint8_t(_str.data()[_depth]) + 1 : 0;
+	}
+
+	/// Compares strings known to be equal up to given depth.
+	static inline bool stringLess(const char* _lhs, const char* _rhs, uint32_t _depth)
+	{
+		const uint8_t* lhs = (const uint8_t*)_lhs + _depth;
+		const uint8_t* rhs = (const uint8_t*)_rhs + _depth;
+		while (*lhs && (*lhs == *rhs))
 		{
-			uint64_t key = _keys[i];
-			uint16_t index = (key>>shift)&RTM_RADIXSORT_BIT_MASK;
-			++histogram[index];
+			++lhs;
+			++rhs;
 		}
+		return *lhs < *rhs;
+	}
+
+	static inline bool stringLess(const StringView& _lhs, const StringView& _rhs, uint32_t _depth)
+	{
+		const uint8_t* lhs	= (const uint8_t*)_lhs.data();
+		const uint8_t* rhs	= (const uint8_t*)_rhs.data();
+		const uint32_t len	= _lhs.length() < _rhs.length() ? _lhs.length() : _rhs.length();
+
+		for (uint32_t i=_depth; i<len; ++i)
+			if (lhs[i] != rhs[i])
+				return lhs[i] < rhs[i];
+
+		return _lhs.length() < _rhs.length();
+	}
 
-		uint32_t offset = 0;
-		for (uint32_t i=0; i<RTM_RADIXSORT_HISTOGRAM_SIZE; ++i)
+	/// MSD radix sort, ranges are processed from an explicit stack so long common
+	/// prefixes do not recurse. Small ranges are insertion sorted.
+	template <typename Str>
+	static void sortStrings(Str* _strings, Str* _tempStrings, uint32_t _size)
+	{
+		struct Range
 		{
-			uint32_t count = histogram[i];
-			histogram[i] = offset;
-			offset += count;
-		}
+			uint32_t	m_begin;
+			uint32_t	m_size;
+			uint32_t	m_depth;
+		};
+
+		if (_size < 2)
+			return;
 
-		for (uint32_t i=0; i<_size; ++i)
+		uint16_t* digits	= (uint16_t*)tempAlloc(sizeof(uint16_t) * _size);
+		uint32_t maxRanges	= 256;
+		uint32_t numRanges	= 0;
+		Range* ranges		= (Range*)tempAlloc(sizeof(Range) * maxRanges);
+
+		ranges[numRanges++] = { 0, _size, 0 };
+
+		while (numRanges)
 		{
-			uint64_t key = _keys[i];
-			uint32_t index = (key >> shift) & RTM_RADIXSORT_BIT_MASK;
-			uint32_t dest = histogram[index]++;
-			_tempKeys[dest] = key;
-		}
+			const Range range = ranges[--numRanges];
+			Str* strings = _strings + range.m_begin;
+
+			if (range.m_size <= STRING_SMALL_SORT)
+			{
+				for (uint32_t i=1; i<range.m_size; ++i)
+				{
+					const Str str = strings[i];
+					uint32_t j = i;
+					while ((j > 0) && stringLess(str, strings[j - 1], range.m_depth))
+					{
+						strings[j] = strings[j - 1];
+						--j;
+					}
+					strings[j] = str;
+				}
+				continue;
+			}
+
+			uint32_t counts[STRING_BUCKETS];
+			memSet(counts, 0, sizeof(counts));
+
+			for (uint32_t i=0; i<range.m_size; ++i)
+			{
+				const uint32_t digit = stringDigit(strings[i], range.m_depth);
+				digits[i] = uint16_t(digit);
+				++counts[digit];
+			}
+
+			// common prefix, nothing to move
+			if (counts[digits[0]] == range.m_size)
+			{
+				if (digits[0] != 0)
+					ranges[numRanges++] = { range.m_begin, range.m_size, range.m_depth + 1 };
+				continue;
+			}
+
+			uint32_t offsets[STRING_BUCKETS];
+			uint32_t offset = 0;
+			for (uint32_t i=0; i<STRING_BUCKETS; ++i)
+			{
+				offsets[i] = offset;
+				offset += counts[i];
+			}
+
+			Str* temp = _tempStrings + range.m_begin;
+			for (uint32_t i=0; i<range.m_size; ++i)
+				temp[offsets[digits[i]]++] = strings[i];
 
-		uint64_t* swapKeys = _tempKeys;
-		_tempKeys = _keys;
-		_keys = swapKeys;
+			memCopy(strings, range.m_size * sizeof(Str), temp, range.m_size * sizeof(Str));
 
-		shift += RTM_RADIXSORT_BITS;
+			if (numRanges + STRING_BUCKETS > maxRanges)
+			{
+				Range* newRanges = (Range*)tempAlloc(sizeof(Range) * maxRanges * 2);
+				memCopy(newRanges, sizeof(Range) * maxRanges * 2, ranges, sizeof(Range) * numRanges);
+				tempFree(ranges);
+				ranges		= newRanges;
+				maxRanges	*= 2;
+			}
+
+			// strings that ended are all equal and already in place
+			for (uint32_t i=1; i<STRING_BUCKETS; ++i)
+				if (counts[i] > 1)
+					ranges[numRanges++] = { range.m_begin + offsets[i] - counts[i], counts[i], range.m_depth + 1 };
+		}
+
+		tempFree(ranges);
+		tempFree(digits);
 	}
+
+} // namespace radixsort_private
+
+void sortRadix(uint32_t* _keys, uint32_t* _tempKeys, uint32_t _size)
+{
+	radixsort_private::sort<uint32_t, radixsort_private::NoValue, false>(_keys, _tempKeys, 0, 0, _size);
+}
+
+void sortRadix(int32_t* _keys, int32_t* _tempKeys, uint32_t _size)
+{
+	radixsort_private::sort<int32_t, radixsort_private::NoValue, false>(_keys, _tempKeys, 0, 0, _size);
+}
+
+void sortRadix(float* _keys, float* _tempKeys, uint32_t _size)
+{
+	radixsort_private::sort<float, radixsort_private::NoValue, false>(_keys, _tempKeys, 0, 0, _size);
 }
 
-#undef RTM_RADIXSORT_BITS
-#undef RTM_RADIXSORT_HISTOGRAM_SIZE
-#undef RTM_RADIXSORT_BIT_MASK
+void sortRadix64(uint64_t* _keys, uint64_t* _tempKeys, uint32_t _size)
+{
+	radixsort_private::sort<uint64_t, radixsort_private::NoValue, false>(_keys, _tempKeys, 0, 0, _size);
+}
+
+void sortRadix64(int64_t* _keys, int64_t* _tempKeys, uint32_t _size)
+{
+	radixsort_private::sort<int64_t, radixsort_private::NoValue, false>(_keys, _tempKeys, 0, 0, _size);
+}
+
+void sortRadix64(double* _keys, double* _tempKeys, uint32_t _size)
+{
+	radixsort_private::sort<double, radixsort_private::NoValue, false>(_keys, _tempKeys, 0, 0, _size);
+}
+
+void sortRadixParallel(uint32_t* _keys, uint32_t* _tempKeys, uint32_t _size, uint32_t _numThreads)
+{
+	radixsort_private::sortParallel<uint32_t, radixsort_private::NoValue, false>(_keys, _tempKeys, 0, 0, _size, _numThreads);
+}
+
+void sortRadixParallel(int32_t* _keys, int32_t* _tempKeys, uint32_t _size, uint32_t _numThreads)
+{
+	radixsort_private::sortParallel<int32_t, radixsort_private::NoValue, false>(_keys, _tempKeys, 0, 0, _size, _numThreads);
+}
+
+void sortRadixParallel(float* _keys, float* _tempKeys, uint32_t _size, uint32_t _numThreads)
+{
+	radixsort_private::sortParallel<float, radixsort_private::NoValue, false>(_keys, _tempKeys, 0, 0, _size, _numThreads);
+}
+
+void sortRadix64Parallel(uint64_t* _keys, uint64_t* _tempKeys, uint32_t _size, uint32_t _numThreads)
+{
+	radixsort_private::sortParallel<uint64_t, radixsort_private::NoValue, false>(_keys, _tempKeys, 0, 0, _size, _numThreads);
+}
+
+void sortRadix64Parallel(int64_t* _keys, int64_t* _tempKeys, uint32_t _size, uint32_t _numThreads)
+{
+	radixsort_private::sortParallel<int64_t, radixsort_private::NoValue, false>(_keys, _tempKeys, 0, 0, _size, _numThreads);
+}
+
+void sortRadix64Parallel(double* _keys, double* _tempKeys, uint32_t _size, uint32_t _numThreads)
+{
+	radixsort_private::sortParallel<double, radixsort_private::NoValue, false>(_keys, _tempKeys, 0, 0, _size, _numThreads);
+}
+
+void sortRadixParallel(uint32_t* _keys, uint32_t* _tempKeys, uint32_t _size, JobSystem* _jobs)
+{
+	radixsort_private::sortParallel<uint32_t, radixsort_private::NoValue, false>(_keys, _tempKeys, 0, 0, _size, _jobs);
+}
+
+void sortRadixParallel(int32_t* _keys, int32_t* _tempKeys, uint32_t _size, JobSystem* _jobs)
+{
+	radixsort_private::sortParallel<int32_t, radixsort_private::NoValue, false>(_keys, _tempKeys, 0, 0, _size, _jobs);
+}
+
+void sortRadixParallel(float* _keys, float* _tempKeys, uint32_t _size, JobSystem* _jobs)
+{
+	radixsort_private::sortParallel<float, radixsort_private::NoValue, false>(_keys, _tempKeys, 0, 0, _size, _jobs);
+}
+
+void sortRadix64Parallel(uint64_t* _keys, uint64_t* _tempKeys, uint32_t _size, JobSystem* _jobs)
+{
+	radixsort_private::sortParallel<uint64_t, radixsort_private::NoValue, false>(_keys, _tempKeys, 0, 0, _size, _jobs);
+}
+
+void sortRadix64Parallel(int64_t* _keys, int64_t* _tempKeys, uint32_t _size, JobSystem* _jobs)
+{
+	radixsort_private::sortParallel<int64_t, radixsort_private::NoValue, false>(_keys, _tempKeys, 0, 0, _size, _jobs);
+}
+
+void sortRadix64Parallel(double* _keys, double* _tempKeys, uint32_t _size, JobSystem* _jobs)
+{
+	radixsort_private::sortParallel<double, radixsort_private::NoValue, false>(_keys, _tempKeys, 0, 0, _size, _jobs);
+}
+
+void sortRadixStrings(const char** _strings, const char** _tempStrings, uint32_t _size)
+{
+	radixsort_private::sortStrings(_strings, _tempStrings, _size);
+}
+
+void sortRadixStrings(StringView* _strings, StringView* _tempStrings, uint32_t _size)
+{
+	radixsort_private::sortStrings(_strings, _tempStrings, _size);
+}
 
 } // namespace rtm
@@ -0,0 +1,352 @@
+//--------------------------------------------------------------------------//
+/// Copyright 2025 Milos Tosic. All Rights Reserved.                       ///
+/// License: http://www.opensource.org/licenses/BSD-2-Clause               ///
+//--------------------------------------------------------------------------//
+
+// Standalone benchmark of hash functions and MD5, not part of the test project.
+// Build from the directory containing rbase, e.g.:
+//   c++ -std=c++17 -O2 -I. -Irbase/src rbase/test/bench/rbase_bench_hash.cpp rbase/src/hash.cpp rbase/src/md5.cpp -o bench_hash
+
+#include <rbase/inc/platform.h>
+#include <rbase/inc/hash.h>
+#include <rbase/inc/stringfn.h>
+#include <rbase/inc/cpu.h>
+
+#include <stdio.h>
+
+using namespace rtm;
+
+namespace {
+
+	enum
+	{
+		BUFFER_SIZE	= 64 * 1024,
+		TOTAL_BYTES	= 256 * 1024 * 1024,	// bytes hashed per measurement
+		BATCH_KEYS	= 1024,					// keys per batch call
+		TOTAL_KEYS	= 16 * 1024 * 1024,		// keys hashed per batch measurement
+		MD5_BYTES	= 64 * 1024 * 1024		// bytes hashed per MD5 measurement
+	};
+
+	uint8_t		g_buffer[BUFFER_SIZE + 64];
+	uint64_t	g_sink;
+
+	const void*	g_keys[BATCH_KEYS];
+	uint32_t	g_lens[BATCH_KEYS];
+	uint32_t	g_hashes[BATCH_KEYS];
+	uint8_t		g_digests[BATCH_KEYS][16];
+
+	static void report(const char* _name, uint32_t _len, uint64_t _startClock, uint32_t _iterations)
+	{
+		const double seconds = double(cpuTime(_startClock));
+		printf("%-18s %6u bytes  %9.2f ns/hash  %7.2f GB/s\n", _name, _len,
+			seconds * 1e9 / _iterations, double(_len) * _iterations / seconds / 1e9);
+	}
+
+	/// Throughput of single key hashes, keys start at varying offsets.
+	static RNOINLINE void benchLength(uint32_t _len)
+	{
+		const uint32_t iterations = TOTAL_BYTES / _len;
+		uint64_t clock;
+
+		clock = cpuClock();
+		for (uint32_t i=0; i<iterations; ++i)
+			g_sink += hashMurmur3(g_buffer + (i & 63), _len);
+		report("hashMurmur3", _len, clock, iterations);
+
+		clock = cpuClock();
+		for (uint32_t i=0; i<iterations; ++i)
+			g_sink += hashStr((const char*)g_buffer + (i & 63), _len);
+		report("hashStr", _len, clock, iterations);
+
+		clock = cpuClock();
+		for (uint32_t i=0; i<iterations; ++i)
+			g_sink += hashFNV1a_64(g_buffer + (i & 63), _len);
+		report("hashFNV1a_64", _len, clock, iterations);
+
+		clock = cpuClock();
+		for (uint32_t i=0; i<iterations; ++i)
+			g_sink += hashCity32(g_buffer + (i & 63), _len);
+		report("hashCity32", _len, clock, iterations);
+
+		clock = cpuClock();
+		for (uint32_t i=0; i<iterations; ++i)
+			g_sink += hashCity64(g_buffer + (i & 63), _len);
+		report("hashCity64", _len, clock, iterations);
+
+		clock = cpuClock();
+		for (uint32_t i=0; i<iterations; ++i)
+			g_sink += hashFast64(g_buffer + (i & 63), _len);
+		report("hashFast64", _len, clock, iterations);
+
+		clock = cpuClock();
+		for (uint32_t i=0; i<iterations; ++i)
+		{
+			uint64_t hash[2];
+			hashFast128(g_buffer + (i & 63), _len, hash);
+			g_sink += hash[0] ^ hash[1];
+		}
+		report("hashFast128", _len, clock, iterations);
+
+		printf("\n");
+	}
+
+	static void reportKeys(const char* _name, uint32_t _len, uint64_t _startClock)
+	{
+		const double seconds = double(cpuTime(_startClock));
+		printf("%-22s %4u bytes  %8.2f M keys/s\n", _name, _len, double(TOTAL_KEYS) / seconds / 1e6);
+	}
+
+	/// Keys per second of batched hashes against calling the single key version in a loop.
+	static RNOINLINE void benchBatch(uint32_t _len)
+	{
+		for (uint32_t i=0; i<BATCH_KEYS; ++i)
+		{
+			g_keys[i] = g_buffer + (i * 61) % (BUFFER_SIZE - _len);
+			g_lens[i] = _len;
+		}
+
+		const char* const* strings = (const char* const*)g_keys;
+		const uint32_t numBatches = TOTAL_KEYS / BATCH_KEYS;
+		uint64_t clock;
+
+		clock = cpuClock();
+		for (uint32_t b=0; b<numBatches; ++b)
+		{
+			for (uint32_t i=0; i<BATCH_KEYS; ++i)
+				g_hashes[i] = hashMurmur3(g_keys[i], g_lens[i], b);
+			g_sink += g_hashes[b & (BATCH_KEYS - 1)];
+		}
+		reportKeys("hashMurmur3 loop", _len, clock);
+
+		clock = cpuClock();
+		for (uint32_t b=0; b<numBatches; ++b)
+		{
+			hashMurmur3Batch(g_keys, g_lens, BATCH_KEYS, g_hashes, b);
+			g_sink += g_hashes[b & (BATCH_KEYS - 1)];
+		}
+		reportKeys("hashMurmur3Batch", _len, clock);
+
+		clock = cpuClock();
+		for (uint32_t b=0; b<numBatches; ++b)
+		{
+			for (uint32_t i=0; i<BATCH_KEYS; ++i)
+				g_hashes[i] = hashStr(strings[i], _len);
+			g_sink += g_hashes[b & (BATCH_KEYS - 1)];
+		}
+		reportKeys("hashStr loop", _len, clock);
+
+		clock = cpuClock();
+		for (uint32_t b=0; b<numBatches; ++b)
+		{
+			hashStrBatch(strings, BATCH_KEYS, g_hashes, _len);
+			g_sink += g_hashes[b & (BATCH_KEYS - 1)];
+		}
+		reportKeys("hashStrBatch", _len, clock);
+
+		printf("\n");
+	}
+
+	/// MD5 as it was before the transform was rewritten, RSA reference code with
+	/// byte wise decode, kept to measure the new core against.
+	struct MD5Original
+	{
+		uint32_t	m_state[4];
+		uint32_t	m_count[2];
+		uint8_t		m_buffer[64];
+
+		static inline uint32_t rotl(uint32_t _x, uint32_t _n) { return (_x << _n) | (_x >> (32 - _n)); }
+
+		static void encode(uint8_t* _output, const uint32_t* _input, uint32_t _length)
+		{
+			for (uint32_t i=0, j=0; j<_length; i++, j+=4)
+			{
+				_output[j]		= uint8_t( _input[i]        & 0xff);
+				_output[j+1]	= uint8_t((_input[i] >> 8)  & 0xff);
+				_output[j+2]	= uint8_t((_input[i] >> 16) & 0xff);
+				_output[j+3]	= uint8_t((_input[i] >> 24) & 0xff);
+			}
+		}
+
+		void init()
+		{
+			m_count[0] = m_count[1] = 0;
+			m_state[0] = 0x67452301;
+			m_state[1] = 0xefcdab89;
+			m_state[2] = 0x98badcfe;
+			m_state[3] = 0x10325476;
+		}
+
+		void transform(const uint8_t _block[64])
+		{
+			uint32_t a = m_state[0], b = m_state[1], c = m_state[2], d = m_state[3];
+			uint32_t x[16];
+			for (uint32_t i=0, j=0; j<64; i++, j+=4)
+				x[i] = uint32_t(_block[j]) | (uint32_t(_block[j+1]) << 8) | (uint32_t(_block[j+2]) << 16) | (uint32_t(_block[j+3]) << 24);
+
+#define MD5_STEP(_f, _a, _b, _c, _d, _x, _s, _ac) _a += _f(_b, _c, _d) + _x + _ac; _a = rotl(_a, _s) + _b
+#define MD5_F(_x, _y, _z) (((_x) & (_y)) | (~(_x) & (_z)))
+#define MD5_G(_x, _y, _z) (((_x) & (_z)) | ((_y) & ~(_z)))
+#define MD5_H(_x, _y, _z) ((_x) ^ (_y) ^ (_z))
+#define MD5_I(_x, _y, _z) ((_y) ^ ((_x) | ~(_z)))
+			MD5_STEP(MD5_F, a, b, c, d, x[ 0],  7, 0xd76aa478); MD5_STEP(MD5_F, d, a, b, c, x[ 1], 12, 0xe8c7b756);
+			MD5_STEP(MD5_F, c, d, a, b, x[ 2], 17, 0x242070db); MD5_STEP(MD5_F, b, c, d, a, x[ 3], 22, 0xc1bdceee);
+			MD5_STEP(MD5_F, a, b, c, d, x[ 4],  7, 0xf57c0faf); MD5_STEP(MD5_F, d, a, b, c, x[ 5], 12, 0x4787c62a);
+			MD5_STEP(MD5_F, c, d, a, b, x[ 6], 17, 0xa8304613); MD5_STEP(MD5_F, b, c, d, a, x[ 7], 22, 0xfd469501);
+			MD5_STEP(MD5_F, a, b, c, d, x[ 8],  7, 0x698098d8); MD5_STEP(MD5_F, d, a, b, c, x[ 9], 12, 0x8b44f7af);
+			MD5_STEP(MD5_F, c, d, a, b, x[10], 17, 0xffff5bb1); MD5_STEP(MD5_F, b, c, d, a, x[11], 22, 0x895cd7be);
+			MD5_STEP(MD5_F, a, b, c, d, x[12],  7, 0x6b901122); MD5_STEP(MD5_F, d, a, b, c, x[13], 12, 0xfd987193);
+			MD5_STEP(MD5_F, c, d, a, b, x[14], 17, 0xa679438e); MD5_STEP(MD5_F, b, c, d, a, x[15], 22, 0x49b40821);
+			MD5_STEP(MD5_G, a, b, c, d, x[ 1],  5, 0xf61e2562); MD5_STEP(MD5_G, d, a, b, c, x[ 6],  9, 0xc040b340);
+			MD5_STEP(MD5_G, c, d, a, b, x[11], 14, 0x265e5a51); MD5_STEP(MD5_G, b, c, d, a, x[ 0], 20, 0xe9b6c7aa);
+			MD5_STEP(MD5_G, a, b, c, d, x[ 5],  5, 0xd62f105d); MD5_STEP(MD5_G, d, a, b, c, x[10],  9, 0x02441453);
+			MD5_STEP(MD5_G, c, d, a, b, x[15], 14, 0xd8a1e681); MD5_STEP(MD5_G, b, c, d, a, x[ 4], 20, 0xe7d3fbc8);
+			MD5_STEP(MD5_G, a, b, c, d, x[ 9],  5, 0x21e1cde6); MD5_STEP(MD5_G, d, a, b, c, x[14],  9, 0xc33707d6);
+			MD5_STEP(MD5_G, c, d, a, b, x[ 3], 14, 0xf4d50d87); MD5_STEP(MD5_G, b, c, d, a, x[ 8], 20, 0x455a14ed);
+			MD5_STEP(MD5_G, a, b, c, d, x[13],  5, 0xa9e3e905); MD5_STEP(MD5_G, d, a, b, c, x[ 2],  9, 0xfcefa3f8);
+			MD5_STEP(MD5_G, c, d, a, b, x[ 7], 14, 0x676f02d9); MD5_STEP(MD5_G, b, c, d, a, x[12], 20, 0x8d2a4c8a);
+			MD5_STEP(MD5_H, a, b, c, d, x[ 5],  4, 0xfffa3942); MD5_STEP(MD5_H, d, a, b, c, x[ 8], 11, 0x8771f681);
+			MD5_STEP(MD5_H, c, d, a, b, x[11], 16, 0x6d9d6122); MD5_STEP(MD5_H, b, c, d, a, x[14], 23, 0xfde5380c);
+			MD5_STEP(MD5_H, a, b, c, d, x[ 1],  4, 0xa4beea44); MD5_STEP(MD5_H, d, a, b, c, x[ 4], 11, 0x4bdecfa9);
+			MD5_STEP(MD5_H, c, d, a, b, x[ 7], 16, 0xf6bb4b60); MD5_STEP(MD5_H, b, c, d, a, x[10], 23, 0xbebfbc70);
+			MD5_STEP(MD5_H, a, b, c, d, x[13],  4, 0x289b7ec6); MD5_STEP(MD5_H, d, a, b, c, x[ 0], 11, 0xeaa127fa);
+			MD5_STEP(MD5_H, c, d, a, b, x[ 3], 16, 0xd4ef3085); MD5_STEP(MD5_H, b, c, d, a, x[ 6], 23, 0x04881d05);
+			MD5_STEP(MD5_H, a, b, c, d, x[ 9],  4, 0xd9d4d039); MD5_STEP(MD5_H, d, a, b, c, x[12], 11, 0xe6db99e5);
+			MD5_STEP(MD5_H, c, d, a, b, x[15], 16, 0x1fa27cf8); MD5_STEP(MD5_H, b, c, d, a, x[ 2], 23, 0xc4ac5665);
+			MD5_STEP(MD5_I, a, b, c, d, x[ 0],  6, 0xf4292244); MD5_STEP(MD5_I, d, a, b, c, x[ 7], 10, 0x432aff97);
+			MD5_STEP(MD5_I, c, d, a, b, x[14], 15, 0xab9423a7); MD5_STEP(MD5_I, b, c, d, a, x[ 5], 21, 0xfc93a039);
+			MD5_STEP(MD5_I, a, b, c, d, x[12],  6, 0x655b59c3); MD5_STEP(MD5_I, d, a, b, c, x[ 3], 10, 0x8f0ccc92);
+			MD5_STEP(MD5_I, c, d, a, b, x[10], 15, 0xffeff47d); MD5_STEP(MD5_I, b, c, d, a, x[ 1], 21, 0x85845dd1);
+			MD5_STEP(MD5_I, a, b, c, d, x[ 8],  6, 0x6fa87e4f); MD5_STEP(MD5_I, d, a, b, c, x[15], 10, 0xfe2ce6e0);
+			MD5_STEP(MD5_I, c, d, a, b, x[ 6], 15, 0xa3014314); MD5_STEP(MD5_I, b, c, d, a, x[13], 21, 0x4e0811a1);
+			MD5_STEP(MD5_I, a, b, c, d, x[ 4],  6, 0xf7537e82); MD5_STEP(MD5_I, d, a, b, c, x[11], 10, 0xbd3af235);
+			MD5_STEP(MD5_I, c, d, a, b, x[ 2], 15, 0x2ad7d2bb); MD5_STEP(MD5_I, b, c, d, a, x[ 9], 21, 0xeb86d391);
+#undef MD5_STEP
+#undef MD5_F
+#undef MD5_G
+#undef MD5_H
+#undef MD5_I
+
+			m_state[0] += a;
+			m_state[1] += b;
+			m_state[2] += c;
+			m_state[3] += d;
+
+			memSet(x, 0, sizeof(x));
+		}
+
+		void process(const uint8_t* _input, uint32_t _length)
+		{
+			uint32_t index = (m_count[0] >> 3) & 0x3f;
+			if ((m_count[0] += (_length << 3)) < (_length << 3))
+				m_count[1]++;
+			m_count[1] += _length >> 29;
+
+			const uint32_t space = 64 - index;
+			uint32_t i = 0;
+			if (_length >= space)
+			{
+				memCopy(m_buffer + index, space, _input, space);
+				transform(m_buffer);
+
+				for (i=space; i+63<_length; i+=64)
+					transform(_input + i);
+
+				index = 0;
+			}
+
+			memCopy(m_buffer + index, _length - i, _input + i, _length - i);
+		}
+
+		void finalize(uint8_t _digest[16])
+		{
+			static const uint8_t padding[64] = { 0x80 };
+
+			uint8_t bits[8];
+			encode(bits, m_count, 8);
+
+			const uint32_t index = (m_count[0] >> 3) & 0x3f;
+			process(padding, index < 56 ? 56 - index : 120 - index);
+			process(bits, 8);
+			encode(_digest, m_state, 16);
+		}
+	};
+
+	static void hashMD5Original(const void* _data, uint32_t _dataSize, uint8_t _digest[16])
+	{
+		MD5Original md5;
+		md5.init();
+		md5.process((const uint8_t*)_data, _dataSize);
+		md5.finalize(_digest);
+	}
+
+	static void reportMD5(const char* _name, uint32_t _size, uint64_t _startClock)
+	{
+		const double seconds = double(cpuTime(_startClock));
+		printf("%-18s %6u bytes  %7.3f GB/s\n", _name, _size, double(MD5_BYTES) / seconds / 1e9);
+	}
+
+	/// MD5 throughput of the original code, the new single buffer core and the batched lanes.
+	static RNOINLINE void benchMD5(uint32_t _size)
+	{
+		const uint32_t numBuffers = _size < BATCH_KEYS ? BATCH_KEYS / 16 : 16;
+		const uint32_t numBatches = MD5_BYTES / (_size * numBuffers);
+
+		for (uint32_t i=0; i<numBuffers; ++i)
+		{
+			g_keys[i] = g_buffer + (i * 61) % (BUFFER_SIZE - _size + 1);
+			g_lens[i] = _size;
+		}
+
+		uint64_t clock;
+
+		clock = cpuClock();
+		for (uint32_t b=0; b<numBatches; ++b)
+			for (uint32_t i=0; i<numBuffers; ++i)
+				hashMD5Original(g_keys[i], g_lens[i], g_digests[i]);
+		g_sink += g_digests[0][0];
+		reportMD5("original hashMD5", _size, clock);
+
+		clock = cpuClock();
+		for (uint32_t b=0; b<numBatches; ++b)
+			for (uint32_t i=0; i<numBuffers; ++i)
+				hashMD5(g_keys[i], g_lens[i], g_digests[i]);
+		g_sink += g_digests[0][0];
+		reportMD5("hashMD5", _size, clock);
+
+		clock = cpuClock();
+		for (uint32_t b=0; b<numBatches; ++b)
+			hashMD5Batch(g_keys, g_lens, numBuffers, g_digests);
+		g_sink += g_digests[0][0];
+		reportMD5("hashMD5Batch", _size, clock);
+
+		// all three have to agree, otherwise the numbers mean nothing
+		uint8_t digest[16];
+		hashMD5Original(g_keys[numBuffers - 1], _size, digest);
+		if (0 != memCompare(digest, g_digests[numBuffers - 1], 16))
+			printf("MD5 mismatch!\n");
+
+		printf("\n");
+	}
+
+} // namespace
+
+int main(int /*argc*/, char* /*argv*/[])
+{
+	// no zero bytes, string hashes run for the full length
+	for (uint32_t i=0; i<sizeof(g_buffer); ++i)
+		g_buffer[i] = uint8_t(i * 31 % 255 + 1);
+
+	const uint32_t lengths[] = { 4, 8, 16, 32, 64, 128, 256, 1024, 4096, BUFFER_SIZE };
+	for (uint32_t i=0; i<RTM_NUM_ELEMENTS(lengths); ++i)
+		benchLength(lengths[i]);
+
+	const uint32_t batchLengths[] = { 4, 8, 16, 32, 64, 256 };
+	for (uint32_t i=0; i<RTM_NUM_ELEMENTS(batchLengths); ++i)
+		benchBatch(batchLengths[i]);
+
+	const uint32_t md5Sizes[] = { 64, 256, 1024, 16 * 1024, BUFFER_SIZE };
+	for (uint32_t i=0; i<RTM_NUM_ELEMENTS(md5Sizes); ++i)
+		benchMD5(md5Sizes[i]);
+
+	return g_sink == 0 ? 1 : 0;
+}
@@ -0,0 +1,156 @@
+//--------------------------------------------------------------------------//
+/// Copyright 2025 Milos Tosic. All Rights Reserved.                       ///
+/// License: http://www.opensource.org/licenses/BSD-2-Clause               ///
+//--------------------------------------------------------------------------//
+
+// Standalone benchmark of HashMap against std::unordered_map, not part of the
+// test project. Build from the directory containing rbase, e.g.:
+//   c++ -std=c++17 -O2 -I. -Irbase/src rbase/test/bench/rbase_bench_hashmap.cpp rbase/src/hash.cpp -o bench_hashmap
+
+#ifndef RBASE_NAMESPACE
+#define RBASE_NAMESPACE rbase
+#endif
+
+#include <rbase/inc/platform.h>
+#define RTM_LIBHANDLER_DEFINE
+#include <rbase/inc/libhandler.h>
+#include <rbase/inc/hashmap.h>
+#include <rbase/inc/random.h>
+#include <rbase/inc/cpu.h>
+
+#include <stdio.h>
+#include <unordered_map>
+
+using namespace rtm;
+
+namespace {
+
+	enum
+	{
+		MAX_ITEMS	= 4 * 1024 * 1024,
+		TOTAL_OPS	= 16 * 1024 * 1024		// operations per measurement, over repeated passes
+	};
+
+	uint64_t g_sink;
+
+	static void report(const char* _name, uint32_t _numItems, uint64_t _startClock, uint32_t _ops)
+	{
+		const double seconds = double(cpuTime(_startClock));
+		printf("%-36s %8u items  %8.2f ns/op  %8.2f M ops/s\n", _name, _numItems,
+			seconds * 1e9 / _ops, double(_ops) / seconds / 1e6);
+	}
+
+	/// Same operations on both containers, so the two sets of numbers compare directly.
+	struct RtmMap
+	{
+		HashMap<uint64_t, uint64_t> m_map;
+
+		inline void reserve(uint32_t _numItems)			{ m_map.reserve(_numItems); }
+		inline void insert(uint64_t _key)				{ m_map.insert(_key, _key); }
+		inline uint64_t find(uint64_t _key) const		{ const uint64_t* value = m_map.find(_key); return value ? *value : 1; }
+	};
+
+	struct StdMap
+	{
+		std::unordered_map<uint64_t, uint64_t> m_map;
+
+		inline void reserve(uint32_t _numItems)			{ m_map.reserve(_numItems); }
+		inline void insert(uint64_t _key)				{ m_map[_key] = _key; }
+		inline uint64_t find(uint64_t _key) const		{ auto it = m_map.find(_key); return it != m_map.end() ? it->second : 1; }
+	};
+
+	/// Times insert into an empty map with and without reserve, then lookups of
+	/// present keys in shuffled order and lookups of keys that were never inserted.
+	template <typename MAP>
+	static RNOINLINE void bench(const char* _name, const uint64_t* _keys, const uint64_t* _hits, const uint64_t* _misses, uint32_t _numItems)
+	{
+		const uint32_t passes	= TOTAL_OPS / _numItems;
+		const uint32_t ops		= passes * _numItems;
+		char name[64];
+		uint64_t clock;
+
+		clock = cpuClock();
+		for (uint32_t pass=0; pass<passes; ++pass)
+		{
+			MAP map;
+			for (uint32_t i=0; i<_numItems; ++i)
+				map.insert(_keys[i]);
+			g_sink += map.find(_keys[0]);
+		}
+		snprintf(name, sizeof(name), "%s insert", _name);
+		report(name, _numItems, clock, ops);
+
+		clock = cpuClock();
+		for (uint32_t pass=0; pass<passes; ++pass)
+		{
+			MAP map;
+			map.reserve(_numItems);
+			for (uint32_t i=0; i<_numItems; ++i)
+				map.insert(_keys[i]);
+			g_sink += map.find(_keys[0]);
+		}
+		snprintf(name, sizeof(name), "%s insert reserved", _name);
+		report(name, _numItems, clock, ops);
+
+		MAP map;
+		for (uint32_t i=0; i<_numItems; ++i)
+			map.insert(_keys[i]);
+
+		clock = cpuClock();
+		for (uint32_t pass=0; pass<passes; ++pass)
+			for (uint32_t i=0; i<_numItems; ++i)
+				g_sink += map.find(_hits[i]);
+		snprintf(name, sizeof(name), "%s lookup hit", _name);
+		report(name, _numItems, clock, ops);
+
+		clock = cpuClock();
+		for (uint32_t pass=0; pass<passes; ++pass)
+			for (uint32_t i=0; i<_numItems; ++i)
+				g_sink += map.find(_misses[i]);
+		snprintf(name, sizeof(name), "%s lookup miss", _name);
+		report(name, _numItems, clock, ops);
+	}
+
+} // namespace
+
+int main(int /*argc*/, char* /*argv*/[])
+{
+	uint64_t* keys		= new uint64_t[MAX_ITEMS];
+	uint64_t* hits		= new uint64_t[MAX_ITEMS];
+	uint64_t* misses	= new uint64_t[MAX_ITEMS];
+
+	// inserted keys are even and missed keys odd, so a miss never finds anything
+	Random random;
+	for (uint32_t i=0; i<MAX_ITEMS; ++i)
+	{
+		keys[i]		= ((uint64_t(random.gen()) << 32) | random.gen()) & ~uint64_t(1);
+		misses[i]	= ((uint64_t(random.gen()) << 32) | random.gen()) | 1;
+	}
+
+	const uint32_t sizes[] = { 64, 1024, 64 * 1024, 1024 * 1024, MAX_ITEMS };
+	for (uint32_t i=0; i<RTM_NUM_ELEMENTS(sizes); ++i)
+	{
+		const uint32_t numItems = sizes[i];
+
+		// hits are a shuffle of the keys inserted at this size
+		for (uint32_t j=0; j<numItems; ++j)
+			hits[j] = keys[j];
+		for (uint32_t j=numItems-1; j>0; --j)
+		{
+			const uint32_t k = random.gen() % (j + 1);
+			const uint64_t swap = hits[j];
+			hits[j] = hits[k];
+			hits[k] = swap;
+		}
+
+		bench<RtmMap>("HashMap", keys, hits, misses, numItems);
+		bench<StdMap>("std::unordered_map", keys, hits, misses, numItems);
+		printf("\n");
+	}
+
+	delete[] keys;
+	delete[] hits;
+	delete[] misses;
+
+	return g_sink == 0 ? 1 : 0;
+}
@@ -0,0 +1,221 @@
+//--------------------------------------------------------------------------//
+/// Copyright 2025 Milos Tosic. All Rights Reserved.                       ///
+/// License: http://www.opensource.org/licenses/BSD-2-Clause               ///
+//--------------------------------------------------------------------------//
+
+// Standalone benchmark of JobSystem scaling, not part of the test project.
+// Build from the directory containing rbase, e.g.:
+//   c++ -std=c++17 -O2 -I. -Irbase/src rbase/test/bench/rbase_bench_jobs.cpp rbase/src/jobs.cpp -lpthread -o bench_jobs
+
+#include <rbase/inc/platform.h>
+#include <rbase/inc/jobs.h>
+#include <rbase/inc/thread.h>
+#include <rbase/inc/cpu.h>
+
+#include <math.h>
+#include <stdio.h>
+
+using namespace rtm;
+
+namespace {
+
+	enum
+	{
+		FIB_N			= 32,
+		FIB_CUTOFF		= 12,				// below this fib runs serially inside the job
+		SUM_SIZE		= 64 * 1024 * 1024,	// elements summed per measurement
+		NBODY_BODIES	= 4096,
+		NBODY_STEPS		= 4
+	};
+
+	double g_sink;
+
+	static double report(const char* _name, uint32_t _numThreads, uint64_t _startClock, double _baseSeconds)
+	{
+		const double seconds = double(cpuTime(_startClock));
+		const double speedup = _baseSeconds > 0.0 ? _baseSeconds / seconds : 1.0;
+		printf("%-12s %3u threads  %9.2f ms  %6.2fx\n", _name, _numThreads, seconds * 1e3, speedup);
+		return seconds;
+	}
+
+	//--------------------------------------------------------------------------
+	// fork/join, every level spawns one branch and computes the other itself
+
+	struct FibJob
+	{
+		JobSystem*	m_jobs;
+		uint32_t	m_n;
+		uint64_t	m_result;
+	};
+
+	static uint64_t fibSerial(uint32_t _n)
+	{
+		return _n < 2 ? _n : fibSerial(_n - 1) + fibSerial(_n - 2);
+	}
+
+	static void fibJob(void* _userData)
+	{
+		FibJob* fib = (FibJob*)_userData;
+		if (fib->m_n < FIB_CUTOFF)
+		{
+			fib->m_result = fibSerial(fib->m_n);
+			return;
+		}
+
+		FibJob lhs = { fib->m_jobs, fib->m_n - 1, 0 };
+		FibJob rhs = { fib->m_jobs, fib->m_n - 2, 0 };
+
+		JobCounter counter;
+		fib->m_jobs->run(fibJob, &lhs, &counter);
+		fibJob(&rhs);
+		fib->m_jobs->wait(&counter);
+
+		fib->m_result = lhs.m_result + rhs.m_result;
+	}
+
+	//--------------------------------------------------------------------------
+	// memory bound parallelFor
+
+	struct SumRange
+	{
+		const float*			m_data;
+		std::atomic<uint64_t>	m_bits;		// sum accumulated as fixed point, no atomic double
+
+		void operator()(uint32_t _begin, uint32_t _end)
+		{
+			double sum = 0.0;
+			for (uint32_t i=_begin; i<_end; ++i)
+				sum += m_data[i];
+			m_bits.fetch_add(uint64_t(sum * 16.0));
+		}
+	};
+
+	//--------------------------------------------------------------------------
+	// compute bound parallelFor, all pairs gravity
+
+	struct Body
+	{
+		float	m_position[3];
+		float	m_velocity[3];
+	};
+
+	struct NBodyStep
+	{
+		const Body*	m_bodies;
+		Body*		m_next;
+		uint32_t	m_numBodies;
+
+		void operator()(uint32_t _begin, uint32_t _end) const
+		{
+			const float dt = 0.001f;
+			for (uint32_t i=_begin; i<_end; ++i)
+			{
+				const Body& body = m_bodies[i];
+				float acc[3] = { 0.0f, 0.0f, 0.0f };
+				for (uint32_t j=0; j<m_numBodies; ++j)
+				{
+					const float dx = m_bodies[j].m_position[0] - body.m_position[0];
+					const float dy = m_bodies[j].m_position[1] - body.m_position[1];
+					const float dz = m_bodies[j].m_position[2] - body.m_position[2];
+					const float d2 = dx*dx + dy*dy + dz*dz + 0.01f;
+					const float inv = 1.0f / (d2 * sqrtf(d2));
+					acc[0] += dx * inv;
+					acc[1] += dy * inv;
+					acc[2] += dz * inv;
+				}
+
+				Body& next = m_next[i];
+				for (uint32_t k=0; k<3; ++k)
+				{
+					next.m_velocity[k] = body.m_velocity[k] + acc[k] * dt;
+					next.m_position[k] = body.m_position[k] + next.m_velocity[k] * dt;
+				}
+			}
+		}
+	};
+
+	struct Baseline
+	{
+		double	m_fib;
+		double	m_sum;
+		double	m_nbody;
+	};
+
+	static void bench(uint32_t _numThreads, const float* _data, Body* _bodies, Body* _temp, Baseline& _base)
+	{
+		JobSystem jobs;
+		jobs.init(_numThreads);
+
+		uint64_t clock = cpuClock();
+		FibJob fib = { &jobs, FIB_N, 0 };
+		fibJob(&fib);
+		g_sink += double(fib.m_result);
+		const double fibSeconds = report("fib", _numThreads, clock, _base.m_fib);
+
+		SumRange sum;
+		sum.m_data = _data;
+		sum.m_bits.store(0);
+		clock = cpuClock();
+		jobs.parallelFor(0, SUM_SIZE, sum);
+		g_sink += double(sum.m_bits.load());
+		const double sumSeconds = report("sum", _numThreads, clock, _base.m_sum);
+
+		clock = cpuClock();
+		for (uint32_t step=0; step<NBODY_STEPS; ++step)
+		{
+			NBodyStep nbody = { _bodies, _temp, NBODY_BODIES };
+			jobs.parallelFor(0, NBODY_BODIES, nbody, 16);
+
+			Body* swap = _bodies;
+			_bodies = _temp;
+			_temp = swap;
+		}
+		g_sink += _bodies[0].m_position[0];
+		const double nbodySeconds = report("nbody", _numThreads, clock, _base.m_nbody);
+
+		if (_numThreads == 1)
+		{
+			_base.m_fib		= fibSeconds;
+			_base.m_sum		= sumSeconds;
+			_base.m_nbody	= nbodySeconds;
+		}
+
+		jobs.shutdown();
+		printf("\n");
+	}
+
+} // namespace
+
+int main(int /*argc*/, char* /*argv*/[])
+{
+	float* data = new float[SUM_SIZE];
+	for (uint32_t i=0; i<SUM_SIZE; ++i)
+		data[i] = float(i & 1023) * 0.25f;
+
+	Body* bodies	= new Body[NBODY_BODIES];
+	Body* temp		= new Body[NBODY_BODIES];
+	for (uint32_t i=0; i<NBODY_BODIES; ++i)
+		for (uint32_t k=0; k<3; ++k)
+		{
+			bodies[i].m_position[k] = float((i * 7919 + k * 104729) % 1000) * 0.01f;
+			bodies[i].m_velocity[k] = 0.0f;
+		}
+
+	// powers of two up to all hardware threads, plus all of them
+	const uint32_t numHardwareThreads = threadGetNumHardwareThreads();
+	Baseline base = { 0.0, 0.0, 0.0 };
+	uint32_t numThreads = 1;
+	for (;;)
+	{
+		bench(numThreads, data, bodies, temp, base);
+		if (numThreads >= numHardwareThreads)
+			break;
+		numThreads = numThreads * 2 < numHardwareThreads ? numThreads * 2 : numHardwareThreads;
+	}
+
+	delete[] data;
+	delete[] bodies;
+	delete[] temp;
+
+	return g_sink == 0.0 ? 1 : 0;
+}
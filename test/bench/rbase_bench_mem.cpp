@@ -0,0 +1,118 @@
+//--------------------------------------------------------------------------//
+/// Copyright 2025 Milos Tosic. All Rights Reserved.                       ///
+/// License: http://www.opensource.org/licenses/BSD-2-Clause               ///
+//--------------------------------------------------------------------------//
+
+// Standalone benchmark of memSet/memCopy/memMove/memCompare against the C
+// library, not part of the test project. Build from the directory containing
+// rbase, e.g.:
+//   c++ -std=c++17 -O2 -I. rbase/test/bench/rbase_bench_mem.cpp -o bench_mem
+
+#include <rbase/inc/platform.h>
+#include <rbase/inc/stringfn.h>
+#include <rbase/inc/cpu.h>
+
+#include <stdio.h>
+#include <string.h>
+
+using namespace rtm;
+
+namespace {
+
+	enum
+	{
+		BUFFER_SIZE	= 64 * 1024 * 1024,
+		TOTAL_BYTES	= 512 * 1024 * 1024		// bytes processed per measurement
+	};
+
+	uint8_t*	g_src;
+	uint8_t*	g_dst;
+	uintptr_t	g_sink;
+
+	static void report(const char* _name, uint32_t _size, uint64_t _startClock, uint32_t _iterations)
+	{
+		const double seconds = double(cpuTime(_startClock));
+		printf("%-16s %9u bytes  %10.2f ns/call  %7.2f GB/s\n", _name, _size,
+			seconds * 1e9 / _iterations, double(_size) * _iterations / seconds / 1e9);
+	}
+
+	// not inlined so sizes are never compile time constants
+	static RNOINLINE void benchSize(uint32_t _size)
+	{
+		const uint32_t iterations = TOTAL_BYTES / _size;
+		uint64_t clock;
+
+		// offset by one on odd iterations so both aligned and unaligned calls are timed
+		clock = cpuClock();
+		for (uint32_t i=0; i<iterations; ++i)
+			memset(g_dst + (i & 1), int(i), _size);
+		g_sink += g_dst[_size / 2];
+		report("memset", _size, clock, iterations);
+
+		clock = cpuClock();
+		for (uint32_t i=0; i<iterations; ++i)
+			memSet(g_dst + (i & 1), uint8_t(i), _size);
+		g_sink += g_dst[_size / 2];
+		report("rtm::memSet", _size, clock, iterations);
+
+		clock = cpuClock();
+		for (uint32_t i=0; i<iterations; ++i)
+			memcpy(g_dst + (i & 1), g_src, _size);
+		g_sink += g_dst[_size / 2];
+		report("memcpy", _size, clock, iterations);
+
+		clock = cpuClock();
+		for (uint32_t i=0; i<iterations; ++i)
+			memCopy(g_dst + (i & 1), _size, g_src, _size);
+		g_sink += g_dst[_size / 2];
+		report("rtm::memCopy", _size, clock, iterations);
+
+		// overlapping move by a few bytes, alternating direction
+		clock = cpuClock();
+		for (uint32_t i=0; i<iterations; ++i)
+			memmove(g_dst + (i & 1) * 8, g_dst + 8 - (i & 1) * 8, _size);
+		g_sink += g_dst[_size / 2];
+		report("memmove", _size, clock, iterations);
+
+		clock = cpuClock();
+		for (uint32_t i=0; i<iterations; ++i)
+			memMove(g_dst + (i & 1) * 8, g_dst + 8 - (i & 1) * 8, _size);
+		g_sink += g_dst[_size / 2];
+		report("rtm::memMove", _size, clock, iterations);
+
+		// equal buffers, every byte is compared
+		memcpy(g_dst, g_src, _size);
+
+		clock = cpuClock();
+		for (uint32_t i=0; i<iterations; ++i)
+			g_sink += memcmp(g_dst, g_src, _size);
+		report("memcmp", _size, clock, iterations);
+
+		clock = cpuClock();
+		for (uint32_t i=0; i<iterations; ++i)
+			g_sink += memCompare(g_dst, g_src, _size);
+		report("rtm::memCompare", _size, clock, iterations);
+
+		printf("\n");
+	}
+
+} // namespace
+
+int main(int /*argc*/, char* /*argv*/[])
+{
+	g_src = new uint8_t[BUFFER_SIZE + 64];
+	g_dst = new uint8_t[BUFFER_SIZE + 64];
+
+	for (uint32_t i=0; i<BUFFER_SIZE + 64; ++i)
+		g_src[i] = uint8_t(i * 7);
+	memset(g_dst, 0, BUFFER_SIZE + 64);
+
+	const uint32_t sizes[] = { 8, 16, 32, 64, 256, 4096, 64 * 1024, 1024 * 1024, 16 * 1024 * 1024, BUFFER_SIZE };
+	for (uint32_t i=0; i<RTM_NUM_ELEMENTS(sizes); ++i)
+		benchSize(sizes[i]);
+
+	delete[] g_src;
+	delete[] g_dst;
+
+	return g_sink == 0 ? 1 : 0;
+}
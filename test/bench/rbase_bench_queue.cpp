@@ -0,0 +1,173 @@
+//--------------------------------------------------------------------------//
+/// Copyright 2025 Milos Tosic. All Rights Reserved.                       ///
+/// License: http://www.opensource.org/licenses/BSD-2-Clause               ///
+//--------------------------------------------------------------------------//
+
+// Standalone benchmark of SpScQueue and MpMcQueue throughput, not part of the
+// test project. Build from the directory containing rbase, e.g.:
+//   c++ -std=c++17 -O2 -I. rbase/test/bench/rbase_bench_queue.cpp -lpthread -o bench_queue
+
+#ifndef RBASE_NAMESPACE
+#define RBASE_NAMESPACE rbase
+#endif
+
+#include <rbase/inc/platform.h>
+#define RTM_LIBHANDLER_DEFINE
+#include <rbase/inc/libhandler.h>
+#include <rbase/inc/queue.h>
+#include <rbase/inc/thread.h>
+#include <rbase/inc/cpu.h>
+
+#include <stdio.h>
+
+using namespace rtm;
+
+namespace {
+
+	enum
+	{
+		QUEUE_SIZE			= 1024,
+		BATCH_SIZE			= 32,
+		LOCAL_MESSAGES		= 64 * 1024 * 1024,		// messages per single thread measurement
+		THREAD_MESSAGES		= 16 * 1024 * 1024		// messages per two thread measurement
+	};
+
+	uintptr_t g_sink;
+
+	static void report(const char* _name, uint64_t _startClock, uint32_t _messages)
+	{
+		const double seconds = double(cpuTime(_startClock));
+		printf("%-28s %8.2f ns/msg  %8.2f M msg/s\n", _name,
+			seconds * 1e9 / _messages, double(_messages) / seconds / 1e6);
+	}
+
+	/// Returns size of the next batch, last batch ends exactly at THREAD_MESSAGES.
+	static inline uint32_t batchSize(uint32_t _done)
+	{
+		const uint32_t left = uint32_t(THREAD_MESSAGES) - _done;
+		return left < uint32_t(BATCH_SIZE) ? left : uint32_t(BATCH_SIZE);
+	}
+
+	/// Producer side of a two thread measurement, pinned to the second hardware thread.
+	struct Producer
+	{
+		SpScQueue<uintptr_t>*	m_spsc;
+		MpMcQueue<uintptr_t>*	m_mpmc;
+		bool					m_batched;
+	};
+
+	static int32_t producerEntry(void* _userData)
+	{
+		Producer* producer = (Producer*)_userData;
+		threadSetAffinity(1);
+
+		if (producer->m_spsc && producer->m_batched)
+		{
+			uintptr_t items[BATCH_SIZE];
+			for (uint32_t i=0; i<THREAD_MESSAGES; )
+			{
+				const uint32_t count = batchSize(i);
+				for (uint32_t j=0; j<count; ++j)
+					items[j] = i + j;
+
+				const uint32_t written = producer->m_spsc->writeN(items, count);
+				if (!written)
+					threadYield();
+				i += written;
+			}
+		}
+		else
+		if (producer->m_spsc)
+		{
+			for (uint32_t i=0; i<THREAD_MESSAGES; ++i)
+				while (!producer->m_spsc->write(uintptr_t(i)))
+					threadYield();
+		}
+		else
+		{
+			for (uint32_t i=0; i<THREAD_MESSAGES; ++i)
+				while (!producer->m_mpmc->enqueue(uintptr_t(i)))
+					threadYield();
+		}
+		return 0;
+	}
+
+	static void benchLocal()
+	{
+		SpScQueue<uintptr_t> spsc(QUEUE_SIZE);
+		MpMcQueue<uintptr_t> mpmc(QUEUE_SIZE);
+		uintptr_t item = 0;
+		uint64_t clock;
+
+		clock = cpuClock();
+		for (uint32_t i=0; i<LOCAL_MESSAGES; ++i)
+		{
+			spsc.write(uintptr_t(i));
+			spsc.read(&item);
+			g_sink += item;
+		}
+		report("SpScQueue write/read", clock, LOCAL_MESSAGES);
+
+		clock = cpuClock();
+		for (uint32_t i=0; i<LOCAL_MESSAGES; ++i)
+		{
+			mpmc.enqueue(uintptr_t(i));
+			mpmc.dequeue(item);
+			g_sink += item;
+		}
+		report("MpMcQueue enqueue/dequeue", clock, LOCAL_MESSAGES);
+	}
+
+	static void benchThreads(const char* _name, SpScQueue<uintptr_t>* _spsc, MpMcQueue<uintptr_t>* _mpmc, bool _batched)
+	{
+		Producer producer;
+		producer.m_spsc		= _spsc;
+		producer.m_mpmc		= _mpmc;
+		producer.m_batched	= _batched;
+
+		const uint64_t clock = cpuClock();
+
+		Thread thread;
+		thread.start(producerEntry, &producer);
+
+		uintptr_t items[BATCH_SIZE];
+		for (uint32_t i=0; i<THREAD_MESSAGES; )
+		{
+			uint32_t count;
+			if (_spsc && _batched)
+				count = _spsc->readN(items, batchSize(i));
+			else
+			if (_spsc)
+				count = _spsc->read(&items[0]) ? 1 : 0;
+			else
+				count = _mpmc->dequeue(items[0]) ? 1 : 0;
+
+			if (!count)
+				threadYield();
+
+			for (uint32_t j=0; j<count; ++j)
+				g_sink += items[j];
+			i += count;
+		}
+
+		thread.stop();
+		report(_name, clock, THREAD_MESSAGES);
+	}
+
+} // namespace
+
+int main(int /*argc*/, char* /*argv*/[])
+{
+	benchLocal();
+
+	threadSetAffinity(0);
+
+	SpScQueue<uintptr_t> spsc(QUEUE_SIZE);
+	MpMcQueue<uintptr_t> mpmc(QUEUE_SIZE);
+
+	benchThreads("SpScQueue 2 threads", &spsc, 0, false);
+	benchThreads("SpScQueue 2 threads batched", &spsc, 0, true);
+	benchThreads("MpMcQueue 2 threads", 0, &mpmc, false);
+
+	return g_sink == 0 ? 1 : 0;
+}
@@ -0,0 +1,208 @@
+//--------------------------------------------------------------------------//
+/// Copyright 2025 Milos Tosic. All Rights Reserved.                       ///
+/// License: http://www.opensource.org/licenses/BSD-2-Clause               ///
+//--------------------------------------------------------------------------//
+
+// Standalone benchmark of radix sort, not part of the test project. Compares
+// serial sort against the original implementation and every path around the
+// size thresholds, then measures parallel scaling. Optional argument caps the
+// largest parallel sort, in millions of keys.
+// Build from the directory containing rbase, e.g.:
+//   c++ -std=c++17 -O2 -I. -Irbase/src rbase/test/bench/rbase_bench_radixsort.cpp rbase/src/radixsort.cpp rbase/src/jobs.cpp rbase/src/lib_interface.cpp -lpthread -o bench_radixsort
+
+#include <rbase/inc/platform.h>
+#include <rbase/inc/radixsort.h>
+#include <rbase/inc/jobs.h>
+#include <rbase/inc/random.h>
+#include <rbase/inc/cpu.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace rtm;
+
+namespace {
+
+	enum
+	{
+		MAX_KEYS		= 100 * 1000 * 1000,
+		MAX_THREADS		= 16,
+		SERIAL_KEYS		= 4 * 1024 * 1024		// keys sorted per serial measurement, over repeated sorts
+	};
+
+	static const uint32_t s_serialSizes[] =
+	{
+		16, 32, 64, 65, 128, 256, 511, 512, 1024, 4096,
+		64 * 1024, 128 * 1024, 256 * 1024 - 1, 256 * 1024, 1024 * 1024, 4 * 1024 * 1024
+	};
+
+	static const uint32_t s_sizes[] = { 1000 * 1000, 10 * 1000 * 1000, 100 * 1000 * 1000 };
+
+	uint64_t g_sink;
+
+	/// Radix sort as it was before size tuning, three fixed 11bit passes.
+	static void sortRadixOriginal(uint32_t* _keys, uint32_t* _tempKeys, uint32_t _size)
+	{
+		uint32_t* originalKeys = _keys;
+		uint32_t histogram[RTM_RADIXSORT_HISTOGRAM_SIZE];
+		uint32_t shift = 0;
+		for (uint32_t pass=0; pass<3; ++pass)
+		{
+			memSet(histogram, 0, sizeof(histogram));
+			for (uint32_t i=0; i<_size; ++i)
+				++histogram[(_keys[i] >> shift) & RTM_RADIXSORT_BIT_MASK];
+
+			uint32_t offset = 0;
+			for (uint32_t i=0; i<RTM_RADIXSORT_HISTOGRAM_SIZE; ++i)
+			{
+				const uint32_t count = histogram[i];
+				histogram[i] = offset;
+				offset += count;
+			}
+
+			for (uint32_t i=0; i<_size; ++i)
+			{
+				const uint32_t key = _keys[i];
+				_tempKeys[histogram[(key >> shift) & RTM_RADIXSORT_BIT_MASK]++] = key;
+			}
+
+			uint32_t* swapKeys = _tempKeys;
+			_tempKeys = _keys;
+			_keys = swapKeys;
+
+			shift += RTM_RADIXSORT_BITS;
+		}
+
+		if (_keys != originalKeys)
+			memCopy(originalKeys, _size * sizeof(uint32_t), _keys, _size * sizeof(uint32_t));
+	}
+
+	enum Path
+	{
+		Original,
+		Tuned,
+		Small,
+		Digits8,
+		Digits11,
+		Digits11WriteCombine,
+
+		NumPaths
+	};
+
+	static const char* s_pathNames[NumPaths] = { "original", "tuned", "small", "8bit", "11bit", "11bit wc" };
+
+	static void sortPath(Path _path, uint32_t* _keys, uint32_t* _temp, uint32_t _size)
+	{
+		using namespace radixsort_private;
+
+		switch (_path)
+		{
+		case Original:				sortRadixOriginal(_keys, _temp, _size); break;
+		case Tuned:					sortRadix(_keys, _temp, _size); break;
+		case Small:					sortSmall<uint32_t, NoValue, false>(_keys, _temp, 0, 0, _size); break;
+		case Digits8:				sortDigits<uint32_t, NoValue, false, 8>(_keys, _temp, 0, 0, _size, false); break;
+		case Digits11:				sortDigits<uint32_t, NoValue, false, RTM_RADIXSORT_BITS>(_keys, _temp, 0, 0, _size, false); break;
+		case Digits11WriteCombine:	sortDigits<uint32_t, NoValue, false, RTM_RADIXSORT_BITS>(_keys, _temp, 0, 0, _size, true); break;
+		default: break;
+		}
+	}
+
+	/// Prints ns per key of every serial path, tuned sort should match the fastest one at each size.
+	static void benchThresholds(const uint32_t* _source, uint32_t* _keys, uint32_t* _temp)
+	{
+		printf("%10s", "keys");
+		for (uint32_t path=0; path<NumPaths; ++path)
+			printf("  %10s", s_pathNames[path]);
+		printf("   ns/key\n");
+
+		for (uint32_t i=0; i<RTM_NUM_ELEMENTS(s_serialSizes); ++i)
+		{
+			const uint32_t size		= s_serialSizes[i];
+			const uint32_t numSorts	= SERIAL_KEYS / size;
+
+			printf("%10u", size);
+			for (uint32_t path=0; path<NumPaths; ++path)
+			{
+				if ((path == Small) && (size > radixsort_private::SMALL_SORT_SIZE))
+				{
+					printf("  %10s", "-");
+					continue;
+				}
+
+				uint64_t elapsed = 0;
+				for (uint32_t sort=0; sort<numSorts; ++sort)
+				{
+					// every sort gets unsorted keys, copy is not measured
+					const uint32_t* source = _source + (sort * size) % (SERIAL_KEYS - size + 1);
+					memCopy(_keys, size * sizeof(uint32_t), source, size * sizeof(uint32_t));
+
+					const uint64_t clock = cpuClock();
+					sortPath(Path(path), _keys, _temp, size);
+					elapsed += cpuClock() - clock;
+					g_sink += _keys[0];
+				}
+
+				const double seconds = double(elapsed) / double(cpuFrequency());
+				printf("  %10.2f", seconds * 1e9 / (double(numSorts) * size));
+			}
+			printf("\n");
+		}
+		printf("\n");
+	}
+
+	static void benchScaling(const uint32_t* _source, uint32_t* _keys, uint32_t* _temp, uint32_t _size)
+	{
+		double baseSeconds = 0.0;
+		for (uint32_t numThreads=1; numThreads<=MAX_THREADS; numThreads*=2)
+		{
+			JobSystem jobs;
+			jobs.init(numThreads, false);
+
+			memCopy(_keys, _size * sizeof(uint32_t), _source, _size * sizeof(uint32_t));
+
+			const uint64_t clock = cpuClock();
+			sortRadixParallel(_keys, _temp, _size, &jobs);
+			const double seconds = double(cpuTime(clock));
+
+			if (numThreads == 1)
+				baseSeconds = seconds;
+
+			g_sink += _keys[_size / 2];
+			printf("%6uM keys %3u threads  %9.2f ms  %8.2f M keys/s  %6.2fx\n", _size / (1000 * 1000), numThreads,
+				seconds * 1e3, double(_size) / seconds / 1e6, baseSeconds / seconds);
+
+			jobs.shutdown();
+		}
+		printf("\n");
+	}
+
+} // namespace
+
+int main(int _argc, char* _argv[])
+{
+	uint32_t maxKeys = MAX_KEYS;
+	if (_argc > 1)
+		maxKeys = uint32_t(atoi(_argv[1])) * 1000 * 1000;
+
+	const uint32_t numKeys = maxKeys > uint32_t(SERIAL_KEYS) ? maxKeys : uint32_t(SERIAL_KEYS);
+
+	uint32_t* source	= new uint32_t[numKeys];
+	uint32_t* keys		= new uint32_t[numKeys];
+	uint32_t* temp		= new uint32_t[numKeys];
+
+	Random random;
+	for (uint32_t i=0; i<numKeys; ++i)
+		source[i] = random.gen();
+
+	benchThresholds(source, keys, temp);
+
+	for (uint32_t i=0; i<RTM_NUM_ELEMENTS(s_sizes); ++i)
+		if (s_sizes[i] <= maxKeys)
+			benchScaling(source, keys, temp, s_sizes[i]);
+
+	delete[] source;
+	delete[] keys;
+	delete[] temp;
+
+	return g_sink == 0 ? 1 : 0;
+}
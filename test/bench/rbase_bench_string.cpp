@@ -0,0 +1,101 @@
+//--------------------------------------------------------------------------//
+/// Copyright 2025 Milos Tosic. All Rights Reserved.                       ///
+/// License: http://www.opensource.org/licenses/BSD-2-Clause               ///
+//--------------------------------------------------------------------------//
+
+// Standalone benchmark of strLen/strChr/strStr against the C library, not part
+// of the test project. Build from the directory containing rbase, e.g.:
+//   c++ -std=c++17 -O2 -I. rbase/test/bench/rbase_bench_string.cpp -o bench_string
+
+#ifndef RBASE_NAMESPACE
+#define RBASE_NAMESPACE rbase
+#endif
+
+#include <rbase/inc/platform.h>
+#define RTM_LIBHANDLER_DEFINE
+#include <rbase/inc/libhandler.h>
+#include <rbase/inc/stringfn.h>
+#include <rbase/inc/cpu.h>
+
+#include <stdio.h>
+#include <string.h>
+
+using namespace rtm;
+
+namespace {
+
+	enum
+	{
+		BUFFER_SIZE	= 64 * 1024,
+		TOTAL_BYTES	= 256 * 1024 * 1024		// bytes scanned per measurement
+	};
+
+	char			g_buffer[BUFFER_SIZE + 64];
+	uintptr_t		g_sink;
+
+	static void report(const char* _name, uint32_t _size, uint64_t _startClock, uint32_t _iterations)
+	{
+		const double seconds = double(cpuTime(_startClock));
+		printf("%-22s %6u bytes  %8.2f ns/call  %7.2f GB/s\n", _name, _size,
+			seconds * 1e9 / _iterations, double(_size) * _iterations / seconds / 1e9);
+	}
+
+	static void benchSize(uint32_t _size)
+	{
+		// haystack of 'a', needle and searched characters only at the very end
+		memset(g_buffer, 'a', _size);
+		g_buffer[_size - 2]	= 'x';
+		g_buffer[_size - 1]	= 'y';
+		g_buffer[_size]		= 0;
+
+		const uint32_t iterations = TOTAL_BYTES / _size;
+		uint64_t clock;
+
+		clock = cpuClock();
+		for (uint32_t i=0; i<iterations; ++i)
+			g_sink += strlen(g_buffer + (i & 1));
+		report("strlen", _size, clock, iterations);
+
+		clock = cpuClock();
+		for (uint32_t i=0; i<iterations; ++i)
+			g_sink += strLen(g_buffer + (i & 1));
+		report("rtm::strLen", _size, clock, iterations);
+
+		clock = cpuClock();
+		for (uint32_t i=0; i<iterations; ++i)
+			g_sink += (uintptr_t)memchr(g_buffer + (i & 1), 'y', _size - 1);
+		report("memchr", _size, clock, iterations);
+
+		clock = cpuClock();
+		for (uint32_t i=0; i<iterations; ++i)
+			g_sink += (uintptr_t)strChr(g_buffer + (i & 1), 'y', _size - 1);
+		report("rtm::strChr", _size, clock, iterations);
+
+		clock = cpuClock();
+		for (uint32_t i=0; i<iterations; ++i)
+			g_sink += (uintptr_t)strstr(g_buffer + (i & 1), "axy");
+		report("strstr", _size, clock, iterations);
+
+		clock = cpuClock();
+		for (uint32_t i=0; i<iterations; ++i)
+			g_sink += (uintptr_t)strStr(g_buffer + (i & 1), "axy");
+		report("rtm::strStr", _size, clock, iterations);
+
+		clock = cpuClock();
+		for (uint32_t i=0; i<iterations; ++i)
+			g_sink += (uintptr_t)striStr(g_buffer + (i & 1), "AXY");
+		report("rtm::striStr", _size, clock, iterations);
+
+		printf("\n");
+	}
+
+} // namespace
+
+int main(int /*argc*/, char* /*argv*/[])
+{
+	const uint32_t sizes[] = { 16, 64, 256, 4096, BUFFER_SIZE };
+	for (uint32_t i=0; i<RTM_NUM_ELEMENTS(sizes); ++i)
+		benchSize(sizes[i]);
+
+	return g_sink == 0 ? 1 : 0;
+}
@@ -0,0 +1,276 @@
+//--------------------------------------------------------------------------//
+/// Copyright 2025 Milos Tosic. All Rights Reserved.                       ///
+/// License: http://www.opensource.org/licenses/BSD-2-Clause               ///
+//--------------------------------------------------------------------------//
+
+#include <rbase_test_pch.h>
+#include <rbase/inc/chunkallocator.h>
+#include <rbase/inc/thread.h>
+
+using namespace rtm;
+
+namespace {
+
+	enum
+	{
+		ALLOC_TEST_THREADS	= 4,
+		ALLOC_TEST_ITEMS	= 5000
+	};
+
+	typedef ChunkAllocatorConcurrent<uint32_t, 256> TestAllocator;
+
+	struct AllocWorker
+	{
+		TestAllocator*	m_allocator;
+		uint32_t		m_index;
+		uint32_t		m_handles[ALLOC_TEST_ITEMS];
+	};
+
+	// allocates, frees half and allocates again, stamping every item with the thread index
+	static int32_t allocWorker(void* _userData)
+	{
+		AllocWorker* worker = (AllocWorker*)_userData;
+		TestAllocator* allocator = worker->m_allocator;
+
+		for (uint32_t i=0; i<ALLOC_TEST_ITEMS; ++i)
+			worker->m_handles[i] = allocator->allocHandle();
+
+		for (uint32_t i=0; i<ALLOC_TEST_ITEMS; i+=2)
+			allocator->freeHandle(worker->m_handles[i]);
+
+		for (uint32_t i=0; i<ALLOC_TEST_ITEMS; i+=2)
+			worker->m_handles[i] = allocator->allocHandle();
+
+		for (uint32_t i=0; i<ALLOC_TEST_ITEMS; ++i)
+			*allocator->getItem(worker->m_handles[i]) = worker->m_index;
+
+		return 0;
+	}
+
+	struct FrameWorker
+	{
+		FrameAllocator*	m_allocator;
+		uint32_t		m_stamp;
+		bool			m_valid;
+	};
+
+	// fills frame allocations with a stamp and checks none of them overlap
+	static int32_t frameWorker(void* _userData)
+	{
+		FrameWorker* worker = (FrameWorker*)_userData;
+
+		uint32_t* items[ALLOC_TEST_ITEMS / 10];
+		for (uint32_t i=0; i<ALLOC_TEST_ITEMS / 10; ++i)
+		{
+			items[i] = (uint32_t*)worker->m_allocator->alloc(1024, 16);
+			worker->m_valid &= ((uintptr_t)items[i] & 15) == 0;
+			for (uint32_t j=0; j<256; ++j)
+				items[i][j] = worker->m_stamp;
+		}
+
+		for (uint32_t i=0; i<ALLOC_TEST_ITEMS / 10; ++i)
+			worker->m_valid &= (items[i][0] == worker->m_stamp) && (items[i][255] == worker->m_stamp);
+
+		return 0;
+	}
+
+} // namespace
+
+SUITE(rbase)
+{
+	TEST(chunkallocator_virtual)
+	{
+		// small chunks so items span several of them
+		ChunkAllocator<uint32_t, 1024> chunks(100000, true);
+
+		for (uint32_t i=0; i<10000; ++i)
+			*chunks.alloc() = i;
+
+		bool valid = true;
+		for (uint32_t i=0; i<10000; ++i)
+			valid &= *chunks.getItem(i) == i;
+		CHECK(valid);
+		CHECK(chunks.getItem(5000) == chunks.getItem(0) + 5000);
+
+		chunks.reset();
+		CHECK_EQUAL(0u, chunks.size());
+		CHECK_EQUAL(0u, *chunks.getItem(chunks.allocHandle()));
+
+		StackAllocator stack(uint64_t(64) * 1024 * 1024);
+
+		// larger than a chunk, reserved range is contiguous
+		uint8_t* large = (uint8_t*)stack.alloc(3 * 1024 * 1024);
+		CHECK(large != 0);
+		memSet(large, 0xab, 3 * 1024 * 1024);
+
+		uint8_t* aligned = (uint8_t*)stack.alloc(10, 64);
+		CHECK(((uintptr_t)aligned & 63) == 0);
+		CHECK(aligned >= large + 3 * 1024 * 1024);
+
+		stack.reset();
+		CHECK(stack.alloc(16) == large);
+	}
+
+	TEST(stackallocator_markers)
+	{
+		StackAllocator stack;
+		const uint64_t initialSize = stack.totalMemorySize();
+
+		void* first = stack.alloc(100);
+		{
+			StackAllocatorScope scope(stack);
+			for (uint32_t i=0; i<10; ++i)
+				stack.alloc(512 * 1024);
+		}
+		CHECK(stack.totalMemorySize() > initialSize);
+
+		// chunks were kept, rewinding reuses the same memory
+		const uint64_t grownSize = stack.totalMemorySize();
+		StackAllocator::Marker marker = stack.getMarker();
+		void* second = stack.alloc(16);
+		CHECK(second > first);
+		stack.freeToMarker(marker);
+		CHECK(stack.alloc(16) == second);
+		for (uint32_t i=0; i<10; ++i)
+			stack.alloc(512 * 1024);
+		CHECK_EQUAL(grownSize, stack.totalMemorySize());
+
+		// oversized allocations get their own block and are freed with the scope
+		{
+			StackAllocatorScope scope(stack);
+			uint8_t* large = (uint8_t*)stack.alloc(3 * 1024 * 1024, 64);
+			CHECK(((uintptr_t)large & 63) == 0);
+			memSet(large, 0xcd, 3 * 1024 * 1024);
+			CHECK(stack.totalMemorySize() > grownSize + 3 * 1024 * 1024);
+		}
+		CHECK_EQUAL(grownSize, stack.totalMemorySize());
+
+		// fits a chunk only without alignment padding
+		{
+			StackAllocatorScope scope(stack);
+			uint8_t* nearlyChunk = (uint8_t*)stack.alloc(1024 * 1024 - 8, 64);
+			CHECK(((uintptr_t)nearlyChunk & 63) == 0);
+			memSet(nearlyChunk, 0xef, 1024 * 1024 - 8);
+		}
+		CHECK_EQUAL(grownSize, stack.totalMemorySize());
+
+		stack.reset();
+		CHECK_EQUAL(grownSize, stack.totalMemorySize());
+		CHECK(stack.alloc(100) == first);
+
+		// high water mark of the last frame was a single chunk
+		stack.reset(true, true);
+		CHECK_EQUAL(initialSize, stack.totalMemorySize());
+		CHECK(stack.alloc(100) == first);
+	}
+
+	TEST(frameallocator)
+	{
+		FrameAllocator frames(2);
+		CHECK_EQUAL(0u, frames.getFrame());
+
+		uint32_t* first = (uint32_t*)frames.alloc(sizeof(uint32_t));
+		*first = 0x1234;
+		CHECK_EQUAL(1u, frames.getNumChunks());
+
+		// memory of a frame stays valid through the next one
+		frames.nextFrame();
+		uint32_t* second = (uint32_t*)frames.alloc(sizeof(uint32_t));
+		CHECK(second != first);
+		CHECK_EQUAL(0x1234u, *first);
+		CHECK_EQUAL(2u, frames.getNumChunks());
+		CHECK_EQUAL(0u, frames.getNumFreeChunks());
+
+		// and is reused two frames later
+		frames.nextFrame();
+		CHECK_EQUAL(1u, frames.getNumFreeChunks());
+		CHECK(frames.alloc(sizeof(uint32_t)) == first);
+		CHECK_EQUAL(2u, frames.getNumChunks());
+
+		const uint64_t steadySize = frames.totalMemorySize();
+		uint8_t* large = (uint8_t*)frames.alloc(3 * 1024 * 1024, 64);
+		CHECK(((uintptr_t)large & 63) == 0);
+		memSet(large, 0xef, 3 * 1024 * 1024);
+		CHECK(frames.totalMemorySize() > steadySize + 3 * 1024 * 1024);
+		frames.nextFrame();
+		frames.nextFrame();
+		CHECK_EQUAL(steadySize, frames.totalMemorySize());
+
+		// workers bump from their own chunks, chunk count settles once frames recycle
+		Thread threads[ALLOC_TEST_THREADS];
+		FrameWorker workers[ALLOC_TEST_THREADS];
+		uint32_t numChunks = 0;
+		bool valid = true;
+		for (uint32_t frame=0; frame<8; ++frame)
+		{
+			for (uint32_t i=0; i<ALLOC_TEST_THREADS; ++i)
+			{
+				workers[i].m_allocator	= &frames;
+				workers[i].m_stamp		= frame * ALLOC_TEST_THREADS + i;
+				workers[i].m_valid		= true;
+				threads[i].start(frameWorker, &workers[i]);
+			}
+
+			for (uint32_t i=0; i<ALLOC_TEST_THREADS; ++i)
+			{
+				threads[i].stop();
+				valid &= workers[i].m_valid;
+			}
+
+			if (frame == 3)
+				numChunks = frames.getNumChunks();
+			frames.nextFrame();
+		}
+		CHECK(valid);
+		CHECK_EQUAL(numChunks, frames.getNumChunks());
+
+		frames.trim();
+		CHECK_EQUAL(0u, frames.getNumFreeChunks());
+	}
+
+	TEST(chunkallocator_concurrent)
+	{
+		TestAllocator allocator(ALLOC_TEST_THREADS * ALLOC_TEST_ITEMS * 2);
+
+		uint32_t* item;
+		const uint32_t first = allocator.allocHandle(&item);
+		CHECK(item == allocator.getItem(first));
+
+		// freed handles are reused, most recently freed first
+		allocator.freeHandle(first);
+		CHECK_EQUAL(first, allocator.allocHandle());
+
+		uint32_t handles[1000];
+		for (uint32_t i=0; i<1000; ++i)
+			handles[i] = allocator.allocHandle();
+		const uint32_t claimed = allocator.size();
+
+		for (uint32_t i=0; i<1000; ++i)
+			allocator.freeHandle(handles[i]);
+		for (uint32_t i=0; i<1000; ++i)
+			handles[i] = allocator.allocHandle();
+		CHECK_EQUAL(claimed, allocator.size());
+
+		Thread threads[ALLOC_TEST_THREADS];
+		AllocWorker* workers = rtm_new_array<AllocWorker>(ALLOC_TEST_THREADS);
+		for (uint32_t i=0; i<ALLOC_TEST_THREADS; ++i)
+		{
+			workers[i].m_allocator	= &allocator;
+			workers[i].m_index		= i;
+			threads[i].start(allocWorker, &workers[i]);
+		}
+
+		for (uint32_t i=0; i<ALLOC_TEST_THREADS; ++i)
+			threads[i].stop();
+
+		// no handle was given to two threads at once
+		bool valid = true;
+		for (uint32_t i=0; i<ALLOC_TEST_THREADS; ++i)
+			for (uint32_t j=0; j<ALLOC_TEST_ITEMS; ++j)
+				valid &= *allocator.getItem(workers[i].m_handles[j]) == i;
+		CHECK(valid);
+		CHECK(allocator.size() <= ALLOC_TEST_THREADS * ALLOC_TEST_ITEMS * 2);
+
+		rtm_delete_array<AllocWorker>(ALLOC_TEST_THREADS, workers);
+	}
+}
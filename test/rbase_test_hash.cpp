@@ -0,0 +1,218 @@
+//--------------------------------------------------------------------------//
+/// Copyright 2025 Milos Tosic. All Rights Reserved.                       ///
+/// License: http://www.opensource.org/licenses/BSD-2-Clause               ///
+//--------------------------------------------------------------------------//
+
+#include <rbase_test_pch.h>
+#include <rbase/inc/hash.h>
+#include <rbase/inc/file.h>
+#include <rbase/inc/stringfn.h>
+
+using namespace rtm;
+
+SUITE(rbase)
+{
+	TEST(hash_incremental)
+	{
+		uint8_t data[700];
+		for (uint32_t i=0; i<sizeof(data); ++i)
+			data[i] = (uint8_t)(i * 7 + (i >> 3));
+
+		const uint32_t pieces[] = { 1, 3, 13, 64, 100 };
+
+		for (uint32_t len=0; len<=sizeof(data); len += (len < 140 ? 1 : 37))
+		{
+			uint8_t digest[16];
+			hashMD5(data, len, digest);
+
+			for (uint32_t p=0; p<RTM_NUM_ELEMENTS(pieces); ++p)
+			{
+				HasherMurmur3	murmur3;
+				HasherCity64	city64;
+				HasherMD5		md5;
+
+				murmur3.init(len);
+				city64.init(len, data + (len < 64 ? 0 : len - 64));
+				md5.init();
+
+				for (uint32_t pos=0; pos<len; pos += pieces[p])
+				{
+					const uint32_t size = len - pos < pieces[p] ? len - pos : pieces[p];
+					murmur3.update(data + pos, size);
+					city64.update(data + pos, size);
+					md5.update(data + pos, size);
+				}
+
+				CHECK(hashMurmur3(data, len, len) == murmur3.finalize());
+
+				if (p & 1)
+					CHECK(hashCity64(data, len, 0x1234) == city64.finalize(0x1234));
+				else
+					CHECK(hashCity64(data, len) == city64.finalize());
+
+				uint8_t streamed[16];
+				md5.finalize(streamed);
+				CHECK(0 == memCompare(digest, streamed, 16));
+			}
+		}
+	}
+
+	TEST(hash_fast)
+	{
+		// reference values, must not change between SIMD and scalar code paths
+		struct Vector
+		{
+			uint32_t	m_len;
+			uint64_t	m_hash64;
+			uint64_t	m_hash64seed;
+			uint64_t	m_hash128seed[2];
+		};
+
+		const Vector vectors[] =
+		{
+			{    0, 0x5bd21e487ead4419ULL, 0xe75faa1988f254caULL, { 0xd65f757b9632f877ULL, 0x15462ee5810e25a3ULL } },
+			{    3, 0x7e3ccc24f99f36b9ULL, 0xd0179d5f5edbe9cbULL, { 0x80e93b0f53c38373ULL, 0x7b3e79613e1c7d0fULL } },
+			{    8, 0x892621f41b3881e4ULL, 0x3e366c465bddcde8ULL, { 0x303e35d0c0928619ULL, 0xfa5c66cf7aa35b89ULL } },
+			{   16, 0x5bffc3fbd46fdf5dULL, 0x423f56f55e9a23ceULL, { 0x68ab2397c7247c1dULL, 0xa23099fb6f18e525ULL } },
+			{  100, 0xdc625a8702071c56ULL, 0x1efa56be346d8795ULL, { 0x71a29fada43fcb79ULL, 0x330986770cee41edULL } },
+			{  240, 0x71f9ac85cd7d1f39ULL, 0x86a9543d69f7bf41ULL, { 0x86a9543d69f7bf41ULL, 0xacb60cf81a7eb0e7ULL } },
+			{ 2000, 0x5a8fefe3e5b29da9ULL, 0x9f4641611b1737e9ULL, { 0x9f4641611b1737e9ULL, 0x12049cc6b72678d1ULL } }
+		};
+
+		uint8_t data[2000];
+		for (uint32_t i=0; i<sizeof(data); ++i)
+			data[i] = (uint8_t)(i * 7 + 3);
+
+		for (uint32_t i=0; i<RTM_NUM_ELEMENTS(vectors); ++i)
+		{
+			const Vector& v = vectors[i];
+
+			uint64_t hash128[2];
+			hashFast128(data, v.m_len, hash128, 42);
+
+			CHECK(v.m_hash64 == hashFast64(data, v.m_len));
+			CHECK(v.m_hash64seed == hashFast64(data, v.m_len, 42));
+			CHECK(v.m_hash128seed[0] == hash128[0]);
+			CHECK(v.m_hash128seed[1] == hash128[1]);
+		}
+
+		// last byte of a long input must affect the hash
+		const uint64_t hash = hashFast64(data, sizeof(data));
+		data[sizeof(data) - 1] ^= 1;
+		CHECK(hash != hashFast64(data, sizeof(data)));
+	}
+
+	TEST(hash_batch)
+	{
+		char strings[37][40];
+		const void* keys[37];
+		const char* strs[37];
+		uint32_t lens[37];
+
+		for (uint32_t i=0; i<37; ++i)
+		{
+			lens[i] = (i * 5) % 39;
+			for (uint32_t c=0; c<lens[i]; ++c)
+				strings[i][c] = (char)('a' + (i + c * 3) % 26);
+			strings[i][lens[i]] = '\0';
+
+			keys[i] = strings[i];
+			strs[i] = strings[i];
+		}
+
+		uint32_t hashes[37];
+
+		hashMurmur3Batch(keys, lens, 37, hashes, 17);
+		for (uint32_t i=0; i<37; ++i)
+			CHECK(hashMurmur3(keys[i], lens[i], 17) == hashes[i]);
+
+		hashStrBatch(strs, 37, hashes);
+		for (uint32_t i=0; i<37; ++i)
+			CHECK(hashStr(strs[i]) == hashes[i]);
+
+		hashStrBatch(strs, 37, hashes, 10);
+		for (uint32_t i=0; i<37; ++i)
+			CHECK(hashStr(strs[i], 10) == hashes[i]);
+	}
+
+	TEST(hash_md5_batch)
+	{
+		uint8_t data[300];
+		for (uint32_t i=0; i<sizeof(data); ++i)
+			data[i] = (uint8_t)(i * 11 + 1);
+
+		// sizes around padding boundaries, count not a multiple of lane count
+		const uint32_t sizes[] = { 0, 1, 55, 56, 63, 64, 65, 119, 120, 128, 200, 300, 3 };
+		const void* buffers[RTM_NUM_ELEMENTS(sizes)];
+		for (uint32_t i=0; i<RTM_NUM_ELEMENTS(sizes); ++i)
+			buffers[i] = data + (i & 3);
+
+		uint32_t clamped[RTM_NUM_ELEMENTS(sizes)];
+		for (uint32_t i=0; i<RTM_NUM_ELEMENTS(sizes); ++i)
+			clamped[i] = sizes[i] + (i & 3) > sizeof(data) ? sizes[i] - (i & 3) : sizes[i];
+
+		uint8_t digests[RTM_NUM_ELEMENTS(sizes)][16];
+		hashMD5Batch(buffers, clamped, RTM_NUM_ELEMENTS(sizes), digests);
+
+		for (uint32_t i=0; i<RTM_NUM_ELEMENTS(sizes); ++i)
+		{
+			uint8_t digest[16];
+			hashMD5(buffers[i], clamped[i], digest);
+			CHECK(0 == memCompare(digest, digests[i], 16));
+		}
+
+		char hash[33];
+		hashMD5("", 0, digests[0]);
+		hashMD5toString(digests[0], hash);
+		CHECK(0 == strCmp(hash, "D41D8CD98F00B204E9800998ECF8427E"));
+	}
+
+	TEST(hash_fnv)
+	{
+		switch (hashFNV1_64("texture"))
+		{
+		case RTM_COMPILE_TIME_STRING_HASH64("mesh"):	CHECK(false); break;
+		case RTM_COMPILE_TIME_STRING_HASH64("texture"):	CHECK(true);  break;
+		default:										CHECK(false); break;
+		};
+
+		#define FNV_TEST_STRING "The quick brown fox jumps over the lazy dog \xe2\x9c\x93"
+
+		constexpr uint32_t hash32 = RTM_COMPILE_TIME_STRING_HASH(FNV_TEST_STRING);
+		constexpr uint64_t hash64 = RTM_COMPILE_TIME_STRING_HASH64(FNV_TEST_STRING);
+
+		const char* str = FNV_TEST_STRING;
+		CHECK(hash32 == hashFNV1(str));
+		CHECK(hash64 == hashFNV1_64(str));
+		CHECK(hashFNV1a_64(str) == hashFNV1a_64(str, strLen(str)));
+		CHECK(0xAF63DC4C8601EC8CULL == hashFNV1a_64("a"));
+	}
+
+	TEST(hash_file)
+	{
+		uint8_t data[1000];
+		for (uint32_t i=0; i<sizeof(data); ++i)
+			data[i] = (uint8_t)(i * 13 + 5);
+
+		const char* path = "rbase_test_hash.bin";
+		CHECK(sizeof(data) == fileWrite(FileStorage::Local, path, data, sizeof(data)));
+
+		uint32_t murmur3 = 0;
+		uint64_t city64 = 0;
+		uint8_t md5[16], digest[16];
+
+		CHECK(sizeof(data) == fileHash(FileStorage::Local, path, HashAlgorithm::Murmur3, &murmur3));
+		CHECK(sizeof(data) == fileHash(FileStorage::Local, path, HashAlgorithm::City64, &city64));
+		CHECK(sizeof(data) == fileHash(FileStorage::Local, path, HashAlgorithm::MD5, md5));
+
+		hashMD5(data, sizeof(data), digest);
+
+		CHECK(hashMurmur3(data, sizeof(data)) == murmur3);
+		CHECK(hashCity64(data, sizeof(data)) == city64);
+		CHECK(0 == memCompare(digest, md5, 16));
+
+		CHECK(-1 == fileHash(FileStorage::Local, "rbase_test_hash_missing.bin", HashAlgorithm::MD5, md5));
+
+		remove(path);
+	}
+}
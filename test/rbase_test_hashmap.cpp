@@ -0,0 +1,102 @@
+//--------------------------------------------------------------------------//
+/// Copyright 2025 Milos Tosic. All Rights Reserved.                       ///
+/// License: http://www.opensource.org/licenses/BSD-2-Clause               ///
+//--------------------------------------------------------------------------//
+
+#include <rbase_test_pch.h>
+#include <rbase/inc/hashmap.h>
+
+using namespace rtm;
+
+SUITE(rbase)
+{
+	TEST(hashmap)
+	{
+		HashMap<uint32_t, uint32_t> map;
+		CHECK(map.isEmpty());
+		CHECK(0 == map.find(5));
+
+		for (uint32_t i=0; i<1000; ++i)
+			CHECK(0 != map.insert(i * 7, i));
+
+		CHECK(1000 == map.size());
+		for (uint32_t i=0; i<1000; ++i)
+		{
+			CHECK(map.find(i * 7) && (i == *map.find(i * 7)));
+			CHECK(!map.contains(i * 7 + 1));
+		}
+
+		// replace existing value
+		CHECK(77 == *map.insert(7, 77));
+		CHECK(1000 == map.size());
+
+		// erase and reinsert churn, deleted markers must be reclaimed without growing
+		const uint32_t capacity = map.capacity();
+		for (uint32_t round=0; round<20; ++round)
+		{
+			for (uint32_t i=0; i<1000; i+=2)
+				CHECK(map.erase(i * 7));
+			CHECK(!map.erase(0));
+			for (uint32_t i=0; i<1000; i+=2)
+				map.insert(i * 7, i + round);
+		}
+		CHECK(capacity == map.capacity());
+		CHECK(1000 == map.size());
+		CHECK(19 == *map.find(0));
+
+		uint32_t sum = 0;
+		map.forEach([&sum](HashMap<uint32_t, uint32_t>::Entry& _entry) { sum += _entry.m_key; });
+		CHECK(7 * 999 * 1000 / 2 == sum);
+
+		map.clear();
+		CHECK(map.isEmpty());
+		CHECK(0 == map.find(7));
+
+		HashMap<const char*, uint32_t, HashMapHasherStr> strMap;
+		strMap.reserve(3);
+		strMap.insert("one", 1);
+		strMap.insert("two", 2);
+		char key[] = "two";
+		CHECK(strMap.find(key) && (2 == *strMap.find(key)));
+		CHECK(0 == strMap.find("three"));
+	}
+
+	TEST(hashmap_fixed)
+	{
+		FixedHashMap<uint64_t, uint32_t, 64, HashMapHasherMurmur3<uint64_t> > map;
+		CHECK(64 == map.capacity());
+
+		uint32_t inserted = 0;
+		while (map.insert(inserted * 1000003ULL, inserted))
+			++inserted;
+		CHECK(56 == inserted);
+
+		// full map must still recycle deleted markers
+		for (uint32_t round=0; round<100; ++round)
+		{
+			const uint64_t key = (round % inserted) * 1000003ULL;
+			CHECK(map.erase(key));
+			CHECK(0 != map.insert(key + 1, round));
+			CHECK(0 == map.insert(key + 2, round));
+			CHECK(0 != map.insert(key + 1, round));
+			CHECK(map.erase(key + 1));
+			CHECK(0 != map.insert(key, round));
+		}
+		for (uint32_t i=0; i<inserted; ++i)
+			CHECK(map.contains(i * 1000003ULL));
+
+		HashSet<uint32_t> set;
+		FixedHashSet<uint32_t, 32> fixedSet;
+		for (uint32_t i=0; i<20; ++i)
+		{
+			CHECK(set.insert(i));
+			CHECK(fixedSet.insert(i));
+		}
+		CHECK(!set.insert(3));
+		CHECK(!fixedSet.insert(3));
+		CHECK(set.erase(3) && !set.contains(3));
+		CHECK(fixedSet.erase(3) && !fixedSet.contains(3));
+		CHECK(19 == set.size());
+		CHECK(19 == fixedSet.size());
+	}
+}
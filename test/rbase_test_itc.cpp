@@ -0,0 +1,205 @@
+//--------------------------------------------------------------------------//
+/// Copyright 2025 Milos Tosic. All Rights Reserved.                       ///
+/// License: http://www.opensource.org/licenses/BSD-2-Clause               ///
+//--------------------------------------------------------------------------//
+
+#include <rbase_test_pch.h>
+#include <rbase/inc/itc.h>
+
+using namespace rtm;
+
+namespace {
+
+	enum { ITC_TEST_COMMANDS = 10000 };
+
+	struct TestCommand
+	{
+		uint32_t	m_producer;
+		uint32_t	m_index;
+		uint32_t	m_check;
+	};
+
+	struct ItcProducer
+	{
+		RWBuffer*	m_buffer;
+		uint32_t	m_producer;
+	};
+
+	static int32_t itcProducer(void* _userData)
+	{
+		ItcProducer* producer = (ItcProducer*)_userData;
+		for (uint32_t i=0; i<ITC_TEST_COMMANDS; ++i)
+		{
+			TestCommand cmd = { producer->m_producer, i, producer->m_producer ^ i };
+			memCopy(producer->m_buffer->reserve(sizeof(cmd)), sizeof(cmd), &cmd, sizeof(cmd));
+		}
+		return 0;
+	}
+
+	static uint64_t s_consumedSum;
+	static uint32_t s_consumedFrames;
+
+	static int32_t itcConsumer(void* _userData)
+	{
+		CommandBuffer* cb = (CommandBuffer*)_userData;
+		while (cb->dataAvailable())
+		{
+			uint32_t value;
+			cb->read(value);
+			s_consumedSum += value;
+		}
+
+		// slow consumer, producer gets ahead
+		if ((s_consumedFrames++ % 8) == 0)
+			threadSleep(1);
+		return 0;
+	}
+
+} // namespace
+
+SUITE(rbase)
+{
+	TEST(itc)
+	{
+		// writes larger than capacity chain new blocks, reads cross block boundaries
+		RWBuffer buffer;
+		buffer.setCapacity(10);
+
+		for (uint32_t round=0; round<2; ++round)
+		{
+			buffer.start();
+			for (uint32_t i=0; i<100; ++i)
+				buffer.write(i);
+			buffer.write("0123456789abcdefghij", 20);
+			buffer.finish();
+
+			bool valid = true;
+			for (uint32_t i=0; i<100; ++i)
+			{
+				uint32_t value;
+				buffer.read(value);
+				valid &= value == i;
+			}
+			CHECK(valid);
+
+			char str[20];
+			buffer.read(str, 20);
+			CHECK(0 == memCompare(str, "0123456789abcdefghij", 20));
+			CHECK(!buffer.dataAvailable());
+		}
+
+		// concurrent producers
+		buffer.setCapacity(1024);
+		buffer.start();
+
+		Thread threads[3];
+		ItcProducer producers[3];
+		for (uint32_t i=0; i<3; ++i)
+		{
+			producers[i].m_buffer	= &buffer;
+			producers[i].m_producer	= i;
+			threads[i].start(itcProducer, &producers[i]);
+		}
+
+		for (uint32_t i=0; i<3; ++i)
+			threads[i].stop();
+
+		buffer.finish();
+
+		// commands of each producer are in order and never split between blocks
+		uint32_t next[3] = { 0, 0, 0 };
+		bool valid = true;
+		while (buffer.dataAvailable())
+		{
+			const TestCommand* cmd = (const TestCommand*)buffer.skip(sizeof(TestCommand));
+			valid &= (cmd->m_producer < 3) && (cmd->m_index == next[cmd->m_producer]++) && (cmd->m_check == (cmd->m_producer ^ cmd->m_index));
+		}
+		CHECK(valid);
+		CHECK_EQUAL((uint32_t)ITC_TEST_COMMANDS, next[0]);
+		CHECK_EQUAL((uint32_t)ITC_TEST_COMMANDS, next[1]);
+		CHECK_EQUAL((uint32_t)ITC_TEST_COMMANDS, next[2]);
+	}
+
+	TEST(itc_pool)
+	{
+		RWBufferPool pool(64);
+		{
+			RWBuffer buffer;
+			buffer.setPool(&pool);
+			CHECK_EQUAL(1u, pool.getNumPages());
+
+			uint32_t firstRoundPages = 0;
+			for (uint32_t round=0; round<3; ++round)
+			{
+				// spike of 4000 bytes, values straddle pages
+				buffer.start();
+				for (uint32_t i=0; i<1000; ++i)
+					buffer.write(i * 3);
+
+				// larger than a page, gets its own block
+				uint8_t* big = buffer.reserve(100);
+				memSet(big, 0xab, 100);
+				buffer.finish();
+
+				const uint32_t numPages = pool.getNumPages();
+				CHECK(numPages >= 4000 / 64);
+
+				bool valid = true;
+				for (uint32_t i=0; i<1000; ++i)
+				{
+					uint32_t value;
+					buffer.read(value);
+					valid &= value == i * 3;
+				}
+				CHECK(valid);
+
+				// consumed pages were returned to the pool
+				CHECK(pool.getNumFreePages() >= numPages - 2);
+
+				const uint8_t* data = buffer.skip(100);
+				CHECK((data[0] == 0xab) && (data[99] == 0xab));
+				CHECK(!buffer.dataAvailable());
+
+				// steady state reuses pages
+				if (round == 0)
+					firstRoundPages = numPages;
+				CHECK_EQUAL(firstRoundPages, numPages);
+			}
+		}
+
+		CHECK_EQUAL(pool.getNumPages(), pool.getNumFreePages());
+		pool.trim(2);
+		CHECK_EQUAL(2u, pool.getNumPages());
+	}
+
+	TEST(itc_commandbuffer)
+	{
+		RWBufferPool pool(256);
+		for (uint32_t numBuffers=2; numBuffers<=4; ++numBuffers)
+		{
+			CommandBuffer cb(&pool, numBuffers);
+			s_consumedSum		= 0;
+			s_consumedFrames	= 0;
+
+			uint64_t sum = 0;
+			cb.init(itcConsumer);
+			for (uint32_t frame=0; frame<50; ++frame)
+			{
+				for (uint32_t i=0; i<frame * 10; ++i)
+				{
+					cb.write(i + frame);
+					sum += i + frame;
+				}
+				cb.frame();
+				CHECK(cb.getQueueDepth() < numBuffers);
+			}
+			cb.shutDown();
+
+			CHECK_EQUAL(sum, s_consumedSum);
+			CHECK_EQUAL(51u, s_consumedFrames);
+			CHECK_EQUAL(0u, cb.getQueueDepth());
+			CHECK(cb.getMaxQueueDepth() <= numBuffers);
+			CHECK(cb.getStallTime() >= 0.0f);
+		}
+	}
+}
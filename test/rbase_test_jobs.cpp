@@ -0,0 +1,110 @@
+//--------------------------------------------------------------------------//
+/// Copyright 2025 Milos Tosic. All Rights Reserved.                       ///
+/// License: http://www.opensource.org/licenses/BSD-2-Clause               ///
+//--------------------------------------------------------------------------//
+
+#include <rbase_test_pch.h>
+#include <rbase/inc/jobs.h>
+
+using namespace rtm;
+
+namespace {
+
+	struct FibJob
+	{
+		JobSystem*	m_jobs;
+		uint32_t	m_n;
+		uint64_t	m_result;
+	};
+
+	// fork/join, every call spawns one job and computes the other branch itself
+	static void fibJob(void* _userData)
+	{
+		FibJob* fib = (FibJob*)_userData;
+		if (fib->m_n < 2)
+		{
+			fib->m_result = fib->m_n;
+			return;
+		}
+
+		FibJob lhs = { fib->m_jobs, fib->m_n - 1, 0 };
+		FibJob rhs = { fib->m_jobs, fib->m_n - 2, 0 };
+
+		JobCounter counter;
+		fib->m_jobs->run(fibJob, &lhs, &counter);
+		fibJob(&rhs);
+		fib->m_jobs->wait(&counter);
+
+		fib->m_result = lhs.m_result + rhs.m_result;
+	}
+
+	struct SumRange
+	{
+		const uint32_t*			m_data;
+		std::atomic<uint64_t>	m_sum;
+
+		void operator()(uint32_t _begin, uint32_t _end)
+		{
+			uint64_t sum = 0;
+			for (uint32_t i=_begin; i<_end; ++i)
+				sum += m_data[i];
+			m_sum.fetch_add(sum);
+		}
+	};
+
+} // namespace
+
+SUITE(rbase)
+{
+	TEST(jobs)
+	{
+		JobSystem jobs;
+		CHECK(jobs.init(4, false));
+		CHECK(4 == jobs.getNumThreads());
+
+		FibJob fib = { &jobs, 20, 0 };
+		JobCounter counter;
+		jobs.run(fibJob, &fib, &counter);
+		jobs.wait(&counter);
+		CHECK(counter.isDone());
+		CHECK(6765 == fib.m_result);
+
+		const uint32_t size = 100000;
+		uint32_t* data = new uint32_t[size];
+		for (uint32_t i=0; i<size; ++i)
+			data[i] = i;
+
+		SumRange sum;
+		sum.m_data = data;
+		sum.m_sum.store(0);
+		jobs.parallelFor(0, size, sum);
+		CHECK(uint64_t(size) * (size - 1) / 2 == sum.m_sum.load());
+
+		sum.m_sum.store(0);
+		jobs.parallelFor(10, 20, sum, 3);
+		CHECK(145 == sum.m_sum.load());
+
+		// lambdas and temporaries are accepted as well
+		jobs.parallelFor(0, size, [data](uint32_t _rangeBegin, uint32_t _rangeEnd)
+		{
+			for (uint32_t i=_rangeBegin; i<_rangeEnd; ++i)
+				data[i] *= 2;
+		});
+
+		bool doubled = true;
+		for (uint32_t i=0; i<size; ++i)
+			doubled &= data[i] == i * 2;
+		CHECK(doubled);
+
+		std::atomic<uint32_t> numCalls(0);
+		const auto count = [&numCalls](uint32_t _rangeBegin, uint32_t _rangeEnd)
+		{
+			numCalls.fetch_add(_rangeEnd - _rangeBegin);
+		};
+		jobs.parallelFor(0, 1000, count, 7);
+		CHECK(1000 == numCalls.load());
+
+		delete[] data;
+		jobs.shutdown();
+	}
+}
@@ -0,0 +1,300 @@
+//--------------------------------------------------------------------------//
+/// Copyright 2025 Milos Tosic. All Rights Reserved.                       ///
+/// License: http://www.opensource.org/licenses/BSD-2-Clause               ///
+//--------------------------------------------------------------------------//
+
+#include <rbase_test_pch.h>
+#include <rbase/inc/queue.h>
+#include <rbase/inc/thread.h>
+
+using namespace rtm;
+
+namespace {
+
+	enum { QUEUE_TEST_ITEMS = 20000 };
+
+	static int32_t mpmcProducer(void* _userData)
+	{
+		MpMcQueue<uint32_t>* queue = (MpMcQueue<uint32_t>*)_userData;
+		uint32_t i = 1;
+		while (i <= QUEUE_TEST_ITEMS)
+		{
+			uint32_t items[7];
+			uint32_t count = 0;
+			while ((count < 7) && (i + count <= QUEUE_TEST_ITEMS))
+			{
+				items[count] = i + count;
+				++count;
+			}
+
+			// mix bulk and blocking single pushes
+			if ((i & 1) == 0)
+			{
+				const uint32_t pushed = queue->enqueueBulk(items, count);
+				i += pushed;
+				if (pushed)
+					continue;
+			}
+
+			queue->push(i++);
+		}
+		return 0;
+	}
+
+	static int32_t spscProducer(void* _userData)
+	{
+		SpScQueue<uint32_t>* queue = (SpScQueue<uint32_t>*)_userData;
+		for (uint32_t i=1; i<=QUEUE_TEST_ITEMS; ++i)
+			queue->push(i);
+		return 0;
+	}
+
+	struct QueueMessage : public MpScQueueNode
+	{
+		uint32_t	m_value;
+	};
+
+	struct UnboundedProducer
+	{
+		MpMcQueueUnbounded<uint32_t, 16>*	m_queue;
+		uint32_t							m_first;
+	};
+
+	static int32_t unboundedProducer(void* _userData)
+	{
+		UnboundedProducer* producer = (UnboundedProducer*)_userData;
+		for (uint32_t i=0; i<QUEUE_TEST_ITEMS; ++i)
+			producer->m_queue->enqueue(producer->m_first + i);
+		return 0;
+	}
+
+	// record i holds (i % 61) + 1 bytes of value i
+	static int32_t byteProducer(void* _userData)
+	{
+		SpScByteQueue* queue = (SpScByteQueue*)_userData;
+		for (uint32_t i=0; i<QUEUE_TEST_ITEMS; ++i)
+		{
+			const uint32_t size = (i % 61) + 1;
+			uint8_t* record;
+			while ((record = (uint8_t*)queue->reserve(size)) == 0)
+				threadYield();
+
+			memSet(record, uint8_t(i), size);
+			queue->commit();
+		}
+		return 0;
+	}
+
+} // namespace
+
+SUITE(rbase)
+{
+	TEST(queue)
+	{
+		MpMcQueue<uint32_t> mpmc(16);
+
+		uint32_t items[32];
+		for (uint32_t i=0; i<32; ++i)
+			items[i] = i;
+
+		CHECK_EQUAL(16u, mpmc.enqueueBulk(items, 32));
+		CHECK(!mpmc.enqueue(items[0]));
+		CHECK(!mpmc.push(items[0], 0));
+		CHECK(!mpmc.push(items[0], 10));
+
+		uint32_t out[32];
+		CHECK_EQUAL(5u, mpmc.dequeueBulk(out, 5));
+		CHECK_EQUAL(11u, mpmc.dequeueBulk(&out[5], 32));
+		for (uint32_t i=0; i<16; ++i)
+			CHECK_EQUAL(i, out[i]);
+
+		uint32_t item;
+		CHECK_EQUAL(0u, mpmc.dequeueBulk(out, 32));
+		CHECK(!mpmc.pop(item, 0));
+		CHECK(!mpmc.pop(item, 10));
+
+		// blocking handoff through a queue much smaller than the item count
+		Thread producer;
+		producer.start(mpmcProducer, &mpmc);
+
+		uint32_t expected = 1;
+		bool inOrder = true;
+		while (expected <= QUEUE_TEST_ITEMS)
+		{
+			const uint32_t count = mpmc.dequeueBulk(out, 3);
+			for (uint32_t i=0; i<count; ++i)
+				inOrder &= out[i] == expected++;
+
+			if (count == 0)
+			{
+				CHECK(mpmc.pop(item));
+				inOrder &= item == expected++;
+			}
+		}
+		producer.stop();
+		CHECK(inOrder);
+		CHECK(!mpmc.dequeue(item));
+
+		SpScQueue<uint32_t> spsc(7);
+		CHECK(!spsc.pop(&item, 0));
+		CHECK(!spsc.pop(&item, 10));
+
+		// batches wrapping around the ring
+		inOrder = true;
+		for (uint32_t round=0; round<10; ++round)
+		{
+			CHECK_EQUAL(5u, spsc.writeN(items, 5));
+			CHECK_EQUAL(2u, spsc.writeN(&items[5], 5));
+			CHECK(!spsc.write(items[0]));
+
+			CHECK(spsc.peek(&item));
+			CHECK_EQUAL(0u, item);
+			CHECK_EQUAL(3u, spsc.readN(out, 3));
+			CHECK_EQUAL(4u, spsc.readN(&out[3], 32));
+			CHECK_EQUAL(0u, spsc.readN(out, 32));
+			for (uint32_t i=0; i<7; ++i)
+				inOrder &= out[i] == i;
+		}
+		CHECK(inOrder);
+
+		producer.start(spscProducer, &spsc);
+		inOrder = true;
+		for (uint32_t i=1; i<=QUEUE_TEST_ITEMS; ++i)
+		{
+			CHECK(spsc.pop(&item));
+			inOrder &= item == i;
+		}
+		producer.stop();
+		CHECK(inOrder);
+	}
+
+	TEST(queue_unbounded)
+	{
+		MpScQueue<QueueMessage> mpsc;
+		CHECK(mpsc.isEmpty());
+		CHECK(mpsc.pop() == 0);
+
+		QueueMessage messages[100];
+		for (uint32_t i=0; i<100; ++i)
+		{
+			messages[i].m_value = i;
+			mpsc.push(&messages[i]);
+		}
+
+		bool inOrder = true;
+		for (uint32_t i=0; i<100; ++i)
+		{
+			QueueMessage* msg = mpsc.pop();
+			inOrder &= (msg != 0) && (msg->m_value == i);
+		}
+		CHECK(inOrder);
+		CHECK(mpsc.pop() == 0);
+		CHECK(mpsc.isEmpty());
+
+		// small segments so the test goes through linking and recycling many times
+		MpMcQueueUnbounded<uint32_t, 16> mpmc;
+		uint32_t item = 0;
+		CHECK(!mpmc.dequeue(item));
+
+		for (uint32_t i=0; i<1000; ++i)
+			mpmc.enqueue(i);
+
+		inOrder = true;
+		for (uint32_t i=0; i<1000; ++i)
+			inOrder &= mpmc.dequeue(item) && (item == i);
+		CHECK(inOrder);
+		CHECK(!mpmc.dequeue(item));
+
+		Thread threads[2];
+		UnboundedProducer producers[2] = {
+			{ &mpmc, 0 },
+			{ &mpmc, QUEUE_TEST_ITEMS }
+		};
+		threads[0].start(unboundedProducer, &producers[0]);
+		threads[1].start(unboundedProducer, &producers[1]);
+
+		// items of each producer arrive in order
+		uint32_t next[2] = { 0, QUEUE_TEST_ITEMS };
+		uint32_t received = 0;
+		while (received < QUEUE_TEST_ITEMS * 2)
+		{
+			if (!mpmc.dequeue(item))
+			{
+				threadYield();
+				continue;
+			}
+
+			const uint32_t producer = item < QUEUE_TEST_ITEMS ? 0 : 1;
+			inOrder &= item == next[producer]++;
+			++received;
+		}
+
+		threads[0].stop();
+		threads[1].stop();
+		CHECK(inOrder);
+		CHECK(!mpmc.dequeue(item));
+	}
+
+	TEST(queue_bytes)
+	{
+		SpScByteQueue queue(256);
+		uint32_t size;
+		CHECK(queue.peek(&size) == 0);
+		CHECK_EQUAL(120u, queue.maxRecordSize());
+
+		// fill up, then records that need to wrap around
+		CHECK(queue.write("0123456789", 10));
+		uint8_t* record = (uint8_t*)queue.reserve(100);
+		CHECK(record != 0);
+		CHECK(((uintptr_t)record & 7) == 0);
+		memSet(record, 'x', 100);
+		queue.commit();
+		CHECK(queue.reserve(120) == 0);
+
+		const char* str = (const char*)queue.peek(&size);
+		CHECK(str != 0);
+		CHECK_EQUAL(10u, size);
+		CHECK(0 == memCompare(str, "0123456789", 10));
+		queue.release();
+
+		record = (uint8_t*)queue.peek(&size);
+		CHECK_EQUAL(100u, size);
+		CHECK(record && (record[99] == 'x'));
+		queue.release();
+		CHECK(queue.peek(&size) == 0);
+
+		// reserve for worst case, commit what was written
+		bool valid = true;
+		for (uint32_t i=0; i<100; ++i)
+		{
+			const uint32_t recordSize = 20 + (i * 7) % 100;
+			record = (uint8_t*)queue.reserve(120);
+			valid &= record != 0;
+			if (!record)
+				break;
+			memSet(record, uint8_t(i), recordSize);
+			queue.commit(recordSize);
+
+			record = (uint8_t*)queue.peek(&size);
+			valid &= (record != 0) && (size == recordSize) && (record[0] == uint8_t(i)) && (record[size - 1] == uint8_t(i));
+			queue.release();
+		}
+		CHECK(valid);
+
+		Thread producer;
+		producer.start(byteProducer, &queue);
+
+		for (uint32_t i=0; i<QUEUE_TEST_ITEMS; ++i)
+		{
+			while ((record = (uint8_t*)queue.peek(&size)) == 0)
+				threadYield();
+
+			valid &= (size == (i % 61) + 1) && (record[0] == uint8_t(i)) && (record[size - 1] == uint8_t(i));
+			queue.release();
+		}
+
+		producer.stop();
+		CHECK(valid);
+		CHECK(queue.peek(&size) == 0);
+	}
+}
@@ -0,0 +1,346 @@
+//--------------------------------------------------------------------------//
+/// Copyright 2025 Milos Tosic. All Rights Reserved.                       ///
+/// License: http://www.opensource.org/licenses/BSD-2-Clause               ///
+//--------------------------------------------------------------------------//
+
+#include <rbase_test_pch.h>
+#include <rbase/inc/radixsort.h>
+#include <rbase/inc/jobs.h>
+#include <rbase/inc/random.h>
+#include <rbase/inc/stringview.h>
+
+using namespace rtm;
+
+namespace {
+
+	template <typename T>
+	static bool isSorted(const T* _keys, uint32_t _size)
+	{
+		for (uint32_t i=1; i<_size; ++i)
+			if (_keys[i] < _keys[i - 1])
+				return false;
+		return true;
+	}
+
+} // namespace
+
+SUITE(rbase)
+{
+	TEST(radixsort)
+	{
+		const uint32_t size = 5000;
+
+		Random random;
+
+		uint32_t* keys32	= new uint32_t[size];
+		uint32_t* temp32	= new uint32_t[size];
+		int32_t* ikeys32	= new int32_t[size];
+		int32_t* itemp32	= new int32_t[size];
+		float* fkeys		= new float[size];
+		float* ftemp		= new float[size];
+		int64_t* ikeys64	= new int64_t[size];
+		int64_t* itemp64	= new int64_t[size];
+		double* dkeys		= new double[size];
+		double* dtemp		= new double[size];
+		uint32_t* values	= new uint32_t[size];
+		uint32_t* tempValues= new uint32_t[size];
+
+		for (uint32_t i=0; i<size; ++i)
+		{
+			const uint32_t r = random.gen();
+			keys32[i]	= r;
+			ikeys32[i]	= int32_t(r);
+			fkeys[i]	= float(int32_t(r)) * 0.001f;
+			ikeys64[i]	= int64_t(int32_t(r)) * 1000003;
+			dkeys[i]	= double(int32_t(r)) * -0.25;
+		}
+		fkeys[0] = -0.0f;
+		fkeys[1] = 0.0f;
+
+		sortRadix(keys32, temp32, size);
+		sortRadix(ikeys32, itemp32, size);
+		sortRadix(fkeys, ftemp, size);
+		sortRadix64(ikeys64, itemp64, size);
+		sortRadix64(dkeys, dtemp, size);
+
+		CHECK(isSorted(keys32, size));
+		CHECK(isSorted(ikeys32, size));
+		CHECK(isSorted(fkeys, size));
+		CHECK(isSorted(ikeys64, size));
+		CHECK(isSorted(dkeys, size));
+
+		// small key range skips passes, values must follow keys and keep stable order
+		for (uint32_t i=0; i<size; ++i)
+		{
+			keys32[i]	= random.gen() & 0xff;
+			values[i]	= i;
+		}
+
+		sortRadix(keys32, temp32, values, tempValues, size);
+		CHECK(isSorted(keys32, size));
+		for (uint32_t i=1; i<size; ++i)
+			if (keys32[i] == keys32[i - 1])
+				CHECK(values[i] > values[i - 1]);
+
+		// keys differing only in the top digit
+		for (uint32_t i=0; i<size; ++i)
+		{
+			ikeys64[i]	= (i & 1) ? INT64_MIN : INT64_MAX;
+			values[i]	= i;
+		}
+		sortRadix64(ikeys64, itemp64, values, tempValues, size);
+		CHECK(INT64_MIN == ikeys64[0]);
+		CHECK(INT64_MAX == ikeys64[size - 1]);
+		CHECK(1 == values[0]);
+		CHECK(0 == values[size / 2]);
+
+		// small arrays take the insertion sort path
+		for (uint32_t i=0; i<50; ++i)
+		{
+			ikeys32[i]	= int32_t(random.gen() % 10) - 5;
+			values[i]	= i;
+		}
+		sortRadix(ikeys32, itemp32, values, tempValues, 50);
+		CHECK(isSorted(ikeys32, 50));
+		for (uint32_t i=1; i<50; ++i)
+			if (ikeys32[i] == ikeys32[i - 1])
+				CHECK(values[i] > values[i - 1]);
+
+		delete[] keys32;	delete[] temp32;
+		delete[] ikeys32;	delete[] itemp32;
+		delete[] fkeys;		delete[] ftemp;
+		delete[] ikeys64;	delete[] itemp64;
+		delete[] dkeys;		delete[] dtemp;
+		delete[] values;	delete[] tempValues;
+	}
+
+	TEST(radixsort_write_combine)
+	{
+		// large enough for the write combined scatter, run without an allocator
+		// installed so the line buffer comes from malloc with its default alignment
+		const uint32_t size = 256 * 1024 + 1000;
+
+		Random random;
+
+		uint32_t* keys		= new uint32_t[size];
+		uint32_t* temp		= new uint32_t[size];
+		uint64_t* keys64	= new uint64_t[size];
+		uint64_t* temp64	= new uint64_t[size];
+		uint32_t* values	= new uint32_t[size];
+		uint32_t* tempValues= new uint32_t[size];
+
+		for (uint32_t run=0; run<4; ++run)
+		{
+			// odd sized block shifts alignment of the next malloc
+			uint8_t* shift = new uint8_t[run * 24 + 8];
+
+			for (uint32_t i=0; i<size; ++i)
+			{
+				keys[i]		= random.gen();
+				keys64[i]	= (uint64_t(random.gen()) << 32) | random.gen();
+				values[i]	= keys[i];
+			}
+
+			sortRadix(keys, temp, values, tempValues, size);
+			CHECK(isSorted(keys, size));
+			CHECK(0 == memCompare(keys, values, size * sizeof(uint32_t)));
+
+			sortRadix64(keys64, temp64, size);
+			CHECK(isSorted(keys64, size));
+
+			delete[] shift;
+		}
+
+		delete[] keys;		delete[] temp;
+		delete[] keys64;	delete[] temp64;
+		delete[] values;	delete[] tempValues;
+	}
+
+	TEST(radixsort_parallel)
+	{
+		// large enough to be split over four threads
+		const uint32_t size = 300000;
+
+		Random random;
+
+		uint64_t* keys		= new uint64_t[size];
+		uint64_t* sorted	= new uint64_t[size];
+		uint64_t* temp		= new uint64_t[size];
+		uint32_t* values	= new uint32_t[size];
+		uint32_t* tempValues= new uint32_t[size];
+		float* fkeys		= new float[size];
+		float* ftemp		= new float[size];
+
+		for (uint32_t i=0; i<size; ++i)
+		{
+			keys[i]		= (uint64_t(random.gen()) << 32) | random.gen();
+			sorted[i]	= keys[i];
+			fkeys[i]	= float(int32_t(random.gen())) * 0.5f;
+		}
+
+		sortRadix64(sorted, temp, size);
+		sortRadix64Parallel(keys, temp, size, 4);
+		CHECK(0 == memCompare(keys, sorted, size * sizeof(uint64_t)));
+
+		sortRadixParallel(fkeys, ftemp, size, 4);
+		CHECK(isSorted(fkeys, size));
+
+		// same sort on job system threads, reused between calls
+		JobSystem jobs;
+		CHECK(jobs.init(4, false));
+
+		for (uint32_t i=0; i<size; ++i)
+			keys[i] = (uint64_t(random.gen()) << 32) | random.gen();
+		memCopy(sorted, size * sizeof(uint64_t), keys, size * sizeof(uint64_t));
+
+		sortRadix64(sorted, temp, size);
+		sortRadix64Parallel(keys, temp, size, &jobs);
+		CHECK(0 == memCompare(keys, sorted, size * sizeof(uint64_t)));
+
+		for (uint32_t i=0; i<size; ++i)
+			fkeys[i] = float(int32_t(random.gen())) * 0.5f;
+		sortRadixParallel(fkeys, ftemp, size, &jobs);
+		CHECK(isSorted(fkeys, size));
+
+		// small key range skips passes, stable order must be kept across threads
+		for (uint32_t i=0; i<size; ++i)
+		{
+			keys[i]		= random.gen() & 0x3ff;
+			values[i]	= i;
+		}
+
+		sortRadix64Parallel(keys, temp, values, tempValues, size, 4);
+		CHECK(isSorted(keys, size));
+
+		bool stable = true;
+		for (uint32_t i=1; i<size; ++i)
+			if ((keys[i] == keys[i - 1]) && (values[i] < values[i - 1]))
+				stable = false;
+		CHECK(stable);
+
+		for (uint32_t i=0; i<size; ++i)
+		{
+			keys[i]		= random.gen() & 0x3ff;
+			values[i]	= i;
+		}
+
+		sortRadix64Parallel(keys, temp, values, tempValues, size, &jobs);
+		CHECK(isSorted(keys, size));
+
+		stable = true;
+		for (uint32_t i=1; i<size; ++i)
+			if ((keys[i] == keys[i - 1]) && (values[i] < values[i - 1]))
+				stable = false;
+		CHECK(stable);
+
+		jobs.shutdown();
+
+		delete[] keys;
+		delete[] sorted;
+		delete[] temp;
+		delete[] values;
+		delete[] tempValues;
+		delete[] fkeys;
+		delete[] ftemp;
+	}
+
+	TEST(radixsort_indirect)
+	{
+		struct Payload
+		{
+			uint32_t	m_id;
+			uint8_t		m_data[60];
+		};
+
+		const uint32_t size = 1000;
+
+		Random random;
+
+		int64_t* keys			= new int64_t[size];
+		int64_t* tempKeys		= new int64_t[size];
+		Payload* values			= new Payload[size];
+		Payload* tempValues		= new Payload[size];
+		uint32_t* indices		= new uint32_t[size];
+		uint32_t* tempIndices	= new uint32_t[size];
+		int64_t* originalKeys	= new int64_t[size];
+
+		for (uint32_t i=0; i<size; ++i)
+		{
+			keys[i]			= int64_t(int32_t(random.gen())) % 100;
+			originalKeys[i]	= keys[i];
+			values[i].m_id	= i;
+		}
+
+		sortRadixIndirect(keys, tempKeys, values, tempValues, indices, tempIndices, size);
+		CHECK(isSorted(keys, size));
+		for (uint32_t i=0; i<size; ++i)
+		{
+			CHECK(values[i].m_id == indices[i]);
+			CHECK(originalKeys[indices[i]] == keys[i]);
+		}
+		for (uint32_t i=1; i<size; ++i)
+			if (keys[i] == keys[i - 1])
+				CHECK(indices[i] > indices[i - 1]);
+
+		delete[] keys;
+		delete[] tempKeys;
+		delete[] values;
+		delete[] tempValues;
+		delete[] indices;
+		delete[] tempIndices;
+		delete[] originalKeys;
+	}
+
+	TEST(radixsort_strings)
+	{
+		const uint32_t size = 2000;
+
+		Random random;
+
+		char* storage				= new char[size * 32];
+		const char** strings		= new const char*[size];
+		const char** tempStrings	= new const char*[size];
+		StringView* views			= new StringView[size];
+		StringView* tempViews		= new StringView[size];
+
+		// shared prefixes, duplicates and prefixes of other strings
+		const char* prefixes[] = { "data/textures/", "data/meshes/", "data/", "" };
+		for (uint32_t i=0; i<size; ++i)
+		{
+			char* str = storage + i * 32;
+			const char* prefix = prefixes[random.gen() % RTM_NUM_ELEMENTS(prefixes)];
+			const uint32_t prefixLen = strLen(prefix);
+			memCopy(str, 32, prefix, prefixLen);
+
+			const uint32_t len = random.gen() % 8;
+			for (uint32_t c=0; c<len; ++c)
+				str[prefixLen + c] = char('a' + random.gen() % 4);
+			str[prefixLen + len] = '\0';
+
+			strings[i]	= str;
+			views[i]	= StringView(str, prefixLen + len + 1);	// include terminator to sort embedded zero bytes
+		}
+
+		sortRadixStrings(strings, tempStrings, size);
+		sortRadixStrings(views, tempViews, size);
+
+		bool sorted = true;
+		for (uint32_t i=1; i<size; ++i)
+		{
+			sorted = sorted && (strCmp(strings[i - 1], strings[i]) <= 0);
+			sorted = sorted && (strCmp(views[i - 1].data(), views[i].data()) <= 0);
+		}
+		CHECK(sorted);
+
+		// equal strings keep original order
+		for (uint32_t i=1; i<size; ++i)
+			if (0 == strCmp(strings[i - 1], strings[i]))
+				CHECK(strings[i - 1] < strings[i]);
+
+		delete[] storage;
+		delete[] strings;
+		delete[] tempStrings;
+		delete[] views;
+		delete[] tempViews;
+	}
+}
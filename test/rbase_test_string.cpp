@@ -5,6 +5,7 @@
 
 #include <rbase_test_pch.h>
 #include <rbase/inc/stringview.h>
+#include <rbase/inc/virtualmem.h>
 
 using namespace rtm;
 
@@ -30,6 +31,28 @@ SUITE(rbase)
 		CHECK(0 == striCmp(buffer, testString));
 
 		CHECK(0 == striCmp(strStr(buffer, "test"), "test string"));
+		CHECK(0 == striCmp(striStr(testString, "TEST"), "test string"));
+		CHECK(0 == strStr(testString, "TEST"));
+		CHECK(0 == strStr(testString, "test", 14));
+		CHECK(&testString[12] == strStr(testString, "test", 16));
+		CHECK(&testString[3] == strChr(testString, 's'));
+		CHECK(&testString[0] == striChr(testString, 't'));
+		CHECK(0 == strChr(testString, 'x'));
+		CHECK(0 == strChr(testString, 'g', 22));
+		CHECK(5 == strLen(testString, 5));
+
+		// long input to go through the vectorized paths
+		char longString[300];
+		memSet(longString, 'a', sizeof(longString));
+		longString[sizeof(longString) - 1] = '\0';
+		longString[250] = 'B';
+		longString[251] = 'c';
+		CHECK(299 == strLen(longString));
+		CHECK(&longString[249] == strStr(longString, "aBc"));
+		CHECK(&longString[249] == striStr(longString, "ABC"));
+		CHECK(&longString[250] == strChr(longString, 'B'));
+		CHECK(&longString[250] == striChr(longString, 'b'));
+		CHECK(0 == strChr(longString, 'B', 250));
 
 
 		StringTemp<> fs(testString);
@@ -45,4 +68,95 @@ SUITE(rbase)
 
 		CHECK(true);
 	}
+
+	TEST(memory)
+	{
+		uint8_t src[512];
+		uint8_t dst[512];
+
+		for (uint32_t i=0; i<sizeof(src); ++i)
+			src[i] = (uint8_t)(i * 7 + 1);
+
+		// sizes around vector widths with unaligned head and tail
+		for (uint32_t size=0; size<160; ++size)
+		for (uint32_t offset=0; offset<8; ++offset)
+		{
+			memSet(dst, 0xcd, sizeof(dst));
+			memCopy(&dst[offset], sizeof(dst) - offset, &src[offset * 3], size);
+			CHECK(0 == memCompare(&dst[offset], &src[offset * 3], size));
+			CHECK(0xcd == dst[offset + size]);
+			if (offset)
+				CHECK(0xcd == dst[offset - 1]);
+
+			if (size)
+			{
+				dst[offset + size - 1] ^= 0x40;
+				CHECK(0 != memCompare(&dst[offset], &src[offset * 3], size));
+			}
+
+			memSet(&dst[offset], 0x11, size);
+			if (size)
+				CHECK(0x11 == dst[offset + size - 1]);
+			CHECK(0xcd == dst[offset + size]);
+		}
+
+		// overlapping moves in both directions
+		for (uint32_t i=0; i<sizeof(dst); ++i)
+			dst[i] = (uint8_t)i;
+
+		memMove(&dst[3], &dst[0], 200);
+		CHECK(0 == dst[3] && 199 == dst[202]);
+
+		memMove(&dst[0], &dst[3], 200);
+		CHECK(0 == dst[0] && 199 == dst[199]);
+
+		CHECK(0 > memCompare("abc", "abd", 3));
+		CHECK(0 < memCompare("abd", "abc", 3));
+	}
+
+	TEST(string_bounds)
+	{
+#if RTM_VIRTUAL_MEMORY
+		// haystacks end right before an inaccessible page and are not terminated
+		const size_t pageSize = virtualMemPageSize();
+		uint8_t* pages = (uint8_t*)virtualMemReserve(pageSize * 2);
+		CHECK(pages != 0);
+		if (!pages)
+			return;
+		CHECK(virtualMemCommit(pages, pageSize));
+
+		for (uint32_t len=2; len<100; ++len)
+		{
+			char* hay = (char*)pages + pageSize - len;
+			memSet(hay, 'a', len);
+
+			CHECK(0 == strStr(hay, "ab", len));
+			CHECK(0 == striStr(hay, "AB", len));
+			CHECK(0 == strStr(StringView(hay, len), "ab"));
+
+			hay[len - 1] = 'b';
+			CHECK(hay + len - 2 == strStr(hay, "ab", len));
+			CHECK(hay + len - 2 == striStr(hay, "AB", len));
+			CHECK(hay + len - 2 == strStr(StringView(hay, len), "ab"));
+			CHECK(hay + len - 1 == strChr(hay, 'b', len));
+		}
+
+		// first match is found at any position, including inside the last block
+		bool found = true;
+		for (uint32_t len=3; len<100; ++len)
+		{
+			char* hay = (char*)pages + pageSize - len;
+			for (uint32_t pos=0; pos+3<=len; ++pos)
+			{
+				memSet(hay, 'a', len);
+				memCopy(hay + pos, 3, "abc", 3);
+				found &= hay + pos == strStr(hay, "abc", len);
+				found &= hay + pos == striStr(hay, "ABC", len);
+			}
+		}
+		CHECK(found);
+
+		virtualMemRelease(pages, pageSize * 2);
+#endif
+	}
 }
@@ -0,0 +1,101 @@
+//--------------------------------------------------------------------------//
+/// Copyright 2025 Milos Tosic. All Rights Reserved.                       ///
+/// License: http://www.opensource.org/licenses/BSD-2-Clause               ///
+//--------------------------------------------------------------------------//
+
+#include <rbase_test_pch.h>
+#include <rbase/inc/stringpool.h>
+#include <rbase/inc/thread.h>
+
+using namespace rtm;
+
+namespace {
+
+	struct InternThreadData
+	{
+		StringPoolConcurrent*	m_pool;
+		StringID				m_ids[500];
+	};
+
+	static int32_t internThread(void* _userData)
+	{
+		InternThreadData* data = (InternThreadData*)_userData;
+		for (uint32_t i=0; i<500; ++i)
+		{
+			char name[32];
+			snprintf(name, sizeof(name), "asset/%u", i);
+			data->m_ids[i] = data->m_pool->intern(name);
+		}
+		return 0;
+	}
+
+} // namespace
+
+SUITE(rbase)
+{
+	TEST(stringpool)
+	{
+		StringPool pool;
+		CHECK(0 == pool.size());
+		CHECK(StringIDInvalid == pool.find("data/textures"));
+
+		const StringID id0 = pool.intern("data/textures");
+		const StringID id1 = pool.intern(StringView("data/meshes/rock.mesh", 11));
+		CHECK(id0 != StringIDInvalid);
+		CHECK(id0 != id1);
+		CHECK(2 == pool.size());
+
+		// same string through a different view maps to the same ID
+		const char* path = "data/textures/rock.png";
+		CHECK(id0 == pool.intern(StringView(path, 13)));
+		CHECK(id1 == pool.find("data/meshes"));
+		CHECK(id1 == pool.intern("data/meshes", stringPoolHash("data/meshes")));
+		CHECK(2 == pool.size());
+
+		// stored strings are zero terminated copies
+		CHECK(0 == strCmp(pool.get(id1).data(), "data/meshes"));
+		CHECK(11 == pool.get(id1).length());
+		CHECK(pool.getHash(id0) == stringPoolHash("data/textures"));
+
+		const StringID empty = pool.intern("");
+		CHECK(empty != StringIDInvalid);
+		CHECK(0 == pool.get(empty).length());
+
+		for (uint32_t i=0; i<2000; ++i)
+		{
+			char name[32];
+			snprintf(name, sizeof(name), "name_%u", i);
+			CHECK(i + 4 == pool.intern(name));
+		}
+		CHECK(id0 == pool.find("data/textures"));
+		CHECK(0 == strCmp(pool.get(1000 + 4).data(), "name_1000"));
+	}
+
+	TEST(stringpool_concurrent)
+	{
+		StringPoolConcurrent pool;
+
+		InternThreadData data[4];
+		Thread threads[4];
+		for (uint32_t i=0; i<4; ++i)
+		{
+			data[i].m_pool = &pool;
+			threads[i].start(internThread, &data[i]);
+		}
+		for (uint32_t i=0; i<4; ++i)
+			threads[i].stop();
+
+		CHECK(500 == pool.size());
+		for (uint32_t i=0; i<500; ++i)
+		{
+			CHECK(data[0].m_ids[i] == data[1].m_ids[i]);
+			CHECK(data[0].m_ids[i] == data[2].m_ids[i]);
+			CHECK(data[0].m_ids[i] == data[3].m_ids[i]);
+
+			char name[32];
+			snprintf(name, sizeof(name), "asset/%u", i);
+			CHECK(0 == strCmp(pool.get(data[0].m_ids[i]).data(), name));
+			CHECK(data[0].m_ids[i] == pool.find(name));
+		}
+	}
+}